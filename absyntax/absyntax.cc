@@ -60,10 +60,41 @@ symbol_c::symbol_c(
   this->parent       = NULL;
   this->datatype     = NULL;
   this->scope        = NULL;
+  this->kind         = no_kind;
 }
 
 
 
+/* The kinds of the classes declared with SYM_TOKEN in absyntax.def */
+#define SYM_LIST(class_name_c, ...)  false,
+#define SYM_TOKEN(class_name_c, ...) true,
+#define SYM_REF0(class_name_c, ...)  false,
+#define SYM_REF1(class_name_c, ...)  false,
+#define SYM_REF2(class_name_c, ...)  false,
+#define SYM_REF3(class_name_c, ...)  false,
+#define SYM_REF4(class_name_c, ...)  false,
+#define SYM_REF5(class_name_c, ...)  false,
+#define SYM_REF6(class_name_c, ...)  false,
+
+static const bool token_kinds[symbol_kind_count] = {
+  false, /* no_kind */
+#include "absyntax.def"
+};
+
+#undef SYM_LIST
+#undef SYM_TOKEN
+#undef SYM_REF0
+#undef SYM_REF1
+#undef SYM_REF2
+#undef SYM_REF3
+#undef SYM_REF4
+#undef SYM_REF5
+#undef SYM_REF6
+
+bool symbol_c::is_token(void) const {return token_kinds[kind];}
+
+
+
 token_c::token_c(const char *value, 
                  int fl, int fc, const char *ffile, long int forder,
                  int ll, int lc, const char *lfile, long int lorder)
@@ -75,6 +106,55 @@ token_c::token_c(const char *value,
 
 
 
+/*** Data type analysis ***/
+/* Get the bit used for each elementary data type in candidate_datatype_list_c */
+class elementary_bit_c: public null_visitor_c {
+  public:
+    /* returns bit + 1, or NULL (i.e. 0) for any other symbol */
+    #define ELEMENTARY_BIT_(type, bit)\
+      void *visit(type##_type_name_c *symbol) {return (void *)(intptr_t)(bit + 1);}\
+      void *visit(safe##type##_type_name_c *symbol) {return (void *)(intptr_t)(bit + 2);}
+    ELEMENTARY_BIT_( time,  0)  ELEMENTARY_BIT_( bool,  2)
+    ELEMENTARY_BIT_( sint,  4)  ELEMENTARY_BIT_(  int,  6)  ELEMENTARY_BIT_( dint,  8)  ELEMENTARY_BIT_( lint, 10)
+    ELEMENTARY_BIT_(usint, 12)  ELEMENTARY_BIT_( uint, 14)  ELEMENTARY_BIT_(udint, 16)  ELEMENTARY_BIT_(ulint, 18)
+    ELEMENTARY_BIT_( real, 20)  ELEMENTARY_BIT_(lreal, 22)
+    ELEMENTARY_BIT_( date, 24)  ELEMENTARY_BIT_(  tod, 26)  ELEMENTARY_BIT_(   dt, 28)
+    ELEMENTARY_BIT_( byte, 30)  ELEMENTARY_BIT_( word, 32)  ELEMENTARY_BIT_(dword, 34)  ELEMENTARY_BIT_(lword, 36)
+    ELEMENTARY_BIT_(string, 38) ELEMENTARY_BIT_(wstring, 40)
+    #undef ELEMENTARY_BIT_
+};
+
+static elementary_bit_c elementary_bit_visitor;
+
+
+int candidate_datatype_list_c::elementary_bit(symbol_c *datatype) {
+  if (NULL == datatype) return -1;
+  return (int)(intptr_t)datatype->accept(elementary_bit_visitor) - 1;
+}
+
+
+void candidate_datatype_list_c::push_back(symbol_c *datatype) {
+  int bit = elementary_bit(datatype);
+  if (bit >= 0) elementary_mask |= (1ULL << bit);
+  else          non_elementary_count++;
+  list.push_back(datatype);
+}
+
+
+candidate_datatype_list_c::iterator candidate_datatype_list_c::erase(iterator pos) {
+  int bit = elementary_bit(*pos);
+  iterator next = list.erase(pos);
+  if (bit < 0) {non_elementary_count--; return next;}
+  /* the same elementary data type may be in the list more than once (e.g. two distinct int_type_name_c objects) */
+  elementary_mask &= ~(1ULL << bit);
+  for (iterator iter = list.begin(); iter != list.end(); ++iter)
+    if (elementary_bit(*iter) == bit) {elementary_mask |= (1ULL << bit); break;}
+  return next;
+}
+
+
+
+
 # define LIST_CAP_INIT 8
 # define LIST_CAP_INCR 8
 
@@ -184,25 +264,25 @@ void list_c::clear(void) {
 class_name_c::class_name_c(									\
                            int fl, int fc, const char *ffile, long int forder,			\
                            int ll, int lc, const char *lfile, long int lorder)			\
-                        :list_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {}		\
+                        :list_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {kind = class_name_c##_kind;}		\
 class_name_c::class_name_c(symbol_c *elem, 							\
                            int fl, int fc, const char *ffile, long int forder,			\
                            int ll, int lc, const char *lfile, long int lorder)			\
-			:list_c(elem, fl, fc, ffile, forder, ll, lc, lfile, lorder) {}		\
+			:list_c(elem, fl, fc, ffile, forder, ll, lc, lfile, lorder) {kind = class_name_c##_kind;}		\
 void *class_name_c::accept(visitor_c &visitor) {return visitor.visit(this);}
 
 #define SYM_TOKEN(class_name_c, ...)								\
 class_name_c::class_name_c(const char *value, 							\
                            int fl, int fc, const char *ffile, long int forder,			\
                            int ll, int lc, const char *lfile, long int lorder)			\
-			:token_c(value, fl, fc, ffile, forder, ll, lc, lfile, lorder) {}	\
+			:token_c(value, fl, fc, ffile, forder, ll, lc, lfile, lorder) {kind = class_name_c##_kind;}	\
 void *class_name_c::accept(visitor_c &visitor) {return visitor.visit(this);}
 
 #define SYM_REF0(class_name_c, ...)								\
 class_name_c::class_name_c(									\
                            int fl, int fc, const char *ffile, long int forder,			\
                            int ll, int lc, const char *lfile, long int lorder)			\
-			  :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {}		\
+			  :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {kind = class_name_c##_kind;}		\
 void *class_name_c::accept(visitor_c &visitor) {return visitor.visit(this);}
 
 
@@ -211,6 +291,7 @@ class_name_c::class_name_c(symbol_c *ref1,							\
                            int fl, int fc, const char *ffile, long int forder,			\
                            int ll, int lc, const char *lfile, long int lorder)			\
 			  :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {		\
+  kind = class_name_c##_kind;									\
   this->ref1 = ref1;										\
   if  (NULL != ref1)   ref1->parent = this;							\
 }												\
@@ -223,6 +304,7 @@ class_name_c::class_name_c(symbol_c *ref1,							\
                            int fl, int fc, const char *ffile, long int forder,			\
                            int ll, int lc, const char *lfile, long int lorder)			\
 			  :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {		\
+  kind = class_name_c##_kind;									\
   this->ref1 = ref1;										\
   this->ref2 = ref2;										\
   if  (NULL != ref1)   ref1->parent = this;							\
@@ -238,6 +320,7 @@ class_name_c::class_name_c(symbol_c *ref1,							\
                            int fl, int fc, const char *ffile, long int forder,			\
                            int ll, int lc, const char *lfile, long int lorder)			\
 			  :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {		\
+  kind = class_name_c##_kind;									\
   this->ref1 = ref1;										\
   this->ref2 = ref2;										\
   this->ref3 = ref3;										\
@@ -256,6 +339,7 @@ class_name_c::class_name_c(symbol_c *ref1,							\
                            int fl, int fc, const char *ffile, long int forder,			\
                            int ll, int lc, const char *lfile, long int lorder)			\
 			  :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {		\
+  kind = class_name_c##_kind;									\
   this->ref1 = ref1;										\
   this->ref2 = ref2;										\
   this->ref3 = ref3;										\
@@ -277,6 +361,7 @@ class_name_c::class_name_c(symbol_c *ref1,							\
                            int fl, int fc, const char *ffile, long int forder,			\
                            int ll, int lc, const char *lfile, long int lorder)			\
 			  :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {		\
+  kind = class_name_c##_kind;									\
   this->ref1 = ref1;										\
   this->ref2 = ref2;										\
   this->ref3 = ref3;										\
@@ -302,6 +387,7 @@ class_name_c::class_name_c(symbol_c *ref1,							\
                            int fl, int fc, const char *ffile, long int forder,			\
                            int ll, int lc, const char *lfile, long int lorder)			\
 			  :symbol_c(fl, fc, ffile, forder, ll, lc, lfile, lorder) {		\
+  kind = class_name_c##_kind;									\
   this->ref1 = ref1;										\
   this->ref2 = ref2;										\
   this->ref3 = ref3;										\
@@ -156,6 +156,84 @@ class const_value_c {
 
 
 
+/* The kind of a symbol, i.e. which of the classes declared in absyntax.def the symbol is an instance of.
+ * Testing the kind of a symbol (see symbol_c::is<>() and symbol_c::as<>()) is much cheaper
+ * than using dynamic_cast<>() or typeid().
+ */
+#define SYM_LIST(class_name_c, ...)  class_name_c##_kind,
+#define SYM_TOKEN(class_name_c, ...) class_name_c##_kind,
+#define SYM_REF0(class_name_c, ...)  class_name_c##_kind,
+#define SYM_REF1(class_name_c, ...)  class_name_c##_kind,
+#define SYM_REF2(class_name_c, ...)  class_name_c##_kind,
+#define SYM_REF3(class_name_c, ...)  class_name_c##_kind,
+#define SYM_REF4(class_name_c, ...)  class_name_c##_kind,
+#define SYM_REF5(class_name_c, ...)  class_name_c##_kind,
+#define SYM_REF6(class_name_c, ...)  class_name_c##_kind,
+
+typedef enum {
+  no_kind = 0, /* symbol_c, token_c and list_c themselves, and any class not declared in absyntax.def */
+#include "absyntax.def"
+  symbol_kind_count
+} symbol_kind_t;
+
+#undef SYM_LIST
+#undef SYM_TOKEN
+#undef SYM_REF0
+#undef SYM_REF1
+#undef SYM_REF2
+#undef SYM_REF3
+#undef SYM_REF4
+#undef SYM_REF5
+#undef SYM_REF6
+
+
+
+/*** Data type analysis ***/
+/* The list of candidate data types of a symbol (see symbol_c::candidate_datatypes).
+ * It is used as a std::vector <symbol_c *> (the order in which the data types are added
+ * is kept, and is relevant), but it also keeps a bitmask of the elementary data types
+ * (BOOL, SINT, INT, ..., SAFEWSTRING) it contains, with one bit per elementary data type.
+ * This allows stage3 to check whether an elementary data type is in the list, and to
+ * add an elementary data type to the list without duplicates, without searching the list
+ * (see search_in_candidate_datatype_list() in stage3/datatype_functions.cc).
+ * Literals, which are the most common expressions, only have elementary candidate data types.
+ */
+class candidate_datatype_list_c {
+  public:
+    typedef std::vector <symbol_c *>::iterator       iterator;
+    typedef std::vector <symbol_c *>::const_iterator const_iterator;
+
+    /* returns the bit used for the elementary data type, or -1 if 'datatype' is not an elementary data type */
+    static int elementary_bit(symbol_c *datatype);
+
+    candidate_datatype_list_c(void): elementary_mask(0), non_elementary_count(0) {};
+
+    size_t         size    (void)     const {return list.size();}
+    bool           empty   (void)     const {return list.empty();}
+    symbol_c      *operator[](size_t i) const {return list[i];}
+    iterator       begin   (void)           {return list.begin();}
+    iterator       end     (void)           {return list.end();}
+    const_iterator begin   (void)     const {return list.begin();}
+    const_iterator end     (void)     const {return list.end();}
+
+    void           push_back(symbol_c *datatype);
+    iterator       erase   (iterator pos);
+    void           clear   (void)           {list.clear(); elementary_mask = 0; non_elementary_count = 0;}
+
+    /* the list contains the elementary data type with bit 'bit' (as returned by elementary_bit()) */
+    bool           has_elementary     (int bit) const {return (bit >= 0) && ((elementary_mask >> bit) & 1);}
+    /* all the data types in the list are elementary data types */
+    bool           has_only_elementary(void)    const {return (0 == non_elementary_count);}
+    uint64_t       get_elementary_mask(void)    const {return elementary_mask;}
+
+  private:
+    std::vector <symbol_c *> list;
+    uint64_t                 elementary_mask;
+    unsigned int             non_elementary_count;
+};
+
+
+
 /* The base class of all symbols */
 class symbol_c {
 
@@ -184,7 +262,7 @@ class symbol_c {
      * Annotations produced during stage 3
      */    
     /*** Data type analysis ***/
-    std::vector <symbol_c *> candidate_datatypes; /* All possible data types the expression/literal/etc. may take. Filled in stage3 by fill_candidate_datatypes_c class */
+    candidate_datatype_list_c candidate_datatypes; /* All possible data types the expression/literal/etc. may take. Filled in stage3 by fill_candidate_datatypes_c class */
     /* Data type of the expression/literal/etc. Filled in stage3 by narrow_candidate_datatypes_c 
      * If set to NULL, it means it has not yet been evaluated.
      * If it points to an object of type invalid_type_name_c, it means it is invalid.
@@ -219,6 +297,20 @@ class symbol_c {
     anotations_map_t anotations_map;
     
 
+    /* The kind of symbol. Set by the constructor of each class declared in absyntax.def */
+    symbol_kind_t kind;
+
+  public:
+    /* The symbol is an instance of class T, which must be one of the classes declared in absyntax.def.
+     *   symbol->is<T>()  is equivalent to  (NULL != dynamic_cast<T *>(symbol))
+     *   symbol->as<T>()  is equivalent to  dynamic_cast<T *>(symbol)
+     * (the classes declared in absyntax.def are never derived from, so only the exact class needs to be tested)
+     */
+    template <class T> bool is(void) const {return (kind == T::class_kind);}
+    template <class T> T   *as(void)       {return is<T>()? static_cast<T *>(this) : NULL;}
+    /* The symbol is a token_c (i.e. one of the classes declared with SYM_TOKEN in absyntax.def) */
+    bool is_token(void) const;
+
   public:
     /* default constructor */
     symbol_c(int fl = 0, int fc = 0, const char *ffile = NULL /* filename */, long int forder=0, /* order in which it is read by lexcial analyser */
@@ -303,6 +395,7 @@ class class_name_c:	public list_c {											\
                  int fl = 0, int fc = 0, const char *ffile = NULL /* filename */, long int forder=0,			\
                  int ll = 0, int lc = 0, const char *lfile = NULL /* filename */, long int lorder=0);			\
     virtual void *accept(visitor_c &visitor);										\
+    static const symbol_kind_t class_kind = class_name_c##_kind;							\
     /* WARNING: only use this method for debugging purposes!! */							\
     virtual const char *absyntax_cname(void) {return #class_name_c;};							\
 };
@@ -317,6 +410,7 @@ class class_name_c: 	public token_c {										\
                  int fl = 0, int fc = 0, const char *ffile = NULL /* filename */, long int forder=0,			\
                  int ll = 0, int lc = 0, const char *lfile = NULL /* filename */, long int lorder=0);			\
     virtual void *accept(visitor_c &visitor);										\
+    static const symbol_kind_t class_kind = class_name_c##_kind;							\
     /* WARNING: only use this method for debugging purposes!! */							\
     virtual const char *absyntax_cname(void) {return #class_name_c;};							\
 };
@@ -331,6 +425,7 @@ class class_name_c: public symbol_c {											\
                  int fl = 0, int fc = 0, const char *ffile = NULL /* filename */, long int forder=0,			\
                  int ll = 0, int lc = 0, const char *lfile = NULL /* filename */, long int lorder=0);			\
     virtual void *accept(visitor_c &visitor);										\
+    static const symbol_kind_t class_kind = class_name_c##_kind;							\
     /* WARNING: only use this method for debugging purposes!! */							\
     virtual const char *absyntax_cname(void) {return #class_name_c;};							\
 };
@@ -346,6 +441,7 @@ class class_name_c: public symbol_c {											\
                  int fl = 0, int fc = 0, const char *ffile = NULL /* filename */, long int forder=0,			\
                  int ll = 0, int lc = 0, const char *lfile = NULL /* filename */, long int lorder=0);			\
     virtual void *accept(visitor_c &visitor);										\
+    static const symbol_kind_t class_kind = class_name_c##_kind;							\
     /* WARNING: only use this method for debugging purposes!! */							\
     virtual const char *absyntax_cname(void) {return #class_name_c;};							\
 };
@@ -363,6 +459,7 @@ class class_name_c: public symbol_c {											\
                  int fl = 0, int fc = 0, const char *ffile = NULL /* filename */, long int forder=0,			\
                  int ll = 0, int lc = 0, const char *lfile = NULL /* filename */, long int lorder=0);			\
     virtual void *accept(visitor_c &visitor);										\
+    static const symbol_kind_t class_kind = class_name_c##_kind;							\
     /* WARNING: only use this method for debugging purposes!! */							\
     virtual const char *absyntax_cname(void) {return #class_name_c;};							\
 };
@@ -382,6 +479,7 @@ class class_name_c: public symbol_c {											\
                  int fl = 0, int fc = 0, const char *ffile = NULL /* filename */, long int forder=0,			\
                  int ll = 0, int lc = 0, const char *lfile = NULL /* filename */, long int lorder=0);			\
     virtual void *accept(visitor_c &visitor);										\
+    static const symbol_kind_t class_kind = class_name_c##_kind;							\
     /* WARNING: only use this method for debugging purposes!! */							\
     virtual const char *absyntax_cname(void) {return #class_name_c;};							\
 };
@@ -403,6 +501,7 @@ class class_name_c: public symbol_c {											\
                  int fl = 0, int fc = 0, const char *ffile = NULL /* filename */, long int forder=0,			\
                  int ll = 0, int lc = 0, const char *lfile = NULL /* filename */, long int lorder=0);			\
     virtual void *accept(visitor_c &visitor);										\
+    static const symbol_kind_t class_kind = class_name_c##_kind;							\
     /* WARNING: only use this method for debugging purposes!! */							\
     virtual const char *absyntax_cname(void) {return #class_name_c;};							\
 };
@@ -426,6 +525,7 @@ class class_name_c: public symbol_c {											\
                  int fl = 0, int fc = 0, const char *ffile = NULL /* filename */, long int forder=0,			\
                  int ll = 0, int lc = 0, const char *lfile = NULL /* filename */, long int lorder=0);			\
     virtual void *accept(visitor_c &visitor);										\
+    static const symbol_kind_t class_kind = class_name_c##_kind;							\
     /* WARNING: only use this method for debugging purposes!! */							\
     virtual const char *absyntax_cname(void) {return #class_name_c;};							\
 };
@@ -451,6 +551,7 @@ class class_name_c: public symbol_c {											\
                  int fl = 0, int fc = 0, const char *ffile = NULL /* filename */, long int forder=0,			\
                  int ll = 0, int lc = 0, const char *lfile = NULL /* filename */, long int lorder=0);			\
     virtual void *accept(visitor_c &visitor);										\
+    static const symbol_kind_t class_kind = class_name_c##_kind;							\
     /* WARNING: only use this method for debugging purposes!! */							\
     virtual const char *absyntax_cname(void) {return #class_name_c;};							\
 };
@@ -58,6 +58,8 @@
 #include "../util/dsymtable.hh"
 #include "../absyntax/visitor.hh"
 #include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+#include "../stats.hh"
+#include "search_base_type.hh"
 
 
 
@@ -80,13 +82,13 @@
 /* NOTE: it must ignore case!! */
 int compare_identifiers(symbol_c *ident1, symbol_c *ident2) {
 
-  token_c *name1 = dynamic_cast<token_c *>(ident1);
-  token_c *name2 = dynamic_cast<token_c *>(ident2);
-  
-  if ((name1 == NULL) || (name2 == NULL))
+  if ((ident1 == NULL) || (ident2 == NULL) || !ident1->is_token() || !ident2->is_token())
     /* invalid identifiers... */
     return -1;
 
+  token_c *name1 = (token_c *)ident1;
+  token_c *name2 = (token_c *)ident2;
+
   if (strcasecmp(name1->value, name2->value) == 0)
     return 0;
 
@@ -281,5 +283,12 @@ void absyntax_utils_init(symbol_c *tree_root) {
   populate_symtables_c populate_symbols;
 
   tree_root->accept(populate_symbols);
+  /* all datatypes are now in the symbol tables, so their resolution may be cached */
+  search_base_type_c::enable_cache();
+
+  stats_c::set_counter("symtables", "function_symtable",            function_symtable.size());
+  stats_c::set_counter("symtables", "function_block_type_symtable", function_block_type_symtable.size());
+  stats_c::set_counter("symtables", "program_type_symtable",        program_type_symtable.size());
+  stats_c::set_counter("symtables", "type_symtable",                type_symtable.size());
 }
 
@@ -101,6 +101,8 @@ extern  type_symtable_t type_symtable;
 #include "get_var_name.hh"
 #include "get_datatype_info.hh"
 #include "debug_ast.hh"
+#include "pou_fingerprint.hh"
+#include "ast_serialize.hh"
 
 /***********************************************************************/
 /***********************************************************************/
@@ -0,0 +1,743 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+/*
+ *  Store an abstract syntax tree in a (binary) file, and load it back.
+ *  Please read the comments in ast_serialize.hh for details (including the file format).
+ */
+
+
+#include "ast_serialize.hh"
+#include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <ctype.h>
+
+
+
+#define AST_MAGIC        "MATIECAS"
+#define AST_MAGIC_LEN    8
+#define AST_HEADER_WORDS 10          /* byte_order, version, layout_hash (2 words), options, symbol_kind_count, string_pool_size, node_count, node_data_size, root */
+#define AST_NODE_WORDS   3           /* kind, value, offset */
+#define AST_SHARED_FLAG  0x80000000U /* the node is one of the datatype objects of get_datatype_info_c */
+#define AST_BYTE_ORDER   0x01020304U /* first word of the header, reads as 0x04030201 if the file was written with the other byte order */
+
+
+static uint32_t swap_word(uint32_t value) {
+  return (value >> 24) | ((value >> 8) & 0x0000FF00U) | ((value << 8) & 0x00FF0000U) | (value << 24);
+}
+
+
+/* A hash (64 bit FNV-1a) of the layout of the classes declared in absyntax.def: the name of each
+ * class (in the order of their kinds), the macro used to declare it (i.e. the number of references),
+ * the names of the references, and the declaration of its annotations.
+ * Files written by a compiler built with a different absyntax.def are rejected, even if the number
+ * of classes is the same.
+ */
+static uint64_t layout_hash(void) {
+  static const char *layout[] = {
+    #define SYM_LIST(class_name_c, ...)                                      "SYM_LIST("  #class_name_c ")" #__VA_ARGS__,
+    #define SYM_TOKEN(class_name_c, ...)                                     "SYM_TOKEN(" #class_name_c ")" #__VA_ARGS__,
+    #define SYM_REF0(class_name_c, ...)                                      "SYM_REF0("  #class_name_c ")" #__VA_ARGS__,
+    #define SYM_REF1(class_name_c, ref1, ...)                                "SYM_REF1("  #class_name_c "," #ref1 ")" #__VA_ARGS__,
+    #define SYM_REF2(class_name_c, ref1, ref2, ...)                          "SYM_REF2("  #class_name_c "," #ref1 "," #ref2 ")" #__VA_ARGS__,
+    #define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                    "SYM_REF3("  #class_name_c "," #ref1 "," #ref2 "," #ref3 ")" #__VA_ARGS__,
+    #define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)              "SYM_REF4("  #class_name_c "," #ref1 "," #ref2 "," #ref3 "," #ref4 ")" #__VA_ARGS__,
+    #define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)        "SYM_REF5("  #class_name_c "," #ref1 "," #ref2 "," #ref3 "," #ref4 "," #ref5 ")" #__VA_ARGS__,
+    #define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)  "SYM_REF6("  #class_name_c "," #ref1 "," #ref2 "," #ref3 "," #ref4 "," #ref5 "," #ref6 ")" #__VA_ARGS__,
+
+    #include "../absyntax/absyntax.def"
+
+    #undef SYM_LIST
+    #undef SYM_TOKEN
+    #undef SYM_REF0
+    #undef SYM_REF1
+    #undef SYM_REF2
+    #undef SYM_REF3
+    #undef SYM_REF4
+    #undef SYM_REF5
+    #undef SYM_REF6
+  };
+  static uint64_t hash = 0;
+
+  if (0 == hash) {
+    hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < sizeof(layout) / sizeof(layout[0]); i++)
+      for (const char *c = layout[i]; ; c++) { /* including the '\0' */
+        hash = (hash ^ (unsigned char)*c) * 1099511628211ULL;
+        if ('\0' == *c) break;
+      }
+  }
+  return hash;
+}
+
+
+/* The runtime options that change the tree built by stage 1_2 and stage 3, one bit each (in this order).
+ * A tree may only be loaded with the same options it was stored with: stage 4 would otherwise be handed
+ * a tree that stage 1_2 and stage 3 would not have built (e.g. FBs with implicit EN/ENO parameters, and -e).
+ * full_token_loc (-f) only changes the error messages, and is therefore not included.
+ */
+static const struct {
+  const char               *name;
+  bool runtime_options_t::*option;
+} ast_options[] = {
+  {"-b", &runtime_options_t::allow_void_datatype},
+  {"-i", &runtime_options_t::allow_missing_var_in},
+  {"-e", &runtime_options_t::disable_implicit_en_eno},
+  {"-p", &runtime_options_t::pre_parsing},
+  {"-s", &runtime_options_t::safe_extensions},
+  {"-c", &runtime_options_t::conversion_functions},
+  {"-n", &runtime_options_t::nested_comments},
+  {"-r", &runtime_options_t::ref_standard_extensions},
+  {"-R", &runtime_options_t::ref_nonstand_extensions},
+  {"-a", &runtime_options_t::nonliteral_in_array_size},
+  {"-l", &runtime_options_t::relaxed_datatype_model},
+};
+
+static uint32_t options_word(void) {
+  uint32_t word = 0;
+  for (size_t i = 0; i < sizeof(ast_options) / sizeof(ast_options[0]); i++)
+    if (runtime_options.*(ast_options[i].option)) word |= 1U << i;
+  return word;
+}
+
+static std::string options_string(uint32_t word) {
+  std::string str;
+  for (size_t i = 0; i < sizeof(ast_options) / sizeof(ast_options[0]); i++)
+    if (word & (1U << i)) {if (!str.empty()) str += " "; str += ast_options[i].name;}
+  return str.empty()? "none" : str;
+}
+
+
+
+/* The annotations declared for specific classes in absyntax.def, and how ast_fields_c stores them.
+ * For each group of annotations, <group>_DECLARATION is its declaration in absyntax.def, and <group>_STORE
+ * the code that stores (or loads) it. candidate_functions is an intermediate result of stage 3, and is not stored.
+ * check_annotations() verifies that this list matches absyntax.def, so that an annotation added to (or changed in)
+ * absyntax.def may not silently be left out of the file.
+ */
+#define ENUMVALUE_SYMTABLE_DECLARATION          enumvalue_symtable_t enumvalue_symtable;
+#define ENUMVALUE_SYMTABLE_STORE                symtable(symbol->enumvalue_symtable);
+#define DIMENSION_DECLARATION                   unsigned long long int dimension;
+#define DIMENSION_STORE                         integer(symbol->dimension);
+#define IL_INSTRUCTION_DECLARATION              std::vector <symbol_c *> prev_il_instruction, next_il_instruction;
+#define IL_INSTRUCTION_STORE                    refs(symbol->prev_il_instruction); refs(symbol->next_il_instruction);
+#define CALLED_FUNCTION_DECLARATION_DECLARATION symbol_c *called_function_declaration; int extensible_param_count; std::vector <symbol_c *> candidate_functions;
+#define CALLED_FUNCTION_DECLARATION_STORE       io.ref(symbol->called_function_declaration); integer(symbol->extensible_param_count);
+#define CALLED_FB_DECLARATION_DECLARATION       symbol_c *called_fb_declaration;
+#define CALLED_FB_DECLARATION_STORE             io.ref(symbol->called_fb_declaration);
+#define DEPRECATED_OPERATION_DECLARATION        bool deprecated_operation;
+#define DEPRECATED_OPERATION_STORE              boolean(symbol->deprecated_operation);
+
+#define AST_ANNOTATIONS \
+  ANNOTATIONS_(library_c,                    ENUMVALUE_SYMTABLE)          \
+  ANNOTATIONS_(function_declaration_c,       ENUMVALUE_SYMTABLE)          \
+  ANNOTATIONS_(function_block_declaration_c, ENUMVALUE_SYMTABLE)          \
+  ANNOTATIONS_(program_declaration_c,        ENUMVALUE_SYMTABLE)          \
+  ANNOTATIONS_(configuration_declaration_c,  ENUMVALUE_SYMTABLE)          \
+  ANNOTATIONS_(resource_declaration_c,       ENUMVALUE_SYMTABLE)          \
+  ANNOTATIONS_(subrange_c,                   DIMENSION)                   \
+  ANNOTATIONS_(il_instruction_c,             IL_INSTRUCTION)              \
+  ANNOTATIONS_(il_simple_instruction_c,      IL_INSTRUCTION)              \
+  ANNOTATIONS_(il_function_call_c,           CALLED_FUNCTION_DECLARATION) \
+  ANNOTATIONS_(il_formal_funct_call_c,       CALLED_FUNCTION_DECLARATION) \
+  ANNOTATIONS_(function_invocation_c,        CALLED_FUNCTION_DECLARATION) \
+  ANNOTATIONS_(il_fb_call_c,                 CALLED_FB_DECLARATION)       \
+  ANNOTATIONS_(fb_invocation_c,              CALLED_FB_DECLARATION)       \
+  ANNOTATIONS_(S_operator_c,                 CALLED_FB_DECLARATION)       \
+  ANNOTATIONS_(R_operator_c,                 CALLED_FB_DECLARATION)       \
+  ANNOTATIONS_(S1_operator_c,                CALLED_FB_DECLARATION)       \
+  ANNOTATIONS_(R1_operator_c,                CALLED_FB_DECLARATION)       \
+  ANNOTATIONS_(CLK_operator_c,               CALLED_FB_DECLARATION)       \
+  ANNOTATIONS_(CU_operator_c,                CALLED_FB_DECLARATION)       \
+  ANNOTATIONS_(CD_operator_c,                CALLED_FB_DECLARATION)       \
+  ANNOTATIONS_(PV_operator_c,                CALLED_FB_DECLARATION)       \
+  ANNOTATIONS_(IN_operator_c,                CALLED_FB_DECLARATION)       \
+  ANNOTATIONS_(PT_operator_c,                CALLED_FB_DECLARATION)       \
+  ANNOTATIONS_(ADD_operator_c,               DEPRECATED_OPERATION)        \
+  ANNOTATIONS_(SUB_operator_c,               DEPRECATED_OPERATION)        \
+  ANNOTATIONS_(MUL_operator_c,               DEPRECATED_OPERATION)        \
+  ANNOTATIONS_(DIV_operator_c,               DEPRECATED_OPERATION)        \
+  ANNOTATIONS_(add_expression_c,             DEPRECATED_OPERATION)        \
+  ANNOTATIONS_(sub_expression_c,             DEPRECATED_OPERATION)        \
+  ANNOTATIONS_(mul_expression_c,             DEPRECATED_OPERATION)        \
+  ANNOTATIONS_(div_expression_c,             DEPRECATED_OPERATION)
+
+#define AST_STRINGIFY_(...) #__VA_ARGS__
+#define AST_STRINGIFY(...)  AST_STRINGIFY_(__VA_ARGS__)
+
+
+/* Compare two declarations, ignoring the white space */
+static bool same_declaration(const char *a, const char *b) {
+  while (true) {
+    while (isspace((unsigned char)*a)) a++;
+    while (isspace((unsigned char)*b)) b++;
+    if (*a != *b) return false;
+    if ('\0' == *a) return true;
+    a++; b++;
+  }
+}
+
+static void check_annotations(void) {
+  static bool checked = false;
+  if (checked) return;
+
+  const char *name    [symbol_kind_count];
+  const char *declared[symbol_kind_count]; /* in absyntax.def */
+  const char *stored  [symbol_kind_count]; /* in AST_ANNOTATIONS */
+  for (int i = 0; i < symbol_kind_count; i++) {name[i] = "no_kind"; declared[i] = stored[i] = "";}
+
+  #define SYM_LIST(class_name_c, ...)                                      {name[class_name_c##_kind] = #class_name_c; declared[class_name_c##_kind] = #__VA_ARGS__;}
+  #define SYM_TOKEN(class_name_c, ...)                                     {name[class_name_c##_kind] = #class_name_c; declared[class_name_c##_kind] = #__VA_ARGS__;}
+  #define SYM_REF0(class_name_c, ...)                                      {name[class_name_c##_kind] = #class_name_c; declared[class_name_c##_kind] = #__VA_ARGS__;}
+  #define SYM_REF1(class_name_c, ref1, ...)                                {name[class_name_c##_kind] = #class_name_c; declared[class_name_c##_kind] = #__VA_ARGS__;}
+  #define SYM_REF2(class_name_c, ref1, ref2, ...)                          {name[class_name_c##_kind] = #class_name_c; declared[class_name_c##_kind] = #__VA_ARGS__;}
+  #define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                    {name[class_name_c##_kind] = #class_name_c; declared[class_name_c##_kind] = #__VA_ARGS__;}
+  #define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)              {name[class_name_c##_kind] = #class_name_c; declared[class_name_c##_kind] = #__VA_ARGS__;}
+  #define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)        {name[class_name_c##_kind] = #class_name_c; declared[class_name_c##_kind] = #__VA_ARGS__;}
+  #define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)  {name[class_name_c##_kind] = #class_name_c; declared[class_name_c##_kind] = #__VA_ARGS__;}
+
+  #include "../absyntax/absyntax.def"
+
+  #undef SYM_LIST
+  #undef SYM_TOKEN
+  #undef SYM_REF0
+  #undef SYM_REF1
+  #undef SYM_REF2
+  #undef SYM_REF3
+  #undef SYM_REF4
+  #undef SYM_REF5
+  #undef SYM_REF6
+
+  #define ANNOTATIONS_(class_name_c, annotation) stored[class_name_c##_kind] = AST_STRINGIFY(annotation##_DECLARATION);
+  AST_ANNOTATIONS
+  #undef ANNOTATIONS_
+
+  for (int i = 0; i < symbol_kind_count; i++)
+    if (!same_declaration(declared[i], stored[i]))
+      ERROR_MSG("the annotations of %s declared in absyntax.def (%s) differ from those stored by ast_serialize.cc (%s).", name[i], declared[i], stored[i]);
+  checked = true;
+}
+
+
+
+/* The datatype objects of get_datatype_info_c, indexed by their kind */
+static symbol_c *shared_symbol(uint32_t kind) {
+  static symbol_c *shared[symbol_kind_count];
+  static bool      initialised = false;
+
+  if (!initialised) {
+    #define SHARED_(name) shared[get_datatype_info_c::name.kind] = &get_datatype_info_c::name;
+    SHARED_(invalid_type_name)
+    SHARED_(lreal_type_name)     SHARED_(real_type_name)
+    SHARED_(lint_type_name)      SHARED_(dint_type_name)      SHARED_(int_type_name)      SHARED_(sint_type_name)
+    SHARED_(ulint_type_name)     SHARED_(udint_type_name)     SHARED_(uint_type_name)     SHARED_(usint_type_name)
+    SHARED_(lword_type_name)     SHARED_(dword_type_name)     SHARED_(word_type_name)     SHARED_(byte_type_name)
+    SHARED_(bool_type_name)
+    SHARED_(wstring_type_name)   SHARED_(string_type_name)
+    SHARED_(dt_type_name)        SHARED_(date_type_name)      SHARED_(tod_type_name)      SHARED_(time_type_name)
+    SHARED_(safelreal_type_name) SHARED_(safereal_type_name)
+    SHARED_(safelint_type_name)  SHARED_(safedint_type_name)  SHARED_(safeint_type_name)  SHARED_(safesint_type_name)
+    SHARED_(safeulint_type_name) SHARED_(safeudint_type_name) SHARED_(safeuint_type_name) SHARED_(safeusint_type_name)
+    SHARED_(safelword_type_name) SHARED_(safedword_type_name) SHARED_(safeword_type_name) SHARED_(safebyte_type_name)
+    SHARED_(safebool_type_name)
+    SHARED_(safewstring_type_name) SHARED_(safestring_type_name)
+    SHARED_(safedt_type_name)    SHARED_(safedate_type_name)  SHARED_(safetod_type_name)  SHARED_(safetime_type_name)
+    #undef SHARED_
+    initialised = true;
+  }
+  return (kind < symbol_kind_count)? shared[kind] : NULL;
+}
+
+static bool is_shared(symbol_c *symbol) {return (shared_symbol(symbol->kind) == symbol);}
+
+
+
+/* Access to the fields of a symbol, as they are stored in the file.
+ * The same visitor (ast_fields_c) is used to collect the symbols and strings that will be stored,
+ * to write them to the file, and to read them back, each with its own implementation of this class.
+ */
+class ast_field_io_c {
+  public:
+    virtual ~ast_field_io_c(void) {}
+
+    virtual bool reading (void) = 0;
+    virtual void word    (uint32_t    &value) = 0;
+    virtual void count   (uint32_t    &value) = 0; /* number of elements that follow (of a list, vector, ...) */
+    virtual void string  (const char *&value) = 0;
+    virtual void ref     (symbol_c   *&value) = 0; /* the referenced symbol is also stored */
+    virtual void weak_ref(symbol_c   *&value) = 0; /* only stored if the referenced symbol is stored anyway (used for the parent) */
+};
+
+
+
+class ast_fields_c: public null_visitor_c {
+  private:
+    ast_field_io_c &io;
+
+  public:
+    ast_fields_c(ast_field_io_c &io_): io(io_) {}
+    virtual ~ast_fields_c(void) {}
+
+  private:
+    void dword(uint64_t &value) {
+      uint32_t lo = (uint32_t)value, hi = (uint32_t)(value >> 32);
+      io.word(lo);
+      io.word(hi);
+      value = ((uint64_t)hi << 32) | lo;
+    }
+
+    void integer(int                    &value) {uint32_t w = (uint32_t)value;          io.word(w); value = (int32_t)w;}
+    void integer(long int               &value) {uint64_t d = (uint64_t)(int64_t)value; dword(d);   value = (long int)(int64_t)d;}
+    void integer(unsigned long long int &value) {uint64_t d = value;                    dword(d);   value = d;}
+    void boolean(bool                   &value) {uint32_t w = value? 1 : 0;             io.word(w); value = (w != 0);}
+
+    void refs(std::vector<symbol_c *> &value) {
+      uint32_t n = value.size();
+      io.count(n);
+      value.resize(n);
+      for (uint32_t i = 0; i < n; i++) io.ref(value[i]);
+    }
+
+    void symtable(symbol_c::enumvalue_symtable_t &value) {
+      uint32_t n = value.size();
+      io.count(n);
+      if (!io.reading()) {
+        for (symbol_c::enumvalue_symtable_t::iterator iter = value.begin(); iter != value.end(); iter++) {
+          const char *name = iter->first.c_str();
+          io.string(name);
+          io.ref(iter->second);
+        }
+        return;
+      }
+      for (uint32_t i = 0; i < n; i++) {
+        const char *name   = NULL;
+        symbol_c   *symbol = NULL;
+        io.string(name);
+        io.ref(symbol);
+        if (NULL != name) value.insert(std::pair<std::string, symbol_c *>(name, symbol));
+      }
+    }
+
+    template <typename value_type> static uint32_t status(const_value_c::const_value__<value_type> &value) {
+      if (value.is_valid())    return const_value_c::cs_const_value;
+      if (value.is_overflow()) return const_value_c::cs_overflow;
+      if (value.is_nonconst()) return const_value_c::cs_non_const;
+      return const_value_c::cs_undefined;
+    }
+
+    /* Set the status of a value that is not valid. Returns true if the value itself follows. */
+    template <typename value_type> static bool valid(uint32_t status, const_value_c::const_value__<value_type> &value) {
+      switch (status) {
+        case const_value_c::cs_const_value: return true;
+        case const_value_c::cs_overflow:    value.set_overflow(); return false;
+        case const_value_c::cs_non_const:   value.set_nonconst(); return false;
+        default:                            return false;
+      }
+    }
+
+    /* Each type of value is stored explicitly (and not as the bytes of its C++ representation):
+     * int64, uint64 and real64 (the bit pattern of the IEEE 754 double) in two words, bool in one word.
+     */
+    void const_value(const_value_c::const_value__<int64_t> &value, uint32_t status) {
+      if (!valid(status, value)) return;
+      uint64_t d = (uint64_t)value.get();
+      dword(d);
+      value.set((int64_t)d);
+    }
+
+    void const_value(const_value_c::const_value__<uint64_t> &value, uint32_t status) {
+      if (!valid(status, value)) return;
+      uint64_t d = value.get();
+      dword(d);
+      value.set(d);
+    }
+
+    void const_value(const_value_c::const_value__<real64_t> &value, uint32_t status) {
+      if (!valid(status, value)) return;
+      union {double real; uint64_t bits;} v; /* real64_t may also be float or long double (see main.hh) */
+      v.real = (double)value.get();
+      dword(v.bits);
+      value.set((real64_t)v.real);
+    }
+
+    void const_value(const_value_c::const_value__<bool> &value, uint32_t status) {
+      if (!valid(status, value)) return;
+      bool b = value.get();
+      boolean(b);
+      value.set(b);
+    }
+
+    /* one word with the status of the 4 values, followed by the valid values */
+    void const_value(const_value_c &value) {
+      uint32_t s =   (status(value._int64)      ) | (status(value._uint64) << 2)
+                   | (status(value._real64) << 4) | (status(value._bool)   << 6);
+      io.word(s);
+      const_value(value._int64,  (s     ) & 3);
+      const_value(value._uint64, (s >> 2) & 3);
+      const_value(value._real64, (s >> 4) & 3);
+      const_value(value._bool,   (s >> 6) & 3);
+    }
+
+    /* the fields common to all symbols */
+    void fields(symbol_c *symbol) {
+      io.weak_ref(symbol->parent);
+      io.string(symbol->first_file); integer(symbol->first_line); integer(symbol->first_column); integer(symbol->first_order);
+      io.string(symbol->last_file);  integer(symbol->last_line);  integer(symbol->last_column);  integer(symbol->last_order);
+      io.ref(symbol->datatype);
+      io.ref(symbol->scope);
+      const_value(symbol->const_value);
+    }
+
+    void elements(list_c *symbol) {
+      uint32_t n = symbol->n;
+      io.count(n);
+      if (io.reading()) {
+        /* NOTE: add_element() is not used, as it would change the location of the list */
+        if ((int)n > symbol->c) {
+          symbol->elements = (symbol_c **)realloc(symbol->elements, n * sizeof(symbol_c *));
+          if (NULL == symbol->elements) ERROR_MSG("out of memory");
+          symbol->c = n;
+        }
+        symbol->n = n;
+      }
+      for (int i = 0; i < symbol->n; i++) io.ref(symbol->elements[i]);
+    }
+
+    /* The annotations declared for specific classes in absyntax.def (see AST_ANNOTATIONS) */
+    template <class symbol_type> void annotations(symbol_type *symbol) {}
+
+    #define ANNOTATIONS_(class_name_c, annotation) void annotations(class_name_c *symbol) {annotation##_STORE}
+    AST_ANNOTATIONS
+    #undef ANNOTATIONS_
+
+  public:
+    /* NOTE: the value of a token is stored in the node table, and not with the other fields */
+    #define SYM_LIST(class_name_c, ...)                                      void *visit(class_name_c *symbol) {fields(symbol); elements(symbol); annotations(symbol); return NULL;}
+    #define SYM_TOKEN(class_name_c, ...)                                     void *visit(class_name_c *symbol) {fields(symbol); annotations(symbol); return NULL;}
+    #define SYM_REF0(class_name_c, ...)                                      void *visit(class_name_c *symbol) {fields(symbol); annotations(symbol); return NULL;}
+    #define SYM_REF1(class_name_c, ref1, ...)                                void *visit(class_name_c *symbol) {fields(symbol); io.ref(symbol->ref1); annotations(symbol); return NULL;}
+    #define SYM_REF2(class_name_c, ref1, ref2, ...)                          void *visit(class_name_c *symbol) {fields(symbol); io.ref(symbol->ref1); io.ref(symbol->ref2); annotations(symbol); return NULL;}
+    #define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                    void *visit(class_name_c *symbol) {fields(symbol); io.ref(symbol->ref1); io.ref(symbol->ref2); io.ref(symbol->ref3); annotations(symbol); return NULL;}
+    #define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)              void *visit(class_name_c *symbol) {fields(symbol); io.ref(symbol->ref1); io.ref(symbol->ref2); io.ref(symbol->ref3); io.ref(symbol->ref4); annotations(symbol); return NULL;}
+    #define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)        void *visit(class_name_c *symbol) {fields(symbol); io.ref(symbol->ref1); io.ref(symbol->ref2); io.ref(symbol->ref3); io.ref(symbol->ref4); io.ref(symbol->ref5); annotations(symbol); return NULL;}
+    #define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)  void *visit(class_name_c *symbol) {fields(symbol); io.ref(symbol->ref1); io.ref(symbol->ref2); io.ref(symbol->ref3); io.ref(symbol->ref4); io.ref(symbol->ref5); io.ref(symbol->ref6); annotations(symbol); return NULL;}
+
+    #include "../absyntax/absyntax.def"
+
+    #undef SYM_LIST
+    #undef SYM_TOKEN
+    #undef SYM_REF0
+    #undef SYM_REF1
+    #undef SYM_REF2
+    #undef SYM_REF3
+    #undef SYM_REF4
+    #undef SYM_REF5
+    #undef SYM_REF6
+};
+
+
+
+/* Create an (empty) symbol of the given kind, whose fields will later be read from the file. */
+static symbol_c *new_symbol(uint32_t kind, const char *value) {
+  switch (kind) {
+    #define SYM_LIST(class_name_c, ...)  case class_name_c##_kind: return new class_name_c();
+    #define SYM_TOKEN(class_name_c, ...) case class_name_c##_kind: return new class_name_c(value);
+    #define SYM_REF0(class_name_c, ...)  case class_name_c##_kind: return new class_name_c();
+    #define SYM_REF1(class_name_c, ...)  case class_name_c##_kind: return new class_name_c(NULL);
+    #define SYM_REF2(class_name_c, ...)  case class_name_c##_kind: return new class_name_c(NULL, NULL);
+    #define SYM_REF3(class_name_c, ...)  case class_name_c##_kind: return new class_name_c(NULL, NULL, NULL);
+    #define SYM_REF4(class_name_c, ...)  case class_name_c##_kind: return new class_name_c(NULL, NULL, NULL, NULL);
+    #define SYM_REF5(class_name_c, ...)  case class_name_c##_kind: return new class_name_c(NULL, NULL, NULL, NULL, NULL);
+    #define SYM_REF6(class_name_c, ...)  case class_name_c##_kind: return new class_name_c(NULL, NULL, NULL, NULL, NULL, NULL);
+
+    #include "../absyntax/absyntax.def"
+
+    #undef SYM_LIST
+    #undef SYM_TOKEN
+    #undef SYM_REF0
+    #undef SYM_REF1
+    #undef SYM_REF2
+    #undef SYM_REF3
+    #undef SYM_REF4
+    #undef SYM_REF5
+    #undef SYM_REF6
+    default: return NULL;
+  }
+}
+
+
+
+/* 1st pass of save(): number the symbols (in breadth first order, starting with the root), and build the string pool */
+class ast_collect_c: public ast_field_io_c {
+  public:
+    std::map<symbol_c *, uint32_t>  node_refs;   /* the node reference (index + 1) of each symbol */
+    std::vector<symbol_c *>         nodes;
+    std::map<std::string, uint32_t> string_refs; /* the string reference (offset + 1) of each string */
+    std::string                     pool;
+
+    uint32_t add(symbol_c *symbol) {
+      if (NULL == symbol) return 0;
+      std::map<symbol_c *, uint32_t>::iterator iter = node_refs.find(symbol);
+      if (iter != node_refs.end()) return iter->second;
+      nodes.push_back(symbol);
+      return node_refs[symbol] = nodes.size();
+    }
+
+    uint32_t add_string(const char *value) {
+      if (NULL == value) return 0;
+      std::map<std::string, uint32_t>::iterator iter = string_refs.find(value);
+      if (iter != string_refs.end()) return iter->second;
+      uint32_t string_ref = pool.size() + 1;
+      pool.append(value);
+      pool.push_back('\0');
+      return string_refs[value] = string_ref;
+    }
+
+    bool reading (void)                 {return false;}
+    void word    (uint32_t    &value)   {}
+    void count   (uint32_t    &value)   {}
+    void string  (const char *&value)   {add_string(value);}
+    void ref     (symbol_c   *&value)   {add(value);}
+    void weak_ref(symbol_c   *&value)   {}
+};
+
+
+/* 2nd pass of save(): the fields of each symbol */
+class ast_write_c: public ast_field_io_c {
+  private:
+    ast_collect_c &collect;
+
+  public:
+    std::vector<uint32_t> data;
+
+    ast_write_c(ast_collect_c &collect_): collect(collect_) {}
+
+    bool reading (void)                 {return false;}
+    void word    (uint32_t    &value)   {data.push_back(value);}
+    void count   (uint32_t    &value)   {data.push_back(value);}
+    void string  (const char *&value)   {data.push_back(collect.add_string(value));} /* already in the pool */
+    void ref     (symbol_c   *&value)   {data.push_back(collect.add(value));}        /* already numbered   */
+    void weak_ref(symbol_c   *&value) {
+      std::map<symbol_c *, uint32_t>::iterator iter = collect.node_refs.find(value);
+      data.push_back((iter == collect.node_refs.end())? 0 : iter->second);
+    }
+};
+
+
+/* load(): the fields of each symbol, checking that the file is consistent */
+class ast_read_c: public ast_field_io_c {
+  private:
+    std::vector<symbol_c *> &nodes;
+    const char              *pool;
+    uint32_t                 pool_size;
+    const uint32_t          *next, *end;
+
+  public:
+    bool failed;
+
+    ast_read_c(std::vector<symbol_c *> &nodes_, const char *pool_, uint32_t pool_size_)
+      : nodes(nodes_), pool(pool_), pool_size(pool_size_), next(NULL), end(NULL), failed(false) {}
+
+    void seek(const uint32_t *begin, const uint32_t *end_) {next = begin; end = end_;}
+
+    bool reading(void) {return true;}
+
+    void word(uint32_t &value) {
+      if (next >= end) {failed = true; value = 0; return;}
+      value = *next++;
+    }
+
+    /* each element takes at least one word */
+    void count(uint32_t &value) {
+      word(value);
+      if (value > (uint32_t)(end - next)) {failed = true; value = 0;}
+    }
+
+    void string(const char *&value) {
+      uint32_t string_ref;
+      word(string_ref);
+      if (string_ref > pool_size) {failed = true; string_ref = 0;}
+      value = (0 == string_ref)? NULL : pool + string_ref - 1;
+    }
+
+    void ref(symbol_c *&value) {
+      uint32_t node_ref;
+      word(node_ref);
+      if (node_ref > nodes.size()) {failed = true; node_ref = 0;}
+      value = (0 == node_ref)? NULL : nodes[node_ref - 1];
+    }
+
+    void weak_ref(symbol_c *&value) {ref(value);}
+};
+
+
+
+int ast_serialize_c::save(symbol_c *tree_root, const char *filename) {
+  if (NULL == tree_root) ERROR;
+  check_annotations();
+
+  ast_collect_c collect;
+  ast_fields_c  collect_fields(collect);
+  collect.add(tree_root);
+  /* NOTE: collect.nodes grows while it is being iterated */
+  for (size_t i = 0; i < collect.nodes.size(); i++) {
+    symbol_c *symbol = collect.nodes[i];
+    if (no_kind == symbol->kind) {
+      fprintf(stderr, "Could not store the abstract syntax tree in file %s: symbol of class %s may not be stored.\n", filename, symbol->absyntax_cname());
+      return -1;
+    }
+    if (symbol->is_token()) collect.add_string(static_cast<token_c *>(symbol)->value);
+    if (!is_shared(symbol)) symbol->accept(collect_fields);
+  }
+  while (collect.pool.size() % sizeof(uint32_t) != 0) collect.pool.push_back('\0');
+
+  ast_write_c           write(collect);
+  ast_fields_c          write_fields(write);
+  std::vector<uint32_t> table;
+  for (size_t i = 0; i < collect.nodes.size(); i++) {
+    symbol_c *symbol = collect.nodes[i];
+    bool      shared = is_shared(symbol);
+    table.push_back(symbol->kind | (shared? AST_SHARED_FLAG : 0));
+    table.push_back(symbol->is_token()? collect.add_string(static_cast<token_c *>(symbol)->value) : 0);
+    table.push_back(write.data.size());
+    if (!shared) symbol->accept(write_fields);
+  }
+
+  uint64_t layout = layout_hash();
+  uint32_t header[AST_HEADER_WORDS] = {AST_BYTE_ORDER, version, (uint32_t)layout, (uint32_t)(layout >> 32),
+                                       options_word(), symbol_kind_count, (uint32_t)collect.pool.size(),
+                                       (uint32_t)collect.nodes.size(), (uint32_t)write.data.size(), 1 /* root */};
+
+  FILE *file = fopen(filename, "wb");
+  if (NULL == file) {
+    fprintf(stderr, "Could not create file %s: %s\n", filename, strerror(errno));
+    return -1;
+  }
+  bool ok =    (fwrite(AST_MAGIC,            1,                AST_MAGIC_LEN,         file) == AST_MAGIC_LEN)
+            && (fwrite(header,               sizeof(uint32_t), AST_HEADER_WORDS,      file) == AST_HEADER_WORDS)
+            && (fwrite(collect.pool.data(),  1,                collect.pool.size(),   file) == collect.pool.size())
+            && (fwrite(table.data(),         sizeof(uint32_t), table.size(),          file) == table.size())
+            && (fwrite(write.data.data(),    sizeof(uint32_t), write.data.size(),     file) == write.data.size());
+  if ((0 != fclose(file)) || !ok) {
+    fprintf(stderr, "Could not write to file %s: %s\n", filename, strerror(errno));
+    return -1;
+  }
+  return 0;
+}
+
+
+
+static symbol_c *load_error(const char *filename, const char *reason) {
+  fprintf(stderr, "Could not load the abstract syntax tree from file %s: %s\n", filename, reason);
+  return NULL;
+}
+
+
+symbol_c *ast_serialize_c::load(const char *filename) {
+  check_annotations();
+
+  FILE *file = fopen(filename, "rb");
+  if (NULL == file) return load_error(filename, strerror(errno));
+
+  /* NOTE: the buffer is never freed, as the token values and file names of the loaded tree point into it */
+  long  size   = -1;
+  char *buffer = NULL;
+  if ((0 == fseek(file, 0, SEEK_END)) && ((size = ftell(file)) >= 0) && (0 == fseek(file, 0, SEEK_SET))) {
+    buffer = (char *)malloc(size + 1);
+    if (NULL == buffer) ERROR_MSG("out of memory");
+    if (fread(buffer, 1, size, file) != (size_t)size) size = -1;
+  }
+  fclose(file);
+  if (size < 0) return load_error(filename, strerror(errno));
+
+  if (((size_t)size < AST_MAGIC_LEN + AST_HEADER_WORDS * sizeof(uint32_t)) || (0 != memcmp(buffer, AST_MAGIC, AST_MAGIC_LEN)))
+    return load_error(filename, "not an abstract syntax tree file");
+
+  uint32_t header[AST_HEADER_WORDS];
+  memcpy(header, buffer + AST_MAGIC_LEN, sizeof(header));
+  /* A file written on a host with the other byte order: swap every word (but not the string pool) */
+  bool swapped = (swap_word(AST_BYTE_ORDER) == header[0]);
+  if (swapped)
+    for (int i = 0; i < AST_HEADER_WORDS; i++) header[i] = swap_word(header[i]);
+  if (AST_BYTE_ORDER != header[0])
+    return load_error(filename, "file is corrupted");
+  uint32_t file_version = header[1];
+  uint64_t file_layout  = ((uint64_t)header[3] << 32) | header[2];
+  uint32_t file_options = header[4];
+  uint32_t kind_count   = header[5], pool_size  = header[6];
+  uint32_t node_count   = header[7], data_size  = header[8], root = header[9];
+  if (version != file_version)
+    return load_error(filename, "file was written by an incompatible version of the compiler (different file format)");
+  if ((symbol_kind_count != kind_count) || (layout_hash() != file_layout))
+    return load_error(filename, "file was written by an incompatible version of the compiler (different absyntax.def)");
+  if (options_word() != file_options) {
+    std::string reason =   "the tree was stored with other options (" + options_string(file_options)
+                         + ") than the ones given now (" + options_string(options_word()) + ")";
+    return load_error(filename, reason.c_str());
+  }
+  if (   (pool_size % sizeof(uint32_t) != 0)
+      || ((uint64_t)size != AST_MAGIC_LEN + sizeof(header) + (uint64_t)pool_size + ((uint64_t)node_count * AST_NODE_WORDS + data_size) * sizeof(uint32_t))
+      || ((pool_size > 0) && ('\0' != buffer[AST_MAGIC_LEN + sizeof(header) + pool_size - 1]))
+      || (0 == root) || (root > node_count))
+    return load_error(filename, "file is corrupted");
+
+  const char     *pool  = buffer + AST_MAGIC_LEN + sizeof(header);
+  const uint32_t *table = (const uint32_t *)(pool + pool_size);
+  const uint32_t *data  = table + (uint64_t)node_count * AST_NODE_WORDS;
+  if (swapped)
+    for (uint32_t *word = (uint32_t *)table; word < data + data_size; word++) *word = swap_word(*word);
+
+  std::vector<symbol_c *> nodes(node_count);
+  for (uint32_t i = 0; i < node_count; i++) {
+    uint32_t kind      = table[i * AST_NODE_WORDS    ] & ~AST_SHARED_FLAG;
+    bool     shared    = table[i * AST_NODE_WORDS    ] &  AST_SHARED_FLAG;
+    uint32_t value_ref = table[i * AST_NODE_WORDS + 1];
+    if (value_ref > pool_size) return load_error(filename, "file is corrupted");
+    nodes[i] = shared? shared_symbol(kind) : new_symbol(kind, (0 == value_ref)? NULL : pool + value_ref - 1);
+    if (NULL == nodes[i]) return load_error(filename, "file is corrupted");
+  }
+
+  ast_read_c   read(nodes, pool, pool_size);
+  ast_fields_c read_fields(read);
+  for (uint32_t i = 0; i < node_count; i++) {
+    if (table[i * AST_NODE_WORDS] & AST_SHARED_FLAG) continue;
+    uint32_t offset = table[i * AST_NODE_WORDS + 2];
+    if (offset > data_size) return load_error(filename, "file is corrupted");
+    read.seek(data + offset, data + data_size);
+    nodes[i]->accept(read_fields);
+    if (read.failed) return load_error(filename, "file is corrupted");
+  }
+
+  return nodes[root - 1];
+}
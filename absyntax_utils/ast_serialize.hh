@@ -0,0 +1,105 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+/*
+ *  Store an abstract syntax tree in a (binary) file, and load it back.
+ *
+ *  The stored tree includes the source code location of every symbol, and the annotations
+ *  produced by stage 3 (datatype, scope, const_value, and the annotations declared for
+ *  specific classes in absyntax.def, e.g. called_function_declaration, enumvalue_symtable, ...).
+ *  A tree loaded from a file after stage 3 may therefore be handed directly to stage 4, without
+ *  running stage 1_2 and stage 3 again (absyntax_utils_init() must however be called first, to
+ *  fill in the symbol tables).
+ *
+ *  Not stored are the intermediate results of the datatype analysis (candidate_datatypes and
+ *  candidate_functions), as well as the stage 4 anotations_map.
+ *
+ *  The elementary datatype objects of get_datatype_info_c (bool_type_name, invalid_type_name, ...),
+ *  which the datatype annotations frequently point to, are not copied. The loaded tree
+ *  points to the same objects.
+ *
+ *  File format
+ *  -----------
+ *  The file consists of 32 bit words (in the byte order of the machine that wrote it) and has
+ *  no pointers, only offsets, so it may be used directly from memory (or mmap'ed):
+ *
+ *    header      "MATIECAS", byte_order (0x01020304), version, layout_hash (64 bits), options, symbol_kind_count,
+ *                string_pool_size (bytes), node_count, node_data_size (words), root (node reference)
+ *    string pool the NUL terminated strings (token values and file names), padded to a word boundary
+ *    node table  3 words per node: kind (plus the SHARED flag), value (string reference, tokens only),
+ *                offset of the node's fields in the node data
+ *    node data   the fields of each node
+ *
+ *  A node reference is the node's index + 1, and a string reference is the string's offset + 1
+ *  (0 is a NULL pointer in both cases). The fields of each node are, in this order:
+ *    - parent, first_file, first_line, first_column, first_order, last_file, last_line, last_column,
+ *      last_order, datatype, scope, const_value;
+ *    - the references to the child nodes, in the order they are declared in absyntax.def
+ *      (for lists, the number of elements followed by each element);
+ *    - the annotations declared for the specific class in absyntax.def.
+ *  64 bit values (first_order, last_order, constant values) take two words, least significant first.
+ *  const_value takes one word with the status of each of its 4 values (2 bits each), followed
+ *  by each valid value: the int64, uint64 and real64 values (the latter as an IEEE 754 double) take
+ *  two words, the bool value one word (0 or 1).
+ *
+ *  The symbol kinds are those of the absyntax.def the compiler was built with. The layout_hash is a
+ *  hash of the classes declared in absyntax.def (their names and order, the names of their references,
+ *  and the declaration of their annotations). A file written by a compiler built with a different
+ *  absyntax.def (i.e. with a different layout_hash or symbol_kind_count), or with a different version
+ *  of the format, is rejected. The annotations stored for each class are checked against absyntax.def
+ *  when the compiler saves or loads a tree (see AST_ANNOTATIONS in ast_serialize.cc).
+ *
+ *  The options word has one bit for each runtime option that changes the tree built by stage 1_2
+ *  and stage 3 (-b, -i, -e, -p, -s, -c, -n, -r, -R, -a, -l). A tree is only loaded if it was stored
+ *  with the same options as the ones given when loading it.
+ *  A file written on a machine with the other byte order (the byte_order word reads as 0x04030201)
+ *  is converted while it is loaded.
+ */
+
+
+#ifndef _AST_SERIALIZE_HH
+#define _AST_SERIALIZE_HH
+
+#include "absyntax_utils.hh"
+
+
+class ast_serialize_c {
+  public:
+    static const uint32_t version = 3;
+
+    /* Store the tree in the file. Returns 0 on success, or -1 on error (after printing an error message) */
+    static int       save(symbol_c *tree_root, const char *filename);
+    /* Load a tree from the file. Returns the root of the tree, or NULL on error (after printing an error message) */
+    static symbol_c *load(const char *filename);
+};
+
+
+#endif /* _AST_SERIALIZE_HH */
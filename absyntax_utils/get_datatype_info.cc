@@ -47,7 +47,6 @@
 
 
 
-#include <typeinfo>  // required for typeid
 
 
 /**********************************************************/
@@ -584,6 +583,9 @@ bool get_datatype_info_c::is_type_equal(symbol_c *first_type, symbol_c *second_t
   if (!is_type_valid( first_type))                                   {return false;}
   if (!is_type_valid(second_type))                                   {return false;}
 
+  /* the same datatype (e.g. both symbols returned by search_base_type_c) */
+  if (first_type == second_type)                                     {return true;}
+
   /* GENERIC DATATYPES */
   /* For the moment, we only support the ANY generic datatype! */
   if ((is_ANY_generic_type( first_type)) ||
@@ -591,7 +593,7 @@ bool get_datatype_info_c::is_type_equal(symbol_c *first_type, symbol_c *second_t
       
   /* ANY_ELEMENTARY */
   if ((is_ANY_ELEMENTARY_compatible(first_type)) &&
-      (typeid(*first_type) == typeid(*second_type)))                 {return true;}
+      (first_type->kind == second_type->kind))                      {return true;}
   if (   is_ANY_ELEMENTARY_compatible(first_type) 
       || is_ANY_ELEMENTARY_compatible(second_type))                  {return false;}  
   
@@ -697,10 +699,11 @@ static std::string normalize_subrange_limit(symbol_c *symbol) {
 bool get_datatype_info_c::is_arraytype_equal_relaxed(symbol_c *first_type, symbol_c *second_type) {
   symbol_c *basetype_1 = search_base_type_c::get_basetype_decl( first_type);
   symbol_c *basetype_2 = search_base_type_c::get_basetype_decl(second_type);
-  array_specification_c *array_1 = dynamic_cast<array_specification_c *>(basetype_1);
-  array_specification_c *array_2 = dynamic_cast<array_specification_c *>(basetype_2);
-
   // are they both array datatypes? 
+  if ((NULL == basetype_1) || (NULL == basetype_2))
+    return false;
+  array_specification_c *array_1 = basetype_1->as<array_specification_c>();
+  array_specification_c *array_2 = basetype_2->as<array_specification_c>();
   if ((NULL == array_1) || (NULL == array_2))
     return false;
   
@@ -746,7 +749,7 @@ bool get_datatype_info_c::is_arraytype_equal_relaxed(symbol_c *first_type, symbo
 
 bool get_datatype_info_c::is_type_valid(symbol_c *type) {
   if (NULL == type)                                                  {return false;}
-  if (typeid(*type) == typeid(invalid_type_name_c))                  {return false;}
+  if (type->is<invalid_type_name_c>())                               {return false;}
   return true;
 }
 
@@ -758,13 +761,16 @@ bool get_datatype_info_c::is_type_valid(symbol_c *type) {
 
 /* returns the datatype the REF_TO datatype references/points to... */ 
 symbol_c *get_datatype_info_c::get_ref_to(symbol_c *type_symbol) {
-  ref_type_decl_c *type1 = dynamic_cast<ref_type_decl_c *>(type_symbol);
+  if (NULL == type_symbol) return NULL;
+  ref_type_decl_c *type1 = type_symbol->as<ref_type_decl_c>();
   if (NULL != type1) type_symbol = type1->ref_spec_init;
 
-  ref_spec_init_c *type2 = dynamic_cast<ref_spec_init_c *>(type_symbol);
+  if (NULL == type_symbol) return NULL;
+  ref_spec_init_c *type2 = type_symbol->as<ref_spec_init_c>();
   if (NULL != type2) type_symbol = type2->ref_spec;
 
-  ref_spec_c      *type3 = dynamic_cast<ref_spec_c      *>(type_symbol);
+  if (NULL == type_symbol) return NULL;
+  ref_spec_c      *type3 = type_symbol->as<ref_spec_c     >();
   if (NULL != type3) return type3->type_name;
   
   return NULL; /* this is not a ref datatype!! */
@@ -779,9 +785,9 @@ bool get_datatype_info_c::is_ref_to(symbol_c *type_symbol) {
   symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol);
   if (NULL == type_decl)                                                       {return false;}
   
-  if (typeid(*type_decl) == typeid(ref_type_decl_c))                           {return true;}   /* identifier ':' ref_spec_init */
-  if (typeid(*type_decl) == typeid(ref_spec_init_c))                           {return true;}   /* ref_spec [ ASSIGN ref_initialization ]; */
-  if (typeid(*type_decl) == typeid(ref_spec_c))                                {return true;}   /* REF_TO (non_generic_type_name | function_block_type_name) */
+  if (type_decl->is<ref_type_decl_c>())                                        {return true;}   /* identifier ':' ref_spec_init */
+  if (type_decl->is<ref_spec_init_c>())                                        {return true;}   /* ref_spec [ ASSIGN ref_initialization ]; */
+  if (type_decl->is<ref_spec_c>())                                             {return true;}   /* REF_TO (non_generic_type_name | function_block_type_name) */
   return false;
 }
 
@@ -791,7 +797,7 @@ bool get_datatype_info_c::is_ref_to(symbol_c *type_symbol) {
 bool get_datatype_info_c::is_sfc_initstep(symbol_c *type_symbol) {
   symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol); 
   if (NULL == type_decl)                                             {return false;}
-  if (typeid(*type_decl) == typeid(initial_step_c))                  {return true;}   /* INITIAL_STEP step_name ':' action_association_list END_STEP */  /* A pseudo data type! */
+  if (type_decl->is<initial_step_c>())                               {return true;}   /* INITIAL_STEP step_name ':' action_association_list END_STEP */  /* A pseudo data type! */
   return false;
 }
 
@@ -800,8 +806,8 @@ bool get_datatype_info_c::is_sfc_initstep(symbol_c *type_symbol) {
 bool get_datatype_info_c::is_sfc_step(symbol_c *type_symbol) {
   symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol); 
   if (NULL == type_decl)                                             {return false;}
-  if (typeid(*type_decl) == typeid(initial_step_c))                  {return true;}   /* INITIAL_STEP step_name ':' action_association_list END_STEP */  /* A pseudo data type! */
-  if (typeid(*type_decl) == typeid(        step_c))                  {return true;}   /*         STEP step_name ':' action_association_list END_STEP */  /* A pseudo data type! */
+  if (type_decl->is<initial_step_c>())                               {return true;}   /* INITIAL_STEP step_name ':' action_association_list END_STEP */  /* A pseudo data type! */
+  if (type_decl->is<        step_c>())                               {return true;}   /*         STEP step_name ':' action_association_list END_STEP */  /* A pseudo data type! */
   return false;
 }
 
@@ -811,7 +817,7 @@ bool get_datatype_info_c::is_sfc_step(symbol_c *type_symbol) {
 bool get_datatype_info_c::is_function_block(symbol_c *type_symbol) {
   symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol); 
   if (NULL == type_decl)                                             {return false;}
-  if (typeid(*type_decl) == typeid(function_block_declaration_c))    {return true;}   /*  FUNCTION_BLOCK derived_function_block_name io_OR_other_var_declarations function_block_body END_FUNCTION_BLOCK */
+  if (type_decl->is<function_block_declaration_c>())                 {return true;}   /*  FUNCTION_BLOCK derived_function_block_name io_OR_other_var_declarations function_block_body END_FUNCTION_BLOCK */
   return false;
 }
 
@@ -823,11 +829,11 @@ bool get_datatype_info_c::is_subrange(symbol_c *type_symbol) {
   symbol_c *type_decl = search_base_type_c::get_equivtype_decl(type_symbol); /* NOTE: do NOT call search_base_type_c !! */
   if (NULL == type_decl)                                             {return false;}
   
-  if (typeid(*type_decl) == typeid(subrange_type_declaration_c))     {return true;}   /*  subrange_type_name ':' subrange_spec_init */
-  if (typeid(*type_decl) == typeid(subrange_spec_init_c))            {return true;}   /* subrange_specification ASSIGN signed_integer */
-  if (typeid(*type_decl) == typeid(subrange_specification_c))        {return true;}   /*  integer_type_name '(' subrange')' */
+  if (type_decl->is<subrange_type_declaration_c>())                  {return true;}   /*  subrange_type_name ':' subrange_spec_init */
+  if (type_decl->is<subrange_spec_init_c>())                         {return true;}   /* subrange_specification ASSIGN signed_integer */
+  if (type_decl->is<subrange_specification_c>())                     {return true;}   /*  integer_type_name '(' subrange')' */
     
-  if (typeid(*type_decl) == typeid(subrange_c))                      {ERROR;}         /*  signed_integer DOTDOT signed_integer */
+  if (type_decl->is<subrange_c>())                                   {ERROR;}         /*  signed_integer DOTDOT signed_integer */
   return false;
 }
 
@@ -839,11 +845,11 @@ bool get_datatype_info_c::is_enumerated(symbol_c *type_symbol) {
   symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol);
   if (NULL == type_decl)                                             {return false;}
   
-  if (typeid(*type_decl) == typeid(enumerated_type_declaration_c))   {return true;}   /*  enumerated_type_name ':' enumerated_spec_init */
-  if (typeid(*type_decl) == typeid(enumerated_spec_init_c))          {return true;}   /* enumerated_specification ASSIGN enumerated_value */
-  if (typeid(*type_decl) == typeid(enumerated_value_list_c))         {return true;}   /* enumerated_value_list ',' enumerated_value */        /* once we change the way we handle enums, this will probably become an ERROR! */
+  if (type_decl->is<enumerated_type_declaration_c>())                {return true;}   /*  enumerated_type_name ':' enumerated_spec_init */
+  if (type_decl->is<enumerated_spec_init_c>())                       {return true;}   /* enumerated_specification ASSIGN enumerated_value */
+  if (type_decl->is<enumerated_value_list_c>())                      {return true;}   /* enumerated_value_list ',' enumerated_value */        /* once we change the way we handle enums, this will probably become an ERROR! */
   
-  if (typeid(*type_decl) == typeid(enumerated_value_c))              {ERROR;}         /* enumerated_type_name '#' identifier */
+  if (type_decl->is<enumerated_value_c>())                           {ERROR;}         /* enumerated_type_name '#' identifier */
   return false;
 }
 
@@ -855,13 +861,13 @@ bool get_datatype_info_c::is_array(symbol_c *type_symbol) {
   symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol);
   if (NULL == type_decl)                                             {return false;}
   
-  if (typeid(*type_decl) == typeid(array_type_declaration_c))        {return true;}   /*  identifier ':' array_spec_init */
-  if (typeid(*type_decl) == typeid(array_spec_init_c))               {return true;}   /* array_specification [ASSIGN array_initialization} */
-  if (typeid(*type_decl) == typeid(array_specification_c))           {return true;}   /* ARRAY '[' array_subrange_list ']' OF non_generic_type_name */
+  if (type_decl->is<array_type_declaration_c>())                     {return true;}   /*  identifier ':' array_spec_init */
+  if (type_decl->is<array_spec_init_c>())                            {return true;}   /* array_specification [ASSIGN array_initialization} */
+  if (type_decl->is<array_specification_c>())                        {return true;}   /* ARRAY '[' array_subrange_list ']' OF non_generic_type_name */
   
-  if (typeid(*type_decl) == typeid(array_subrange_list_c))           {ERROR;}         /* array_subrange_list ',' subrange */
-  if (typeid(*type_decl) == typeid(array_initial_elements_list_c))   {ERROR;}         /* array_initialization:  '[' array_initial_elements_list ']' */  /* array_initial_elements_list ',' array_initial_elements */
-  if (typeid(*type_decl) == typeid(array_initial_elements_c))        {ERROR;}         /* integer '(' [array_initial_element] ')' */
+  if (type_decl->is<array_subrange_list_c>())                        {ERROR;}         /* array_subrange_list ',' subrange */
+  if (type_decl->is<array_initial_elements_list_c>())                {ERROR;}         /* array_initialization:  '[' array_initial_elements_list ']' */  /* array_initial_elements_list ',' array_initial_elements */
+  if (type_decl->is<array_initial_elements_c>())                     {ERROR;}         /* integer '(' [array_initial_element] ')' */
   return false;
 }
 
@@ -873,13 +879,13 @@ bool get_datatype_info_c::is_structure(symbol_c *type_symbol) {
   symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol);
   if (NULL == type_decl)                                                       {return false;}
   
-  if (typeid(*type_decl) == typeid(structure_type_declaration_c))              {return true;}   /*  structure_type_name ':' structure_specification */
-  if (typeid(*type_decl) == typeid(initialized_structure_c))                   {return true;}   /* structure_type_name ASSIGN structure_initialization */
-  if (typeid(*type_decl) == typeid(structure_element_declaration_list_c))      {return true;}   /* structure_declaration:  STRUCT structure_element_declaration_list END_STRUCT */ /* structure_element_declaration_list structure_element_declaration ';' */
+  if (type_decl->is<structure_type_declaration_c>())                           {return true;}   /*  structure_type_name ':' structure_specification */
+  if (type_decl->is<initialized_structure_c>())                                {return true;}   /* structure_type_name ASSIGN structure_initialization */
+  if (type_decl->is<structure_element_declaration_list_c>())                   {return true;}   /* structure_declaration:  STRUCT structure_element_declaration_list END_STRUCT */ /* structure_element_declaration_list structure_element_declaration ';' */
   
-  if (typeid(*type_decl) == typeid(structure_element_declaration_c))           {ERROR;}         /*  structure_element_name ':' *_spec_init */
-  if (typeid(*type_decl) == typeid(structure_element_initialization_list_c))   {ERROR;}         /* structure_initialization: '(' structure_element_initialization_list ')' */  /* structure_element_initialization_list ',' structure_element_initialization */
-  if (typeid(*type_decl) == typeid(structure_element_initialization_c))        {ERROR;}         /*  structure_element_name ASSIGN value */
+  if (type_decl->is<structure_element_declaration_c>())                        {ERROR;}         /*  structure_element_name ':' *_spec_init */
+  if (type_decl->is<structure_element_initialization_list_c>())                {ERROR;}         /* structure_initialization: '(' structure_element_initialization_list ')' */  /* structure_element_initialization_list ',' structure_element_initialization */
+  if (type_decl->is<structure_element_initialization_c>())                     {ERROR;}         /*  structure_element_name ASSIGN value */
   return false;
 }
 
@@ -889,7 +895,7 @@ bool get_datatype_info_c::is_structure(symbol_c *type_symbol) {
 bool get_datatype_info_c::is_ANY_generic_type(symbol_c *type_symbol) {
   symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol);
   if (NULL == type_decl)                                             {return false;}  
-  if (typeid(*type_decl) == typeid(generic_type_any_c))              {return true;}   /*  The ANY keyword! */
+  if (type_decl->is<generic_type_any_c>())                           {return true;}   /*  The ANY keyword! */
   return false;
 }
 
@@ -958,7 +964,7 @@ bool get_datatype_info_c::is_ANY_MAGNITUDE_compatible(symbol_c *type_symbol) {
 
 bool get_datatype_info_c::is_ANY_signed_MAGNITUDE(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(time_type_name_c))        {return true;}
+  if (type_symbol->is<time_type_name_c>())                     {return true;}
   if (is_ANY_signed_NUM(type_symbol))                          {return true;}
   return false;
 }
@@ -966,7 +972,7 @@ bool get_datatype_info_c::is_ANY_signed_MAGNITUDE(symbol_c *type_symbol) {
 
 bool get_datatype_info_c::is_ANY_signed_SAFEMAGNITUDE(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safetime_type_name_c))    {return true;}
+  if (type_symbol->is<safetime_type_name_c>())                 {return true;}
   return is_ANY_signed_SAFENUM(type_symbol);
 }
 
@@ -1072,20 +1078,20 @@ bool get_datatype_info_c::is_ANY_INT_compatible(symbol_c *type_symbol) {
 
 bool get_datatype_info_c::is_ANY_signed_INT(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(sint_type_name_c))        {return true;}
-  if (typeid(*type_symbol) == typeid(int_type_name_c))         {return true;}
-  if (typeid(*type_symbol) == typeid(dint_type_name_c))        {return true;}
-  if (typeid(*type_symbol) == typeid(lint_type_name_c))        {return true;}
+  if (type_symbol->is<sint_type_name_c>())                     {return true;}
+  if (type_symbol->is<int_type_name_c>())                      {return true;}
+  if (type_symbol->is<dint_type_name_c>())                     {return true;}
+  if (type_symbol->is<lint_type_name_c>())                     {return true;}
   return false;
 }
 
 
 bool get_datatype_info_c::is_ANY_signed_SAFEINT(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safesint_type_name_c))    {return true;}
-  if (typeid(*type_symbol) == typeid(safeint_type_name_c))     {return true;}
-  if (typeid(*type_symbol) == typeid(safedint_type_name_c))    {return true;}
-  if (typeid(*type_symbol) == typeid(safelint_type_name_c))    {return true;}
+  if (type_symbol->is<safesint_type_name_c>())                 {return true;}
+  if (type_symbol->is<safeint_type_name_c>())                  {return true;}
+  if (type_symbol->is<safedint_type_name_c>())                 {return true;}
+  if (type_symbol->is<safelint_type_name_c>())                 {return true;}
   return false;
 }
 
@@ -1107,20 +1113,20 @@ bool get_datatype_info_c::is_ANY_signed_INT_compatible(symbol_c *type_symbol) {
 
 bool get_datatype_info_c::is_ANY_unsigned_INT(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(usint_type_name_c))       {return true;}
-  if (typeid(*type_symbol) == typeid(uint_type_name_c))        {return true;}
-  if (typeid(*type_symbol) == typeid(udint_type_name_c))       {return true;}
-  if (typeid(*type_symbol) == typeid(ulint_type_name_c))       {return true;}
+  if (type_symbol->is<usint_type_name_c>())                    {return true;}
+  if (type_symbol->is<uint_type_name_c>())                     {return true;}
+  if (type_symbol->is<udint_type_name_c>())                    {return true;}
+  if (type_symbol->is<ulint_type_name_c>())                    {return true;}
   return false;
 }
 
 
 bool get_datatype_info_c::is_ANY_unsigned_SAFEINT(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safeusint_type_name_c))   {return true;}
-  if (typeid(*type_symbol) == typeid(safeuint_type_name_c))    {return true;}
-  if (typeid(*type_symbol) == typeid(safeudint_type_name_c))   {return true;}
-  if (typeid(*type_symbol) == typeid(safeulint_type_name_c))   {return true;}
+  if (type_symbol->is<safeusint_type_name_c>())                {return true;}
+  if (type_symbol->is<safeuint_type_name_c>())                 {return true;}
+  if (type_symbol->is<safeudint_type_name_c>())                {return true;}
+  if (type_symbol->is<safeulint_type_name_c>())                {return true;}
   return false;
 }
 
@@ -1141,16 +1147,16 @@ bool get_datatype_info_c::is_ANY_unsigned_INT_compatible(symbol_c *type_symbol)
 
 bool get_datatype_info_c::is_ANY_REAL(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(real_type_name_c))        {return true;}
-  if (typeid(*type_symbol) == typeid(lreal_type_name_c))       {return true;}
+  if (type_symbol->is<real_type_name_c>())                     {return true;}
+  if (type_symbol->is<lreal_type_name_c>())                    {return true;}
   return false;
 }
 
 
 bool get_datatype_info_c::is_ANY_SAFEREAL(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safereal_type_name_c))    {return true;}
-  if (typeid(*type_symbol) == typeid(safelreal_type_name_c))   {return true;}
+  if (type_symbol->is<safereal_type_name_c>())                 {return true;}
+  if (type_symbol->is<safelreal_type_name_c>())                {return true;}
   return false;
 }
 
@@ -1171,20 +1177,20 @@ bool get_datatype_info_c::is_ANY_REAL_compatible(symbol_c *type_symbol) {
 
 bool get_datatype_info_c::is_ANY_nBIT(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(byte_type_name_c))        {return true;}
-  if (typeid(*type_symbol) == typeid(word_type_name_c))        {return true;}
-  if (typeid(*type_symbol) == typeid(dword_type_name_c))       {return true;}
-  if (typeid(*type_symbol) == typeid(lword_type_name_c))       {return true;}
+  if (type_symbol->is<byte_type_name_c>())                     {return true;}
+  if (type_symbol->is<word_type_name_c>())                     {return true;}
+  if (type_symbol->is<dword_type_name_c>())                    {return true;}
+  if (type_symbol->is<lword_type_name_c>())                    {return true;}
   return false;
 }
 
 
 bool get_datatype_info_c::is_ANY_SAFEnBIT(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safebyte_type_name_c))    {return true;}
-  if (typeid(*type_symbol) == typeid(safeword_type_name_c))    {return true;}
-  if (typeid(*type_symbol) == typeid(safedword_type_name_c))   {return true;}
-  if (typeid(*type_symbol) == typeid(safelword_type_name_c))   {return true;}
+  if (type_symbol->is<safebyte_type_name_c>())                 {return true;}
+  if (type_symbol->is<safeword_type_name_c>())                 {return true;}
+  if (type_symbol->is<safedword_type_name_c>())                {return true;}
+  if (type_symbol->is<safelword_type_name_c>())                {return true;}
   return false;
 }
 
@@ -1207,14 +1213,14 @@ bool get_datatype_info_c::is_ANY_nBIT_compatible(symbol_c *type_symbol) {
 
 bool get_datatype_info_c::is_BOOL(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(bool_type_name_c))        {return true;}
+  if (type_symbol->is<bool_type_name_c>())                     {return true;}
   return false;
 }
 
 
 bool get_datatype_info_c::is_SAFEBOOL(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safebool_type_name_c))    {return true;}
+  if (type_symbol->is<safebool_type_name_c>())                 {return true;}
   return false;
 }
 
@@ -1266,14 +1272,14 @@ bool get_datatype_info_c::is_ANY_BIT_compatible(symbol_c *type_symbol) {
 
 bool get_datatype_info_c::is_TIME(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(time_type_name_c))        {return true;}
+  if (type_symbol->is<time_type_name_c>())                     {return true;}
   return false;
 }
 
 
 bool get_datatype_info_c::is_SAFETIME(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safetime_type_name_c))    {return true;}
+  if (type_symbol->is<safetime_type_name_c>())                 {return true;}
   return false;
 }
 
@@ -1294,18 +1300,18 @@ bool get_datatype_info_c::is_TIME_compatible(symbol_c *type_symbol) {
 
 bool get_datatype_info_c::is_ANY_DATE(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(date_type_name_c))        {return true;}
-  if (typeid(*type_symbol) == typeid(tod_type_name_c))         {return true;}
-  if (typeid(*type_symbol) == typeid(dt_type_name_c))          {return true;}
+  if (type_symbol->is<date_type_name_c>())                     {return true;}
+  if (type_symbol->is<tod_type_name_c>())                      {return true;}
+  if (type_symbol->is<dt_type_name_c>())                       {return true;}
   return false;
 }
 
 
 bool get_datatype_info_c::is_ANY_SAFEDATE(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safedate_type_name_c))    {return true;}
-  if (typeid(*type_symbol) == typeid(safetod_type_name_c))     {return true;}
-  if (typeid(*type_symbol) == typeid(safedt_type_name_c))      {return true;}
+  if (type_symbol->is<safedate_type_name_c>())                 {return true;}
+  if (type_symbol->is<safetod_type_name_c>())                  {return true;}
+  if (type_symbol->is<safedt_type_name_c>())                   {return true;}
   return false;
 }
 
@@ -1329,16 +1335,16 @@ bool get_datatype_info_c::is_ANY_DATE_compatible(symbol_c *type_symbol) {
 
 bool get_datatype_info_c::is_ANY_STRING(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(string_type_name_c))      {return true;}
-  if (typeid(*type_symbol) == typeid(wstring_type_name_c))     {return true;}
+  if (type_symbol->is<string_type_name_c>())                   {return true;}
+  if (type_symbol->is<wstring_type_name_c>())                  {return true;}
   return false;
 }
 
 
 bool get_datatype_info_c::is_ANY_SAFESTRING(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(safestring_type_name_c))  {return true;}
-  if (typeid(*type_symbol) == typeid(safewstring_type_name_c)) {return true;}
+  if (type_symbol->is<safestring_type_name_c>())               {return true;}
+  if (type_symbol->is<safewstring_type_name_c>()) {return true;}
   return false;
 }
 
@@ -1359,7 +1365,7 @@ bool get_datatype_info_c::is_ANY_STRING_compatible(symbol_c *type_symbol) {
 
 bool get_datatype_info_c::is_VOID(symbol_c *type_symbol) {
   if (type_symbol == NULL)                                     {return false;}
-  if (typeid(*type_symbol) == typeid(void_type_name_c))        {return true;}
+  if (type_symbol->is<void_type_name_c>())                     {return true;}
   return false;
 }
 
@@ -1374,19 +1380,19 @@ bool get_datatype_info_c::is_VOID(symbol_c *type_symbol) {
 /* Can't we do away with this?? */
 bool get_datatype_info_c::is_ANY_REAL_literal(symbol_c *type_symbol) {
   if (type_symbol == NULL)                              {return true;} /* Please make sure things will work correctly before changing this to false!! */
-  if (typeid(*type_symbol) == typeid(real_c))           {return true;}
-  if (typeid(*type_symbol) == typeid(neg_real_c))       {return true;}
+  if (type_symbol->is<real_c>())                        {return true;}
+  if (type_symbol->is<neg_real_c>())                    {return true;}
   return false;
 }
 
 /* Can't we do away with this?? */
 bool get_datatype_info_c::is_ANY_INT_literal(symbol_c *type_symbol) {
   if (type_symbol == NULL)                              {return true;} /* Please make sure things will work correctly before changing this to false!! */
-  if (typeid(*type_symbol) == typeid(integer_c))        {return true;}
-  if (typeid(*type_symbol) == typeid(neg_integer_c))    {return true;}
-  if (typeid(*type_symbol) == typeid(binary_integer_c)) {return true;}
-  if (typeid(*type_symbol) == typeid(octal_integer_c))  {return true;}
-  if (typeid(*type_symbol) == typeid(hex_integer_c))    {return true;}
+  if (type_symbol->is<integer_c>())                     {return true;}
+  if (type_symbol->is<neg_integer_c>())                 {return true;}
+  if (type_symbol->is<binary_integer_c>()) {return true;}
+  if (type_symbol->is<octal_integer_c>())               {return true;}
+  if (type_symbol->is<hex_integer_c>())                 {return true;}
   return false;
 }
 
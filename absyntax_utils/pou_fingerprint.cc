@@ -0,0 +1,372 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+/*
+ *  Compute a stable fingerprint for each element of a library (POUs and datatype declarations).
+ *  Please read the comments in pou_fingerprint.hh for details.
+ */
+
+
+#include "pou_fingerprint.hh"
+#include <string.h>
+#include <algorithm>
+
+
+
+/* 64 bit FNV-1a hash */
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME        1099511628211ULL
+
+static pou_fingerprint_c::fingerprint_t hash_bytes(pou_fingerprint_c::fingerprint_t hash, const void *data, size_t len) {
+  const unsigned char *ptr = (const unsigned char *)data;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= ptr[i];
+    hash *= FNV_PRIME;
+  }
+  return hash;
+}
+
+static pou_fingerprint_c::fingerprint_t hash_str(pou_fingerprint_c::fingerprint_t hash, const char *str) {
+  if (NULL == str) str = "";
+  return hash_bytes(hash, str, strlen(str) + 1); /* include the '\0', so "ab"+"c" and "a"+"bc" differ */
+}
+
+static pou_fingerprint_c::fingerprint_t hash_int(pou_fingerprint_c::fingerprint_t hash, long long int value) {
+  unsigned char bytes[8]; /* independent of the endianess of the host */
+  for (int i = 0; i < 8; i++) bytes[i] = (unsigned char)((unsigned long long int)value >> (8*i));
+  return hash_bytes(hash, bytes, 8);
+}
+
+/* Mix in the status of a constant value, and the value itself when it is valid */
+template<typename value_type>
+static pou_fingerprint_c::fingerprint_t hash_const_value(pou_fingerprint_c::fingerprint_t hash, const_value_c::const_value__<value_type> &cv) {
+  if      (cv.is_undefined()) return hash_int(hash, 0);
+  else if (cv.is_nonconst ()) return hash_int(hash, 1);
+  else if (cv.is_overflow ()) return hash_int(hash, 2);
+  value_type value = cv.get();
+  uint64_t   bits  = 0;
+  memcpy(&bits, &value, sizeof(value)); /* real64_t is hashed through its bit pattern */
+  return hash_int(hash_int(hash, 3), bits);
+}
+
+
+
+
+/* A visitor that hashes a (sub-)tree of the AST.
+ *   - every node contributes with its class name, and every token with its text;
+ *   - every node also contributes with its const_value, as determined by stage 3. This covers the
+ *     values of the VAR_GLOBAL CONSTANT variables of the configuration, which are propagated into
+ *     the POUs through VAR_EXTERNAL CONSTANT (and used in the generated code for array bounds,
+ *     removal of dead branches, ...), without being part of the POU's source code;
+ *   - NULL references also contribute, so that a value in ref1 is not confused with the same value in ref2;
+ *   - the names of any referenced derived datatypes and POU types are collected in the references set.
+ */
+class hash_ast_c: public visitor_c {
+  private:
+    pou_fingerprint_c::fingerprint_t  hash;
+    std::set<std::string, nocasecmp_c> *references;
+    bool                               include_location;
+
+  public:
+    hash_ast_c(std::set<std::string, nocasecmp_c> *references_, bool include_location_) {
+      hash             = FNV_OFFSET_BASIS;
+      references       = references_;
+      include_location = include_location_;
+    }
+
+    pou_fingerprint_c::fingerprint_t get_hash(void) {return hash;}
+
+    void mix(symbol_c *symbol) {
+      if (NULL == symbol) {hash = hash_str(hash, "(null)"); return;}
+      symbol->accept(*this);
+    }
+
+  private:
+    void mix_node(symbol_c *symbol) {
+      hash = hash_str(hash, symbol->absyntax_cname());
+      hash = hash_const_value(hash, symbol->const_value._int64);
+      hash = hash_const_value(hash, symbol->const_value._uint64);
+      hash = hash_const_value(hash, symbol->const_value._real64);
+      hash = hash_const_value(hash, symbol->const_value._bool);
+      if (include_location) {
+        hash = hash_int(hash, symbol->first_line);
+        hash = hash_int(hash, symbol->last_line);
+      }
+    }
+
+    void mix_token(token_c *symbol) {
+      mix_node(symbol);
+      hash = hash_str(hash, symbol->value);
+    }
+
+    void mix_list(list_c *symbol) {
+      mix_node(symbol);
+      hash = hash_int(hash, symbol->n);
+      for (int i = 0; i < symbol->n; i++) mix(symbol->elements[i]);
+    }
+
+  protected:
+    void add_reference(token_c *symbol) {
+      mix_token(symbol);
+      references->insert(symbol->value);
+    }
+
+  public:
+    #define SYM_LIST(class_name_c, ...)                                      void *visit(class_name_c *symbol) {mix_list(symbol); return NULL;}
+    #define SYM_TOKEN(class_name_c, ...)                                     void *visit(class_name_c *symbol) {mix_token(symbol); return NULL;}
+    #define SYM_REF0(class_name_c, ...)                                      void *visit(class_name_c *symbol) {mix_node(symbol); return NULL;}
+    #define SYM_REF1(class_name_c, ref1, ...)                                void *visit(class_name_c *symbol) {mix_node(symbol); mix(symbol->ref1); return NULL;}
+    #define SYM_REF2(class_name_c, ref1, ref2, ...)                          void *visit(class_name_c *symbol) {mix_node(symbol); mix(symbol->ref1); mix(symbol->ref2); return NULL;}
+    #define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                    void *visit(class_name_c *symbol) {mix_node(symbol); mix(symbol->ref1); mix(symbol->ref2); mix(symbol->ref3); return NULL;}
+    #define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)              void *visit(class_name_c *symbol) {mix_node(symbol); mix(symbol->ref1); mix(symbol->ref2); mix(symbol->ref3); mix(symbol->ref4); return NULL;}
+    #define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)        void *visit(class_name_c *symbol) {mix_node(symbol); mix(symbol->ref1); mix(symbol->ref2); mix(symbol->ref3); mix(symbol->ref4); mix(symbol->ref5); return NULL;}
+    #define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)  void *visit(class_name_c *symbol) {mix_node(symbol); mix(symbol->ref1); mix(symbol->ref2); mix(symbol->ref3); mix(symbol->ref4); mix(symbol->ref5); mix(symbol->ref6); return NULL;}
+
+    #include "../absyntax/absyntax.def"
+
+    #undef SYM_LIST
+    #undef SYM_TOKEN
+    #undef SYM_REF0
+    #undef SYM_REF1
+    #undef SYM_REF2
+    #undef SYM_REF3
+    #undef SYM_REF4
+    #undef SYM_REF5
+    #undef SYM_REF6
+};
+
+
+/* Same as hash_ast_c, but also collects the names of all referenced derived datatypes and POU types. */
+class hash_ast_and_references_c: public hash_ast_c {
+  public:
+    hash_ast_and_references_c(std::set<std::string, nocasecmp_c> *references_, bool include_location_)
+      : hash_ast_c(references_, include_location_) {}
+
+    void *visit(derived_datatype_identifier_c *symbol) {add_reference(symbol); return NULL;}
+    void *visit(         poutype_identifier_c *symbol) {add_reference(symbol); return NULL;}
+};
+
+
+
+
+/* Determine which part of a library element should be hashed when computing its signature */
+class get_interface_c: public null_visitor_c {
+  private:
+    symbol_c *ref1, *ref2, *ref3;
+
+  public:
+    get_interface_c(void) {ref1 = ref2 = ref3 = NULL;}
+
+    void hash(symbol_c *element, hash_ast_c &hasher) {
+      ref1 = ref2 = ref3 = NULL;
+      if (element->accept(*this) == NULL) {hasher.mix(element); return;} // not a POU => hash everything
+      hasher.mix(ref1);
+      hasher.mix(ref2);
+      hasher.mix(ref3);
+    }
+
+    /* The body of the POUs is not part of their signature. */
+    // SYM_REF4(function_declaration_c, derived_function_name, type_name, var_declarations_list, function_body, ...)
+    void *visit(function_declaration_c *symbol)
+      {ref1 = symbol->derived_function_name; ref2 = symbol->type_name;      ref3 = symbol->var_declarations_list; return symbol;}
+    // SYM_REF3(function_block_declaration_c, fblock_name, var_declarations, fblock_body, ...)
+    void *visit(function_block_declaration_c *symbol)
+      {ref1 = symbol->fblock_name;           ref2 = symbol->var_declarations; return symbol;}
+    // SYM_REF3(program_declaration_c, program_type_name, var_declarations, function_block_body, ...)
+    void *visit(program_declaration_c *symbol)
+      {ref1 = symbol->program_type_name;     ref2 = symbol->var_declarations; return symbol;}
+};
+
+
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+pou_fingerprint_c::pou_fingerprint_c(symbol_c *tree_root, bool include_location_) {
+  include_location = include_location_;
+  next_index       = 0;
+  library_c *library = dynamic_cast<library_c *>(tree_root);
+  if (NULL == library) ERROR;
+  for (int i = 0; i < library->n; i++)
+    add_element(library->elements[i]);
+}
+
+
+pou_fingerprint_c::~pou_fingerprint_c(void) {}
+
+
+/* Store each library element (and each individual datatype declared inside a TYPE ... END_TYPE) under its name. */
+void pou_fingerprint_c::add_element(symbol_c *element) {
+  data_type_declaration_c *data_type_declaration = dynamic_cast<data_type_declaration_c *>(element);
+  if (NULL != data_type_declaration) {
+    list_c *type_list = dynamic_cast<list_c *>(data_type_declaration->type_declaration_list);
+    if (NULL == type_list) ERROR;
+    for (int i = 0; i < type_list->n; i++)
+      elements.insert(std::pair<std::string, symbol_c *>(get_datatype_info_c::get_id_str(type_list->elements[i]), type_list->elements[i]));
+    return;
+  }
+  if (   (NULL != dynamic_cast<function_declaration_c       *>(element))
+      || (NULL != dynamic_cast<function_block_declaration_c *>(element))
+      || (NULL != dynamic_cast<program_declaration_c        *>(element)))
+    elements.insert(std::pair<std::string, symbol_c *>(get_datatype_info_c::get_id_str(element), element));
+  /* configurations and pragmas are never referenced by other library elements */
+}
+
+
+pou_fingerprint_c::hash_t &pou_fingerprint_c::get_full_hash(symbol_c *element) {
+  std::map<symbol_c *, hash_t>::iterator iter = full_hash.find(element);
+  if (iter != full_hash.end()) return iter->second;
+
+  hash_t &res = full_hash[element];
+  hash_ast_and_references_c hasher(&res.references, include_location);
+  hasher.mix(element);
+  res.text = hasher.get_hash();
+  return res;
+}
+
+
+pou_fingerprint_c::hash_t &pou_fingerprint_c::get_interface_hash(symbol_c *element) {
+  std::map<symbol_c *, hash_t>::iterator iter = interface_hash.find(element);
+  if (iter != interface_hash.end()) return iter->second;
+
+  hash_t &res = interface_hash[element];
+  hash_ast_and_references_c hasher(&res.references, include_location);
+  get_interface_c get_interface;
+  get_interface.hash(element, hasher);
+  res.text = hasher.get_hash();
+  return res;
+}
+
+
+pou_fingerprint_c::fingerprint_t pou_fingerprint_c::get_signature(symbol_c *element) {
+  std::map<symbol_c *, fingerprint_t>::iterator iter = signatures.find(element);
+  if (iter != signatures.end()) return iter->second;
+
+  next_index = 0;
+  add_signatures(element);
+  return signatures[element];
+}
+
+
+/* The library elements referenced by the signature of the element (except the element itself). */
+void pou_fingerprint_c::get_references(symbol_c *element, std::vector<symbol_c *> &references) {
+  hash_t &interface = get_interface_hash(element);
+  for (name_set_t::const_iterator name = interface.references.begin(); name != interface.references.end(); ++name) {
+    std::pair<element_map_t::iterator, element_map_t::iterator> range = elements.equal_range(*name);
+    for (element_map_t::iterator iter = range.first; iter != range.second; ++iter)
+      if (iter->second != element) references.push_back(iter->second);
+  }
+}
+
+
+/* Compute the signatures of the element and of all the elements it references, one strongly connected
+ * component (i.e. a set of elements that reference each other in a cycle) at a time, using Tarjan's algorithm.
+ *
+ * A circular reference between datatypes/POUs is an error detected elsewhere (stage3), but the signatures
+ * must nevertheless not depend on the element at which the cycle was first entered (i.e. on the order
+ * in which the fingerprints are requested). The signature of an element of a cycle therefore mixes in
+ * the hash of the whole cycle, which only depends on the interfaces of its elements and on the
+ * signatures of the elements outside the cycle they reference.
+ */
+void pou_fingerprint_c::add_signatures(symbol_c *element) {
+  unsigned int index = next_index++;
+  tarjan_index[element] = index;
+  unsigned int low   = index;
+  tarjan_stack.push_back(element);
+
+  std::vector<symbol_c *> references;
+  get_references(element, references);
+  for (size_t i = 0; i < references.size(); i++) {
+    symbol_c *ref = references[i];
+    if (signatures.find(ref) != signatures.end()) continue;  /* in an already completed component */
+    std::map<symbol_c *, unsigned int>::iterator iter = tarjan_index.find(ref);
+    if (iter == tarjan_index.end()) {
+      add_signatures(ref);
+      low = std::min(low, tarjan_low[ref]);
+    } else
+      low = std::min(low, iter->second);                     /* still on the stack */
+  }
+  tarjan_low[element] = low;
+  if (low != index) return;
+
+  /* element is the root of a component, whose elements are on the stack above it */
+  std::vector<symbol_c *>::iterator first = std::find(tarjan_stack.begin(), tarjan_stack.end(), element);
+  std::vector<symbol_c *> component(first, tarjan_stack.end());
+  tarjan_stack.erase(first, tarjan_stack.end());
+  std::set<symbol_c *> members(component.begin(), component.end());
+
+  /* the interface of each element, and the signatures of the elements outside the component it references */
+  std::map<symbol_c *, fingerprint_t> own;
+  std::vector<fingerprint_t>          sorted;
+  for (size_t i = 0; i < component.size(); i++) {
+    references.clear();
+    get_references(component[i], references);
+    fingerprint_t hash = get_interface_hash(component[i]).text;
+    for (size_t j = 0; j < references.size(); j++)
+      if (members.find(references[j]) == members.end()) hash = hash_int(hash, signatures[references[j]]);
+    own[component[i]] = hash;
+    sorted.push_back(hash);
+  }
+
+  if (1 == component.size()) {
+    signatures[element] = own[element];
+  } else {
+    std::sort(sorted.begin(), sorted.end());
+    fingerprint_t cycle = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < sorted.size(); i++) cycle = hash_int(cycle, sorted[i]);
+    for (size_t i = 0; i < component.size(); i++) signatures[component[i]] = hash_int(own[component[i]], cycle);
+  }
+  for (size_t i = 0; i < component.size(); i++) {tarjan_index.erase(component[i]); tarjan_low.erase(component[i]);}
+}
+
+
+/* Mix into the hash the signatures of all the library elements with the referenced names.
+ * Note that the references are stored in a sorted set, and the multimap keeps overloaded
+ * functions in declaration order, so the result does not depend on memory addresses.
+ */
+pou_fingerprint_c::fingerprint_t pou_fingerprint_c::mix_references(fingerprint_t hash, const name_set_t &references, symbol_c *self) {
+  for (name_set_t::const_iterator name = references.begin(); name != references.end(); ++name) {
+    std::pair<element_map_t::iterator, element_map_t::iterator> range = elements.equal_range(*name);
+    for (element_map_t::iterator iter = range.first; iter != range.second; ++iter) {
+      if (iter->second == self) continue;
+      hash = hash_int(hash, get_signature(iter->second));
+    }
+  }
+  return hash;
+}
+
+
+pou_fingerprint_c::fingerprint_t pou_fingerprint_c::get(symbol_c *library_element) {
+  hash_t &full = get_full_hash(library_element);
+  return mix_references(full.text, full.references, library_element);
+}
@@ -0,0 +1,107 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+/*
+ *  Compute a stable fingerprint for each element of a library (POUs and datatype declarations).
+ *
+ *  The fingerprint of a library element covers:
+ *    - the abstract syntax tree of the element itself (class of each node and the text of each token),
+ *    - the constant values determined by stage 3 for each node of the element (which may depend on
+ *      VAR_GLOBAL CONSTANT variables declared outside the element, e.g. through a VAR_EXTERNAL CONSTANT),
+ *    - the 'signature' of every other library element it references (directly or indirectly).
+ *
+ *  The signature of a datatype is its complete declaration. The signature of a Function, FB or Program
+ *  is its name, return type and variable declarations (i.e. everything that may change the C code
+ *  generated for a POU that calls/instantiates it), but not its body.
+ *  Elements whose signatures reference each other in a cycle (an error, reported by stage 3) share
+ *  the hash of the whole cycle.
+ *
+ *  The fingerprint does not depend on memory addresses, nor on the order in which the library elements
+ *  were declared, so it remains the same between different runs of the compiler as long as the source
+ *  code of the element and of all the elements it references (and the value of the global constants
+ *  they use) does not change.
+ *
+ *  If the source code location should also be taken into account (e.g. when generating #line directives),
+ *  set include_location to true.
+ */
+
+
+#ifndef _POU_FINGERPRINT_HH
+#define _POU_FINGERPRINT_HH
+
+#include <map>
+#include <set>
+#include <vector>
+#include <string>
+#include "absyntax_utils.hh"
+
+
+class pou_fingerprint_c {
+  public:
+    typedef uint64_t fingerprint_t;
+
+  public:
+     pou_fingerprint_c(symbol_c *tree_root, bool include_location = false);
+    ~pou_fingerprint_c(void);
+
+    /* Returns the fingerprint of a library element (Function, FB, Program, Configuration, or datatype declaration). */
+    fingerprint_t get(symbol_c *library_element);
+
+  private:
+    typedef std::set<std::string, nocasecmp_c>                          name_set_t;
+    typedef std::multimap<std::string, symbol_c *, nocasecmp_c>         element_map_t;
+
+    typedef struct {
+      fingerprint_t text;        // hash of the AST of the element (or of its interface, for signatures)
+      name_set_t    references;  // names of library elements referenced
+    } hash_t;
+
+    bool                                  include_location;
+    element_map_t                         elements;        // all library elements, indexed by name
+    std::map<symbol_c *, hash_t>          full_hash;       // cache: hash of the complete element
+    std::map<symbol_c *, hash_t>          interface_hash;  // cache: hash of the element's signature
+    std::map<symbol_c *, fingerprint_t>   signatures;      // cache: signature, including the signatures of referenced elements
+    std::map<symbol_c *, unsigned int>    tarjan_index;    // elements whose signature is currently being computed (see add_signatures())
+    std::map<symbol_c *, unsigned int>    tarjan_low;
+    std::vector<symbol_c *>               tarjan_stack;
+    unsigned int                          next_index;
+
+    void           add_element(symbol_c *element);
+    hash_t        &get_full_hash(symbol_c *element);
+    hash_t        &get_interface_hash(symbol_c *element);
+    fingerprint_t  get_signature(symbol_c *element);
+    void           get_references(symbol_c *element, std::vector<symbol_c *> &references);
+    void           add_signatures(symbol_c *element);
+    fingerprint_t  mix_references(fingerprint_t hash, const name_set_t &references, symbol_c *self);
+};
+
+
+#endif /* _POU_FINGERPRINT_HH */
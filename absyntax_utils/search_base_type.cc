@@ -52,6 +52,9 @@
 /* pointer to singleton instance */
 search_base_type_c *search_base_type_c::search_base_type_singleton = NULL;
 
+search_base_type_c::resolution_cache_t search_base_type_c::resolution_cache;
+bool                                   search_base_type_c::resolution_cache_enabled = false;
+
 
 
 search_base_type_c::search_base_type_c(void) {current_basetype_name = NULL; current_basetype = NULL; current_equivtype = NULL;}
@@ -62,6 +65,12 @@ void search_base_type_c::create_singleton(void) {
   if (NULL == search_base_type_singleton)   ERROR;
 }
 
+/* static method! */
+void search_base_type_c::enable_cache(void) {
+  resolution_cache.clear();
+  resolution_cache_enabled = true;
+}
+
 /* static method! */
 symbol_c *search_base_type_c::get_equivtype_decl(symbol_c *symbol) {
   create_singleton();
@@ -108,6 +117,30 @@ symbol_c *search_base_type_c::get_basetype_id  (symbol_c *symbol) {
 
 
 void *search_base_type_c::handle_datatype_identifier(token_c *type_name) {
+  /* The resolution of a datatype identifier depends only on the name of the datatype, except when it is
+   * reached with current_equivtype already set (e.g. TYPE sub2_t : sub_t := 5; END_TYPE, with sub_t a subrange).
+   * In that case it is not cached, as the subrange visitors only set current_equivtype if it is still NULL.
+   */
+  if (!resolution_cache_enabled || (NULL != this->current_equivtype))
+    return resolve_datatype_identifier(type_name);
+
+  resolution_cache_t::iterator iter = resolution_cache.find(type_name->value);
+  if (iter == resolution_cache.end()) {
+    resolution_t resolution;
+    resolution.basetype_decl = resolve_datatype_identifier(type_name);
+    resolution.basetype_name = this->current_basetype_name;
+    resolution.basetype      = this->current_basetype;
+    resolution.equivtype     = this->current_equivtype;
+    iter = resolution_cache.insert(std::make_pair(std::string(type_name->value), resolution)).first;
+  }
+  this->current_basetype_name = iter->second.basetype_name;
+  this->current_basetype      = iter->second.basetype;
+  this->current_equivtype     = iter->second.equivtype;
+  return iter->second.basetype_decl;
+}
+
+
+void *search_base_type_c::resolve_datatype_identifier(token_c *type_name) {
   this->current_basetype_name = type_name;
   /* if we have reached this point, it is because the current_basetype is not yet pointing to the base datatype we are looking for,
    * so we will be searching for the delcaration of the type named in type_name, which might be the base datatype (we search recursively!)
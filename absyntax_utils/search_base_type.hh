@@ -71,13 +71,31 @@ class search_base_type_c: public null_visitor_c {
     symbol_c *current_basetype;
     symbol_c *current_equivtype;
     static search_base_type_c *search_base_type_singleton; // Make this a singleton class!
+
+    /* The resolution of each datatype identifier (e.g. the 'a' in TYPE a : b; b : c; ... END_TYPE) is
+     * cached, so long chains of derived datatypes are only followed once. The cache is keyed by the
+     * (case insensitive) name of the datatype, and only used once all datatypes have been
+     * inserted into the type symbol tables (i.e. after absyntax_utils_init()).
+     */
+    typedef struct {
+      void     *basetype_decl;
+      symbol_c *basetype_name;
+      symbol_c *basetype;
+      symbol_c *equivtype;
+    } resolution_t;
+    typedef std::map<std::string, resolution_t, nocasecmp_c> resolution_cache_t;
+    static resolution_cache_t resolution_cache;
+    static bool               resolution_cache_enabled;
     
   private:  
     static void create_singleton(void);
     void *handle_datatype_identifier(token_c *type_name);
+    void *resolve_datatype_identifier(token_c *type_name);
 
   public:
     search_base_type_c(void);
+    /* Start (or restart) caching the resolution of datatype identifiers. Called by absyntax_utils_init(). */
+    static void enable_cache(void);
     static symbol_c *get_equivtype_decl(symbol_c *symbol);  /* get the Equivalent Type declaration */
     static symbol_c *get_basetype_decl (symbol_c *symbol);  /* get the Base       Type declaration */
     static symbol_c *get_basetype_id   (symbol_c *symbol);  /* get the Base       Type identifier  */
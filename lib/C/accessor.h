@@ -47,6 +47,12 @@
 	type* name;
 #define __DECLARE_LOCATED(type, name)\
 	__IEC_##type##_p name;
+/* VAR CONSTANT variables of a FB or PROGRAM, and VAR_GLOBAL CONSTANT variables of a CONFIGURATION or
+ * RESOURCE, stored in const objects (declared in a header file, and defined once in a C file) */
+#define __DECLARE_CONST(type, domain, name)\
+	extern const type __CONST_##domain##__##name;
+#define __DEFINE_CONST(type, domain, name, ...)\
+	const type __CONST_##domain##__##name = __VA_ARGS__;
 
 
 // variable initialization macros
@@ -92,6 +98,8 @@
 	__GET_VAR(((*name) __VA_ARGS__))
 #define __GET_LOCATED(name, ...)\
 	((name.flags & __IEC_FORCE_FLAG) ? name.fvalue __VA_ARGS__ : (*(name.value)) __VA_ARGS__)
+#define __GET_CONST(pou, name, ...)\
+	__CONST_##pou##__##name __VA_ARGS__
 
 #define __GET_VAR_BY_REF(name, ...)\
 	((name.flags & __IEC_FORCE_FLAG) ? &(name.fvalue __VA_ARGS__) : &(name.value __VA_ARGS__))
@@ -101,6 +109,8 @@
 	__GET_EXTERNAL_BY_REF(((*name) __VA_ARGS__))
 #define __GET_LOCATED_BY_REF(name, ...)\
 	((name.flags & __IEC_FORCE_FLAG) ? &(name.fvalue __VA_ARGS__) : &((*(name.value)) __VA_ARGS__))
+#define __GET_CONST_BY_REF(pou, name, ...)\
+	(&(__CONST_##pou##__##name __VA_ARGS__))
 
 #define __GET_VAR_REF(name, ...)\
 	(&(name.value __VA_ARGS__))
@@ -110,6 +120,8 @@
 	(&(__GET_VAR(((*name) __VA_ARGS__))))
 #define __GET_LOCATED_REF(name, ...)\
 	(&((*(name.value)) __VA_ARGS__))
+#define __GET_CONST_REF(pou, name, ...)\
+	(&(__CONST_##pou##__##name __VA_ARGS__))
 
 #define __GET_VAR_DREF(name, ...)\
 	(*(name.value __VA_ARGS__))
@@ -119,6 +131,8 @@
 	(*(__GET_VAR(((*name) __VA_ARGS__))))
 #define __GET_LOCATED_DREF(name, ...)\
 	(*((*(name.value)) __VA_ARGS__))
+#define __GET_CONST_DREF(pou, name, ...)\
+	(*(__CONST_##pou##__##name __VA_ARGS__))
 
 
 // variable setting macros
@@ -0,0 +1,110 @@
+/*
+ * copyright 2014 Mario de Sousa (msousa@fe.up.pt)
+ *
+ * Offered to the public under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser
+ * General Public License for more details.
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/****
+ * Execution time counters of the POU instances.
+ *
+ * Used by the C code generated by iec2c with the '-O t' option.
+ * Each FUNCTION_BLOCK and PROGRAM data structure then contains a __profile
+ * member (of type __IEC_PROFILE_t), updated every time the FB body is executed
+ * (or, for a PROGRAM, every time it is invoked by its RESOURCE).
+ *
+ * The times are measured in the units of __PROFILE_NOW():
+ *   - nanoseconds, read from CLOCK_MONOTONIC_RAW (or CLOCK_MONOTONIC when not available), or
+ *   - CPU time stamp counter ticks, when the generated C code is compiled with
+ *     __IEC_PROFILE_USE_TSC defined (x86 only). Much cheaper to read, but the tick
+ *     rate depends on the CPU.
+ *
+ * Runtime API (provided by the generated code of the CONFIGURATION):
+ *   config_profile_entry__(n) returns the counters of the n'th POU instance (or NULL
+ *                             if there are less than n+1 instances), together
+ *                             with its name (e.g. "RES1.INSTANCE0.TON1")
+ *   config_profile_reset__()  resets the counters of all POU instances
+ */
+
+#ifndef _IEC_PROFILE_H
+#define _IEC_PROFILE_H
+
+#include <stddef.h>
+#include <time.h>
+
+typedef struct {
+  unsigned long long count; /* number of executions */
+  unsigned long long total; /* sum of the execution times */
+  unsigned long long max;   /* longest execution time */
+  unsigned long long last;  /* execution time of the last execution */
+} __IEC_PROFILE_t;
+
+typedef struct {
+  const char      *name;
+  __IEC_PROFILE_t *profile;
+} __IEC_PROFILE_ENTRY_t;
+
+
+#if defined(__IEC_PROFILE_USE_TSC) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define __PROFILE_NOW() ((unsigned long long)__rdtsc())
+#else
+static inline unsigned long long __profile_now(void) {
+  struct timespec ts;
+#ifdef CLOCK_MONOTONIC_RAW
+  clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+#else
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#define __PROFILE_NOW() __profile_now()
+#endif
+
+
+#define __PROFILE_INIT(profile)\
+	(profile).count = (profile).total = (profile).max = (profile).last = 0;
+#define __PROFILE_START(start)\
+	start = __PROFILE_NOW();
+#define __PROFILE_STOP(profile, start)\
+	{\
+		unsigned long long __elapsed = __PROFILE_NOW() - (start);\
+		(profile).count++;\
+		(profile).total += __elapsed;\
+		(profile).last   = __elapsed;\
+		if (__elapsed > (profile).max) (profile).max = __elapsed;\
+	}
+
+
+/* Helpers for the runtime API. 'tables' is a NULL terminated list of the
+ * tables of each RESOURCE, each one terminated by an entry with a NULL name.
+ */
+static inline __IEC_PROFILE_ENTRY_t *__profile_entry(__IEC_PROFILE_ENTRY_t **tables, unsigned int n) {
+  __IEC_PROFILE_ENTRY_t *entry;
+  for (; *tables != NULL; tables++)
+    for (entry = *tables; entry->name != NULL; entry++)
+      if (n-- == 0) return entry;
+  return NULL;
+}
+
+static inline void __profile_reset(__IEC_PROFILE_ENTRY_t **tables) {
+  __IEC_PROFILE_ENTRY_t *entry;
+  for (; *tables != NULL; tables++)
+    for (entry = *tables; entry->name != NULL; entry++)
+      __PROFILE_INIT(*(entry->profile))
+}
+
+
+__IEC_PROFILE_ENTRY_t *config_profile_entry__(unsigned int n);
+void config_profile_reset__(void);
+
+#endif /* _IEC_PROFILE_H */
@@ -73,6 +73,16 @@
 #include <stdlib.h>
 #include <stdarg.h>
 #include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <ctype.h>
+#include <errno.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
 
 
 #include "config/config.h"
@@ -82,6 +92,7 @@
 #include "stage3/stage3.hh"
 #include "stage4/stage4.hh"
 #include "main.hh"
+#include "stats.hh"
 
 
 #ifndef HGVERSION
@@ -128,6 +139,16 @@ static void printusage(const char *cmd) {
   printf(" -O : options for output (code generation) stage. Available options for %s are...\n", cmd);
   runtime_options.allow_missing_var_in    = false; /* disable: allow definition and invocation of POUs with no input, output and in_out parameters! */
   stage4_print_options();
+  printf(" --stats[=<file>] : print compiler statistics (time and memory used by each stage, AST size, ...)\n");
+  printf("                    in JSON format, to stderr or to <file>\n");
+  printf(" --save-ast=<file> : store the analysed abstract syntax tree (i.e. after stage 3) in <file>\n");
+  printf(" --load-ast : <input_file> is an abstract syntax tree stored with --save-ast; only run the output\n");
+  printf("              (code generation) stage. The options that change the tree (-b, -i, -e, -p, -s, -c, -n, -r, -R, -a, -l)\n");
+  printf("              must be the same as the ones used when storing the tree.\n");
+  printf(" --batch=<file> : compile each job listed in <file>. Each line lists the options and the input file\n");
+  printf("                  of one job (e.g. '-T build/prog1 prog1.st'), added to the options given on the command line\n");
+  printf("                  (--stats=<file> may then only be given for each job, inside the batch file)\n");
+  printf(" --jobs=<n> : run up to <n> jobs of the batch in parallel\n");
   printf("\n");
   printf("%s - Copyright (C) 2003-2014 \n"
          "This program comes with ABSOLUTELY NO WARRANTY!\n"
@@ -139,40 +160,50 @@ static void printusage(const char *cmd) {
 runtime_options_t runtime_options;
 
 
-int main(int argc, char **argv) {
-  symbol_c *tree_root, *ordered_tree_root;
-  char * builddir = NULL;
+/* long command line options (i.e. options with no single character equivalent) */
+enum {STATS_OPT = 256, SAVE_AST_OPT, LOAD_AST_OPT, BATCH_OPT, JOBS_OPT};
+
+static const struct option long_options[] = {
+  {"stats",    optional_argument, NULL, STATS_OPT   },
+  {"save-ast", required_argument, NULL, SAVE_AST_OPT},
+  {"load-ast", no_argument,       NULL, LOAD_AST_OPT},
+  {"batch",    required_argument, NULL, BATCH_OPT   },
+  {"jobs",     required_argument, NULL, JOBS_OPT    },
+  {NULL,       0,                 NULL, 0           }
+};
+
+
+/* A single compilation: the input file, and what to do with it */
+typedef struct {
+  char *input_file;
+  char *builddir; /* directory in which to place the output files (-T) */
+  char *save_ast; /* file in which to store the AST, after stage 3 */
+  bool  load_ast; /* the input file is an AST stored with --save-ast */
+} job_t;
+
+/* Batch mode: the file listing the jobs, and how many of them to run in parallel */
+typedef struct {
+  char *file;
+  int   workers;
+} batch_t;
+
+
+/* Parse the command line options (or the options of a job in the batch file, in which case batch is NULL).
+ * Returns 0 if the compiler should be run, 1 if it should exit successfully (e.g. -h), or -1 on error.
+ */
+static int parse_options(int argc, char **argv, job_t *job, batch_t *batch) {
   int optres, errflg = 0;
   int path_len;
+  const char *stats_file = NULL;
 
-  /* Default values for the command line options... */
-  runtime_options.allow_void_datatype     = false; /* disable: allow declaration of functions returning VOID  */
-  runtime_options.allow_missing_var_in    = false; /* disable: allow definition and invocation of POUs with no input, output and in_out parameters! */
-  runtime_options.disable_implicit_en_eno = false; /* disable: do not generate EN and ENO parameters */
-  runtime_options.pre_parsing             = false; /* disable: allow use of forward references (run pre-parsing phase before the definitive parsing phase that builds the AST) */
-  runtime_options.safe_extensions         = false; /* disable: allow use of SAFExxx datatypes */
-  runtime_options.full_token_loc          = false; /* disable: error messages specify full token location */
-  runtime_options.conversion_functions    = false; /* disable: create a conversion function for derived datatype */
-  runtime_options.nested_comments         = false; /* disable: Allow the use of nested comments. */
-  runtime_options.ref_standard_extensions = false; /* disable: Allow the use of REFerences (keywords REF_TO, REF, DREF, ^, NULL). */
-  runtime_options.ref_nonstand_extensions = false; /* disable: Allow the use of non-standard extensions to REF_TO datatypes: REF_TO ANY, and REF_TO in struct elements! */
-  runtime_options.nonliteral_in_array_size= false; /* disable: Allow the use of constant non-literals when specifying size of arrays (ARRAY [1..max] OF INT) */
-  runtime_options.includedir              = NULL;  /* Include directory, where included files will be searched for... */
-
-  /* Default values for the command line options... */
-  runtime_options.relaxed_datatype_model    = false; /* by default use the strict datatype equivalence model */
-  
-  /******************************************/
-  /*   Parse command line options...        */
-  /******************************************/
-  while ((optres = getopt(argc, argv, ":nehvfplsrRabicI:T:O:")) != -1) {
+  while ((optres = getopt_long(argc, argv, ":nehvfplsrRabicI:T:O:", long_options, NULL)) != -1) {
     switch(optres) {
     case 'h':
       printusage(argv[0]);
-      return 0;
+      return 1;
     case 'v':
       fprintf(stdout, "%s version %s\n" "changeset id: %s\n", PACKAGE_NAME, PACKAGE_VERSION, HGVERSION);      
-      return 0;
+      return 1;
     case 'l': runtime_options.relaxed_datatype_model   = true;  break;
     case 'p': runtime_options.pre_parsing              = true;  break;
     case 'f': runtime_options.full_token_loc           = true;  break;
@@ -200,17 +231,36 @@ int main(int argc, char **argv) {
       /* NOTE: see note above */
       path_len = strlen(optarg) - 1;
       if (optarg[path_len] == '\\') optarg[path_len]= '\0';
-      builddir = optarg;
+      job->builddir = optarg;
       break;
     case 'O':
       if (stage4_parse_options(optarg) < 0) errflg++;
       break;
+    case STATS_OPT:
+      stats_c::enable(optarg); /* optarg is NULL if no file was specified => print to stderr */
+      stats_file = optarg;
+      break;
+    case SAVE_AST_OPT: job->save_ast = optarg; break;
+    case LOAD_AST_OPT: job->load_ast = true;   break;
+    case BATCH_OPT:
+    case JOBS_OPT:
+      if (NULL == batch) {
+        fprintf(stderr, "Option %s may not be used inside a batch file\n", argv[optind - 1]);
+        errflg++;
+      } else if (BATCH_OPT == optres) {
+        batch->file = optarg;
+      } else if ((batch->workers = atoi(optarg)) < 1) {
+        fprintf(stderr, "Invalid number of jobs: %s\n", optarg);
+        errflg++;
+      }
+      break;
     case ':':       /* -I, -T, or -O without operand */
       fprintf(stderr, "Option -%c requires an operand\n", optopt);
       errflg++;
       break;
     case '?':
-      fprintf(stderr, "Unrecognized option: -%c\n", optopt);
+      if (optopt == 0) fprintf(stderr, "Unrecognized option: %s\n", argv[optind - 1]); /* a long option */
+      else             fprintf(stderr, "Unrecognized option: -%c\n", optopt);
       errflg++;
       break;
     default:
@@ -220,48 +270,238 @@ int main(int argc, char **argv) {
     }
   }
 
-  if (optind == argc) {
+  job->input_file = (optind < argc)? argv[optind] : NULL;
+
+  if ((NULL == job->input_file) && ((NULL == batch) || (NULL == batch->file))) {
     fprintf(stderr, "Missing input file\n");
     errflg++;
   }
 
+  if ((NULL != job->input_file) && (NULL != batch) && (NULL != batch->file)) {
+    fprintf(stderr, "No input file may be given together with a batch file\n");
+    errflg++;
+  }
+
+  /* every job would write its statistics to the same file (possibly at the same time) */
+  if ((NULL != stats_file) && (NULL != batch) && (NULL != batch->file)) {
+    fprintf(stderr, "Option --stats=<file> may not be used together with a batch file (it may be given for each job inside the batch file)\n");
+    errflg++;
+  }
+
   if (optind > argc) {
     fprintf(stderr, "Too many input files\n");
     errflg++;
   }
 
-  if (errflg) {
-    printusage(argv[0]);
-    return EXIT_FAILURE;
-  }
+  return (errflg)? -1 : 0;
+}
 
 
-  /***************************/
-  /*   Run the compiler...   */
-  /***************************/
-  /* 1st Pass */
-  if (stage1_2(argv[optind], &tree_root) < 0)
-    return EXIT_FAILURE;
 
-  /* 2nd Pass */
-    /* basically loads some symbol tables to speed up look ups later on */
-  absyntax_utils_init(tree_root);  
-    /* moved to bison, although it could perfectly well still be here instead of in bison code. */
-  //add_en_eno_param_decl_c::add_to(tree_root);
+/***************************/
+/*   Run the compiler...   */
+/***************************/
+static int compile(job_t *job) {
+  symbol_c *tree_root, *ordered_tree_root;
 
-  /* Do semantic verification of code */
-  if (stage3(tree_root, &ordered_tree_root) < 0)
-    return EXIT_FAILURE;
+  if (job->load_ast) {
+    /* stages 1_2 and 3 have already been run on the stored AST */
+    { stats_timer_c timer("load_ast");
+      if (NULL == (ordered_tree_root = ast_serialize_c::load(job->input_file)))
+        {stats_c::print(); return EXIT_FAILURE;}
+    }
+    stats_c::count_ast_nodes("ast_nodes", ordered_tree_root);
+
+    { stats_timer_c timer("absyntax_utils_init");
+      absyntax_utils_init(ordered_tree_root);  
+    }
+  } else {
+    /* 1st Pass */
+    { stats_timer_c timer("stage1_2");
+      if (stage1_2(job->input_file, &tree_root) < 0)
+        {stats_c::print(); return EXIT_FAILURE;}
+    }
+    stats_c::count_ast_nodes("ast_nodes", tree_root);
+
+    /* 2nd Pass */
+      /* basically loads some symbol tables to speed up look ups later on */
+    { stats_timer_c timer("absyntax_utils_init");
+      absyntax_utils_init(tree_root);  
+    }
+      /* moved to bison, although it could perfectly well still be here instead of in bison code. */
+    //add_en_eno_param_decl_c::add_to(tree_root);
+
+    /* Do semantic verification of code */
+    { stats_timer_c timer("stage3");
+      if (stage3(tree_root, &ordered_tree_root) < 0)
+        {stats_c::print(); return EXIT_FAILURE;}
+    }
+
+    if (NULL != job->save_ast) {
+      stats_timer_c timer("save_ast");
+      if (ast_serialize_c::save(ordered_tree_root, job->save_ast) < 0)
+        {stats_c::print(); return EXIT_FAILURE;}
+    }
+  }
   
   /* 3rd Pass */
-  if (stage4(ordered_tree_root, builddir) < 0)
-    return EXIT_FAILURE;
+  { stats_timer_c timer("stage4");
+    if (stage4(ordered_tree_root, job->builddir) < 0)
+      {stats_c::print(); return EXIT_FAILURE;}
+  }
 
   /* 4th Pass */
   /* Call gcc, g++, or whatever... */
   /* Currently implemented in the Makefile! */
 
+  if (stats_c::print() < 0)
+    return EXIT_FAILURE;
   return 0;
 }
 
 
+
+/******************/
+/*   Batch mode   */
+/******************/
+/* Each (non empty) line of the batch file lists the options and the input file of one job, e.g.
+ *     -T build/prog1 -p prog1.st
+ *     # comment
+ *     -T "build/prog 2" -O l "prog 2.st"
+ * Arguments are separated by white space, and may be enclosed in double quotes.
+ * The options given on the command line apply to all jobs (the options of each job are added to them).
+ *
+ * Each job is compiled in a child process (fork()) of iec2c. The child starts off with the state
+ * of iec2c just after parsing the command line and the standard library (ieclib.txt), which iec2c
+ * parses once, before starting the jobs. So no other global state (symbol tables, runtime_options,
+ * include file stack, ...) is carried over from one job to the next, and the jobs share the AST of the
+ * standard library (copy-on-write), instead of each parsing it all over again.
+ * NOTE: a job whose own options change the AST of the library (e.g. -e, -s, -I) parses it again.
+ */
+static std::vector<std::string> split_job_line(const std::string &line) {
+  std::vector<std::string> args;
+  size_t i = 0;
+  while (true) {
+    while ((i < line.size()) && isspace((unsigned char)line[i])) i++;
+    if ((i >= line.size()) || (line[i] == '#')) return args;
+    std::string arg;
+    bool quoted = false;
+    for (; (i < line.size()) && (quoted || !isspace((unsigned char)line[i])); i++) {
+      if (line[i] == '"') quoted = !quoted;
+      else                arg.push_back(line[i]);
+    }
+    args.push_back(arg);
+  }
+}
+
+
+#ifndef _WIN32
+static int run_job(char *cmd, const std::vector<std::string> &args, job_t job) {
+  std::vector<char *> argv(1, cmd);
+  for (size_t i = 0; i < args.size(); i++) argv.push_back(strdup(args[i].c_str()));
+  argv.push_back(NULL);
+
+  optind = 0; /* restart the scanning of options */
+  int res = parse_options(argv.size() - 1, &argv[0], &job, NULL);
+  if (res != 0) return (res > 0)? EXIT_SUCCESS : EXIT_FAILURE;
+  return compile(&job);
+}
+#endif
+
+
+static int run_batch(char *cmd, const batch_t *batch, const job_t *job) {
+#ifdef _WIN32
+  fprintf(stderr, "Batch mode is not supported on this platform\n");
+  return EXIT_FAILURE;
+#else
+  std::ifstream file(batch->file);
+  if (!file) {
+    fprintf(stderr, "Could not open batch file %s: %s\n", batch->file, strerror(errno));
+    return EXIT_FAILURE;
+  }
+  std::vector<std::vector<std::string> > jobs;
+  std::vector<int>                       lines; /* line of the batch file of each job */
+  std::string line;
+  for (int line_no = 1; std::getline(file, line); line_no++) {
+    std::vector<std::string> args = split_job_line(line);
+    if (args.empty()) continue;
+    jobs .push_back(args);
+    lines.push_back(line_no);
+  }
+
+  if (stage1_2_library() < 0) return EXIT_FAILURE;
+
+  std::map<pid_t, size_t> running; /* the job being run by each child process */
+  size_t next = 0;
+  int failed = 0;
+  while ((next < jobs.size()) || !running.empty()) {
+    if ((next < jobs.size()) && ((int)running.size() < batch->workers)) {
+      fflush(stdout); fflush(stderr); /* otherwise anything still buffered would also be printed by the child */
+      pid_t pid = fork();
+      if (0 == pid) exit(run_job(cmd, jobs[next], *job));
+      if (pid < 0) {
+        fprintf(stderr, "%s:%d: could not start job: %s\n", batch->file, lines[next], strerror(errno));
+        failed++;
+      } else {
+        running[pid] = next;
+      }
+      next++;
+      continue;
+    }
+    int   status;
+    pid_t pid = wait(&status);
+    if (pid < 0) ERROR_MSG("lost track of the batch jobs");
+    std::map<pid_t, size_t>::iterator iter = running.find(pid);
+    if (iter == running.end()) continue;
+    if (!WIFEXITED(status) || (EXIT_SUCCESS != WEXITSTATUS(status))) {
+      fprintf(stderr, "%s:%d: job failed\n", batch->file, lines[iter->second]);
+      failed++;
+    }
+    running.erase(iter);
+  }
+
+  if (failed > 0) {
+    fprintf(stderr, "%d of %d jobs failed\n", failed, (int)jobs.size());
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+#endif
+}
+
+
+
+int main(int argc, char **argv) {
+  job_t   job   = {NULL, NULL, NULL, false};
+  batch_t batch = {NULL, 1};
+  int     res;
+
+  /* Default values for the command line options... */
+  runtime_options.allow_void_datatype     = false; /* disable: allow declaration of functions returning VOID  */
+  runtime_options.allow_missing_var_in    = false; /* disable: allow definition and invocation of POUs with no input, output and in_out parameters! */
+  runtime_options.disable_implicit_en_eno = false; /* disable: do not generate EN and ENO parameters */
+  runtime_options.pre_parsing             = false; /* disable: allow use of forward references (run pre-parsing phase before the definitive parsing phase that builds the AST) */
+  runtime_options.safe_extensions         = false; /* disable: allow use of SAFExxx datatypes */
+  runtime_options.full_token_loc          = false; /* disable: error messages specify full token location */
+  runtime_options.conversion_functions    = false; /* disable: create a conversion function for derived datatype */
+  runtime_options.nested_comments         = false; /* disable: Allow the use of nested comments. */
+  runtime_options.ref_standard_extensions = false; /* disable: Allow the use of REFerences (keywords REF_TO, REF, DREF, ^, NULL). */
+  runtime_options.ref_nonstand_extensions = false; /* disable: Allow the use of non-standard extensions to REF_TO datatypes: REF_TO ANY, and REF_TO in struct elements! */
+  runtime_options.nonliteral_in_array_size= false; /* disable: Allow the use of constant non-literals when specifying size of arrays (ARRAY [1..max] OF INT) */
+  runtime_options.includedir              = NULL;  /* Include directory, where included files will be searched for... */
+
+  /* Default values for the command line options... */
+  runtime_options.relaxed_datatype_model    = false; /* by default use the strict datatype equivalence model */
+  
+  /******************************************/
+  /*   Parse command line options...        */
+  /******************************************/
+  if ((res = parse_options(argc, argv, &job, &batch)) != 0) {
+    if (res > 0) return 0;
+    printusage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if (NULL != batch.file)
+    return run_batch(argv[0], &batch, &job);
+  return compile(&job);
+}
@@ -162,6 +162,7 @@ void yyerror (const char *error_msg);
 
 
 #include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
+#include "../stats.hh"  // required for stats_timer_c
 
 
 
@@ -8743,8 +8744,11 @@ NULL
 extern const char *INCLUDE_DIRECTORIES[];
 
 
-static int parse_files(const char *libfilename, const char *filename) {
-  /* first parse the standard library file... */  
+static int parse_library(const char *libfilename, const char *timer_name) {
+  stats_timer_c *timer = NULL;
+
+  /* parse the standard library file... */  
+  timer = new stats_timer_c(timer_name);
   /*   Do not debug the standard library, even if debug flag is set!
   #if YYDEBUG
     yydebug = 1;
@@ -8755,6 +8759,7 @@ static int parse_files(const char *libfilename, const char *filename) {
     char *errmsg = strdup2("Error opening library file ", libfilename);
     perror(errmsg);
     free(errmsg);
+    delete timer;
     /* we give up... */
     return -1;
   }
@@ -8773,6 +8778,7 @@ static int parse_files(const char *libfilename, const char *filename) {
   if (yynerrs > 0) {  /* NOTE: yynerrs is a global variable */
     /* Hopefully the libraries do not contain any errors, so this should not occur! */
     fprintf (stderr, "\n%d error(s) found in %s. Bailing out!\n", yynerrs, libfilename);
+    delete timer;
     return -2;
   }
 
@@ -8781,8 +8787,24 @@ static int parse_files(const char *libfilename, const char *filename) {
     if (library_element_symtable.find(standard_function_block_names[i]) ==
         library_element_symtable.end())
       library_element_symtable.insert(standard_function_block_names[i], standard_function_block_name_token);
+  delete timer;
+
+  return 0;
+}
+
+
+/* Parse the standard library file (unless libfilename is NULL, when it has already been parsed), and then the input file */
+static int parse_files(const char *libfilename, const char *filename) {
+  stats_timer_c *timer = NULL;
+  int res;
+
+  /* first parse the standard library file... */  
+  if (NULL != libfilename)
+    if ((res = parse_library(libfilename, get_preparse_state()? "stage1_2/preparse/library" : "stage1_2/parse/library")) < 0)
+      return res;
 
   /* now parse the input file... */
+  timer = new stats_timer_c(get_preparse_state()? "stage1_2/preparse/main_file" : "stage1_2/parse/main_file");
   #if YYDEBUG
     yydebug = 1;
   #endif
@@ -8791,6 +8813,7 @@ static int parse_files(const char *libfilename, const char *filename) {
     char *errmsg = strdup2("Error opening main file ", filename);
     perror(errmsg);
     free(errmsg);
+    delete timer;
     return -3;
   }
 
@@ -8811,6 +8834,7 @@ static int parse_files(const char *libfilename, const char *filename) {
     fprintf (stderr, "\n%d error(s) found. Bailing out!\n", yynerrs /* global variable */);
     exit(EXIT_FAILURE);
   }
+  delete timer;
 
   return 0;
 }  
@@ -8848,12 +8872,10 @@ static int parse_files(const char *libfilename, const char *filename) {
  *  datatypes will also already be in the library_element_symtable!
  */
 
-int stage2__(const char *filename, 
-             symbol_c **tree_root_ref
-            ) {             
+/* Determine the full path name of the standard library file... */
+static char *library_filename(void) {
   char *libfilename = NULL;
 
-  /* Determine the full path name of the standard library file... */
   if (runtime_options.includedir != NULL)
     INCLUDE_DIRECTORIES[0] = runtime_options.includedir;
 
@@ -8861,6 +8883,73 @@ int stage2__(const char *filename,
     fprintf (stderr, "Out of memory. Bailing out!\n");
     exit(EXIT_FAILURE);
   }
+  return libfilename;
+}
+
+
+/* The standard library, when it has been parsed in advance by stage2_library__(), and the
+ * runtime options it was parsed with (these change the AST of the library, e.g. the implicit
+ * EN/ENO parameters, and the include directory determines which library file is parsed).
+ */
+static symbol_c          *library_tree_root = NULL;
+static runtime_options_t  library_options;
+
+static bool same_library_options(void) {
+  const runtime_options_t &a = library_options, &b = runtime_options;
+  return    (a.allow_void_datatype      == b.allow_void_datatype)
+         && (a.allow_missing_var_in     == b.allow_missing_var_in)
+         && (a.disable_implicit_en_eno  == b.disable_implicit_en_eno)
+         && (a.safe_extensions          == b.safe_extensions)
+         && (a.full_token_loc           == b.full_token_loc)
+         && (a.conversion_functions     == b.conversion_functions)
+         && (a.nested_comments          == b.nested_comments)
+         && (a.ref_standard_extensions  == b.ref_standard_extensions)
+         && (a.ref_nonstand_extensions  == b.ref_nonstand_extensions)
+         && (a.nonliteral_in_array_size == b.nonliteral_in_array_size)
+         && ((a.includedir == b.includedir) || ((NULL != a.includedir) && (NULL != b.includedir) && (0 == strcmp(a.includedir, b.includedir))));
+}
+
+
+/* Parse the standard library in advance, so that stage2__() only needs to parse the input file.
+ * Used by the batch mode (see main.cc), before it forks a child process for each job: every job
+ * then starts off with the AST and the library_element_symtable of the already parsed library
+ * (shared with the parent process, until modified).
+ * NOTE: the AST of the library is extended with the POUs of the input file, so stage2__() may only be
+ *       called once after stage2_library__() in each process.
+ */
+int stage2_library__(void) {
+  char *libfilename = library_filename();
+
+  tree_root = NULL;
+  rst_preparse_state();
+  int res = parse_library(libfilename, "stage1_2/parse/library_in_advance");
+  free(libfilename);
+  if (res < 0) return res;
+
+  library_tree_root = tree_root;
+  library_options   = runtime_options;
+  return 0;
+}
+
+
+int stage2__(const char *filename, 
+             symbol_c **tree_root_ref
+            ) {             
+  char *libfilename = library_filename();
+
+  /* The library parsed in advance is only used if the options that change its AST are the same, in which
+   * case neither the pre-parsing run nor the normal parsing run parse the library again (the
+   * library_element_symtable already has the names of the library elements).
+   * Otherwise the library is parsed as usual, starting off with an empty library_element_symtable.
+   */
+  symbol_c *library = NULL;
+  if ((NULL != library_tree_root) && same_library_options()) {
+    library = library_tree_root;
+    free(libfilename);
+    libfilename = NULL;
+  } else if (NULL != library_tree_root) {
+    library_element_symtable.clear();
+  }
 
   /*******************************/
   /* Do the  PRE parsing run...! */
@@ -8877,12 +8966,16 @@ int stage2__(const char *filename,
   /* Do the main parsing run...! */
   /*******************************/
   // fprintf (stderr, "----> Starting normal parsing!\n");
-  tree_root = NULL;
+  tree_root = library;
   rst_preparse_state();
   if (parse_files(libfilename, filename) < 0)
     exit(EXIT_FAILURE);
   
 
+  stats_c::set_counter("symtables", "library_element_symtable", library_element_symtable.size());
+  stats_c::set_counter("symtables", "variable_name_symtable",   variable_name_symtable.size());
+  stats_c::set_counter("symtables", "direct_variable_symtable", direct_variable_symtable.size());
+
   /* Final clean-up... */
   free(libfilename);
   if (tree_root_ref != NULL)
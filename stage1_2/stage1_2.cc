@@ -249,3 +249,10 @@ int stage1_2(const char *filename, symbol_c **tree_root_ref) {
   return stage2__(filename, tree_root_ref);
 }
 
+
+int stage2_library__(void);
+
+int stage1_2_library(void) {
+  return stage2_library__();
+}
+
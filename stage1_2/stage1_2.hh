@@ -47,6 +47,12 @@
 
 int stage1_2(const char *filename, symbol_c **tree_root);
 
+/* Parse the standard library in advance, before the batch mode forks a child process for each job.
+ * The following call to stage1_2() (in each child process) then only parses the input file, unless
+ * it is given other options that change the AST of the library.
+ */
+int stage1_2_library(void);
+
 
 
 
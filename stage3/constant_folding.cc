@@ -141,6 +141,7 @@
 #include <stdlib.h> /* required for malloc() */
 
 #include <string.h>  /* required for strlen() */
+#include <typeinfo>  /* required for typeid() */
 // #include <stdlib.h>  /* required for atoi() */
 #include <errno.h>   /* required for errno */
 
@@ -225,15 +226,14 @@
  * - any * non_const = non_const
  * - constant * constant = constant  (if equal)
  * - constant * constant = non_const (if not equal)
+ *
+ * NOTE: The values maps used by constant_propagation_c only contain the variables whose value is
+ *       known (or has been known) at that point of the code, so an 'undefined' value is never merged
+ *       with a constant. The result of the meet is stored in c1.
  */
-#define COMPUTE_MEET_SEMILATTICE(dtype, c1, c2, resValue) {\
-		if (( c1._##dtype.get()  != c2._##dtype.get() && c2._##dtype.is_valid() && c1._##dtype.is_valid()) ||\
-		    ( c1._##dtype.is_nonconst() && c2._##dtype.is_valid() ) ||\
-		    ( c2._##dtype.is_nonconst() && c1._##dtype.is_valid() )) {\
-			resValue._##dtype.set_nonconst();\
-		} else {\
-			resValue._##dtype.set(c1._##dtype.get());\
-		}\
+#define MEET_CVALUE_(dtype, c1, c2) {                                                                              \
+	if (!(c1._##dtype.is_valid() && c2._##dtype.is_valid() && (c1._##dtype.get() == c2._##dtype.get())))     \
+		c1._##dtype.set_nonconst();                                                                       \
 }
 
 
@@ -1235,41 +1235,303 @@ void *constant_folding_c::visit(   not_expression_c *symbol) {symbol->  exp->acc
 /***********************************************************************/
 
 
-constant_propagation_c::constant_propagation_c(symbol_c *symbol)
+constant_propagation_c::constant_propagation_c(symbol_c *symbol, bool propagate_variables)
   : constant_folding_c(symbol) {
     current_resource = NULL;
     current_configuration = NULL;
     fixed_init_value_ = false;
     function_pou_ = false;
     values = NULL;
+    propagate_variables_ = propagate_variables;
+    search_var_instance_decl = NULL;
+    function_body_ = false;
   }
 
 
 constant_propagation_c::~constant_propagation_c(void) {}
 
 
-static constant_propagation_c::map_values_t inner_left_join_values(constant_propagation_c::map_values_t m1, constant_propagation_c::map_values_t m2) {
-	constant_propagation_c::map_values_t::const_iterator itr;
-	constant_propagation_c::map_values_t ret;
-
-	itr = m1.begin();
-	for ( ; itr != m1.end(); ++itr) {
-		std::string name = itr->first;
-		const_value_c value;
-
-		if (m2.count(name) > 0) {
-			const_value_c c1 = itr->second;
-			const_value_c c2 = m2[name];
-			COMPUTE_MEET_SEMILATTICE (real64, c1, c2, value);
-			COMPUTE_MEET_SEMILATTICE (uint64, c1, c2, value);
-			COMPUTE_MEET_SEMILATTICE ( int64, c1, c2, value);
-			COMPUTE_MEET_SEMILATTICE (  bool, c1, c2, value);
-		} else
-			value = m1[name];
-		ret[name] = value;
+/* A const value that is not valid for any of the data types */
+static const_value_c nonconst_cvalue(void) {
+	const_value_c value;
+	value. _int64.set_nonconst();
+	value._uint64.set_nonconst();
+	value._real64.set_nonconst();
+	value.  _bool.set_nonconst();
+	return value;
+}
+
+
+/* Determine the value a variable of type 'datatype' holds (in the generated C code) after being assigned 'value'.
+ *
+ * Only BOOL, ANY_INT and ANY_BIT variables are handled. REAL and LREAL variables are not (the rounding done when 
+ * storing a value in a 32 bit float is not reproduced), and neither are TIME, STRING, enumerated, subrange, ...
+ * A value that does not fit inside the variable's data type (i.e. that would be truncated) is also not handled.
+ * In all these cases the returned value is non-const.
+ *
+ * NOTE: just like for literals, the const values of the data types that do not apply to the variable
+ *       (e.g. _real64 and _bool for an INT variable) are left undefined, and not set to non-const.
+ *       Otherwise the result of a comparison (which is computed for every data type, into the same
+ *       _bool const value) would always end up as non-const.
+ */
+static const_value_c variable_cvalue(const_value_c value, symbol_c *datatype) {
+	const_value_c res;
+	if (NULL == datatype) return nonconst_cvalue();
+
+	if (get_datatype_info_c::is_BOOL_compatible(datatype)) {
+		if (value._bool.is_valid()) res._bool.set(value._bool.get());
+		else                        res._bool.set_nonconst();
+		return res;
+	}
+
+	#define IS_TYPE_(type) ((typeid(*datatype) == typeid(get_datatype_info_c::type##_type_name)) || (typeid(*datatype) == typeid(get_datatype_info_c::safe##type##_type_name)))
+	bool     is_signed;
+	uint64_t max;
+	if      (IS_TYPE_( sint))                     {is_signed = true;  max =  INT8_MAX;}
+	else if (IS_TYPE_(  int))                     {is_signed = true;  max = INT16_MAX;}
+	else if (IS_TYPE_( dint))                     {is_signed = true;  max = INT32_MAX;}
+	else if (IS_TYPE_( lint))                     {is_signed = true;  max = INT64_MAX;}
+	else if (IS_TYPE_(usint) || IS_TYPE_( byte)) {is_signed = false; max =  UINT8_MAX;}
+	else if (IS_TYPE_( uint) || IS_TYPE_( word)) {is_signed = false; max = UINT16_MAX;}
+	else if (IS_TYPE_(udint) || IS_TYPE_(dword)) {is_signed = false; max = UINT32_MAX;}
+	else if (IS_TYPE_(ulint) || IS_TYPE_(lword)) {is_signed = false; max = UINT64_MAX;}
+	else return nonconst_cvalue();
+	#undef IS_TYPE_
+
+	res. _int64.set_nonconst();
+	res._uint64.set_nonconst();
+	if (value._uint64.is_valid()) {
+		uint64_t uvalue = value._uint64.get();
+		if (uvalue > max) return res;
+		res._uint64.set(uvalue);
+		if (uvalue <= INT64_MAX) res._int64.set(uvalue);
+	} else if (value._int64.is_valid()) {
+		int64_t ivalue = value._int64.get();
+		if (ivalue < 0) {
+			/* the minimum value of a signed type is -(max+1) */
+			if (!is_signed || (ivalue < -(int64_t)max - 1)) return res;
+		} else {
+			if ((uint64_t)ivalue > max) return res;
+			res._uint64.set(ivalue);
+		}
+		res._int64.set(ivalue);
+	}
+	return res;
+}
+
+
+/* Set the variable referenced by 'var' to non-const in the 'values' map (if it is in the map). */
+static void invalidate_variable(constant_propagation_c::map_values_t &values, symbol_c *var) {
+	token_c *var_name = get_var_name_c::get_name(var);
+	if (NULL == var_name) return;  /* not a variable (e.g. a literal, or a directly represented variable) */
+	constant_propagation_c::map_values_t::iterator itr = values.find(var_name->value);
+	if (itr != values.end()) itr->second = nonconst_cvalue();
+}
+
+
+/* Set to non-const, in the 'values' map, all the variables passed to the OUT and IN_OUT parameters of the
+ * function/FB call 'f_call' (i.e. the variables the call may change).
+ * If the called function/FB is not known, all the variables passed as parameters are set to non-const.
+ * In IL non formal function calls the first parameter is the current value (i.e. the accumulator),
+ * and is not listed in the call's operands ('implicit_first_param' must then be set to true).
+ */
+static void invalidate_call_outputs(constant_propagation_c::map_values_t &values, symbol_c *f_call, symbol_c *f_decl, bool implicit_first_param = false) {
+	symbol_c *call_param;
+	identifier_c *param_name;
+	function_call_param_iterator_c fcp_iterator(f_call);
+
+	if (NULL == f_decl) {
+		while ((call_param = fcp_iterator.next_nf()) != NULL) invalidate_variable(values, call_param);
+		fcp_iterator.reset();
+		while ((call_param = fcp_iterator.next_f())  != NULL) invalidate_variable(values, fcp_iterator.get_current_value());
+		return;
+	}
+
+	/* the non-formal parameters... */
+	function_param_iterator_c fp_iterator(f_decl);
+	bool skip_param = implicit_first_param;
+	while (skip_param || ((call_param = fcp_iterator.next_nf()) != NULL)) {
+		/* get the corresponding parameter of the function being called (ignoring EN and ENO) */
+		do {
+			param_name = fp_iterator.next();
+			if (NULL == param_name) return; /* too many parameters. This error has already been caught in data type checking */
+		} while ((strcmp(param_name->value, "EN") == 0) || (strcmp(param_name->value, "ENO") == 0));
+		if (skip_param) {skip_param = false; continue;}
+		if (   (function_param_iterator_c::direction_out   == fp_iterator.param_direction())
+		    || (function_param_iterator_c::direction_inout == fp_iterator.param_direction()))
+			invalidate_variable(values, call_param);
+	}
+
+	/* the formal parameters... */
+	fcp_iterator.reset();
+	while ((call_param = fcp_iterator.next_f()) != NULL) {
+		if (NULL == fp_iterator.search(call_param)) continue;
+		if (   (function_param_iterator_c::direction_out   == fp_iterator.param_direction())
+		    || (function_param_iterator_c::direction_inout == fp_iterator.param_direction()))
+			invalidate_variable(values, fcp_iterator.get_current_value());
+	}
+}
+
+
+
+/* Set to non-const, in a values map, all the variables that may be changed when executing some ST statements
+ * or IL instructions (assignments, FOR control variables, OUT and IN_OUT parameters of function and FB calls,
+ * IL ST/STN/S/R operators), as well as the variables whose address is taken with REF().
+ */
+class invalidate_assigned_variables_c: public iterator_visitor_c {
+  private:
+    constant_propagation_c::map_values_t &values;
+
+  public:
+    invalidate_assigned_variables_c(constant_propagation_c::map_values_t &values_map): values(values_map) {}
+
+    void *visit(il_simple_operation_c *symbol) {
+      if (   (NULL != dynamic_cast< ST_operator_c *>(symbol->il_simple_operator)) || (NULL != dynamic_cast<STN_operator_c *>(symbol->il_simple_operator))
+          || (NULL != dynamic_cast<  S_operator_c *>(symbol->il_simple_operator)) || (NULL != dynamic_cast<  R_operator_c *>(symbol->il_simple_operator)))
+        invalidate_variable(values, symbol->il_operand);
+      return iterator_visitor_c::visit(symbol);
+    }
+    void *visit(il_function_call_c     *symbol) {invalidate_call_outputs(values, symbol, symbol->called_function_declaration, true); return iterator_visitor_c::visit(symbol);}
+    void *visit(il_formal_funct_call_c *symbol) {invalidate_call_outputs(values, symbol, symbol->called_function_declaration);       return iterator_visitor_c::visit(symbol);}
+    void *visit(il_fb_call_c           *symbol) {invalidate_call_outputs(values, symbol, symbol->called_fb_declaration);             return iterator_visitor_c::visit(symbol);}
+    void *visit(function_invocation_c  *symbol) {invalidate_call_outputs(values, symbol, symbol->called_function_declaration);       return iterator_visitor_c::visit(symbol);}
+    void *visit(fb_invocation_c        *symbol) {invalidate_call_outputs(values, symbol, symbol->called_fb_declaration);             return iterator_visitor_c::visit(symbol);}
+    void *visit(ref_expression_c       *symbol) {invalidate_variable(values, symbol->exp);                                          return iterator_visitor_c::visit(symbol);}
+    void *visit(assignment_statement_c *symbol) {invalidate_variable(values, symbol->l_exp);                                        return iterator_visitor_c::visit(symbol);}
+    void *visit(for_statement_c        *symbol) {invalidate_variable(values, symbol->control_variable);                             return iterator_visitor_c::visit(symbol);}
+};
+
+
+/* Get the list of variables whose address is taken with REF() */
+class search_referenced_variables_c: public iterator_visitor_c {
+  private:
+    symtable_c<bool> &referenced_vars;
+
+  public:
+    search_referenced_variables_c(symtable_c<bool> &referenced_vars_): referenced_vars(referenced_vars_) {}
+
+    void *visit(ref_expression_c *symbol) {
+      token_c *var_name = get_var_name_c::get_name(symbol->exp);
+      if (NULL != var_name) referenced_vars.insert(var_name->value, true);
+      return iterator_visitor_c::visit(symbol);
+    }
+};
+
+
+
+/* Get the list of variables declared in VAR_TEMP */
+class search_temp_variables_c: public iterator_visitor_c {
+  private:
+    symtable_c<bool> &temp_vars;
+    bool in_temp_decls;
+
+  public:
+    search_temp_variables_c(symtable_c<bool> &temp_vars_): temp_vars(temp_vars_) {in_temp_decls = false;}
+
+    void *visit(temp_var_decls_c *symbol) {
+      in_temp_decls = true;
+      symbol->var_decl_list->accept(*this);
+      in_temp_decls = false;
+      return NULL;
+    }
+
+    void *visit(var1_list_c *symbol) {
+      if (!in_temp_decls) return NULL;
+      for (int i = 0; i < symbol->n; i++) {
+        token_c *var_name = dynamic_cast<token_c *>(symbol->elements[i]);
+        if (NULL != var_name) temp_vars.insert(var_name->value, true);
+      }
+      return NULL;
+    }
+};
+
+
+
+/* Merge (meet) the values in m2 into m1. A variable not present in one of the maps has an unknown value. */
+void constant_propagation_c::meet_values(map_values_t &m1, map_values_t &m2) {
+	for (map_values_t::iterator itr = m1.begin(); itr != m1.end(); ++itr) {
+		map_values_t::iterator itr2 = m2.find(itr->first);
+		if (itr2 == m2.end()) {itr->second = nonconst_cvalue(); continue;}
+		MEET_CVALUE_(real64, itr->second, itr2->second);
+		MEET_CVALUE_(uint64, itr->second, itr2->second);
+		MEET_CVALUE_( int64, itr->second, itr2->second);
+		MEET_CVALUE_(  bool, itr->second, itr2->second);
+	}
+}
+
+
+void constant_propagation_c::invalidate_variables(map_values_t &values_map, symbol_c *statements) {
+	invalidate_assigned_variables_c invalidate_assigned_variables(values_map);
+	statements->accept(invalidate_assigned_variables);
+}
+
+
+/* Only the variables declared inside the POU itself (except VAR_IN_OUT, and located variables) are tracked.
+ * All others (VAR_EXTERNAL, VAR_GLOBAL, ...) may be changed by other POUs, so their value is never known.
+ * The variables of FBs and PROGRAMs (VAR_TEMP included) are listed in VARIABLES.csv, and may be forced by
+ * the debugger (__SET_VAR() then ignores the assignments to the variable), so only the variables of
+ * FUNCTIONs are tracked.
+ */
+bool constant_propagation_c::is_tracked_variable(symbol_c *var) {
+	if (NULL == dynamic_cast<symbolic_variable_c *>(var)) return false; /* array elements, structure elements, ... */
+	if (NULL == search_var_instance_decl)                 return false;
+	if (!function_body_)                                  return false;
+	token_c *var_name = get_var_name_c::get_name(var);
+	if (NULL == var_name)                                 return false;
+	if (referenced_vars.find(var_name->value) != referenced_vars.end()) return false;
+	switch (search_var_instance_decl->get_vartype(var)) {
+		case search_var_instance_decl_c::input_vt:
+		case search_var_instance_decl_c::output_vt:
+		case search_var_instance_decl_c::private_vt:
+		case search_var_instance_decl_c::temp_vt:
+			return true;
+		/* search_var_instance_decl_c does not distinguish the variables declared in VAR (of functions), VAR_TEMP
+		 * and VAR NON_RETAIN, from variables that have not been declared at all.
+		 */
+		case search_var_instance_decl_c::none_vt:
+			return (NULL != search_var_instance_decl->get_decl(var));
+		default:
+			return false;
+	}
+}
+
+
+/* Handle an assignment of 'value' to the variable 'var' */
+void constant_propagation_c::set_variable_value(symbol_c *var, const_value_c value) {
+	if (!is_tracked_variable(var)) {
+		invalidate_variable(*values, var);
+		return;
+	}
+	var->const_value = variable_cvalue(value, var->datatype);
+	(*values)[get_var_name_c::get_name(var)->value] = var->const_value;
+}
+
+
+/* Analyse the body of a POU (after the POU's variable declarations have been analysed and stored in the values map) */
+void *constant_propagation_c::handle_pou_body(symbol_c *pou, symbol_c *body) {
+	if (!propagate_variables_) return body->accept(*this);
+
+	search_var_instance_decl_c search_var_instance_decl_(pou);
+	search_var_instance_decl = &search_var_instance_decl_;
+	function_body_ = (NULL != dynamic_cast<function_declaration_c *>(pou));
+	referenced_vars.clear();
+	search_referenced_variables_c search_referenced_variables(referenced_vars);
+	body->accept(search_referenced_variables);
+	/* the VAR_TEMP variables of FBs and PROGRAMs are not tracked either, so do not use their initial value */
+	if (!function_body_) {
+		search_temp_variables_c search_temp_variables(referenced_vars);
+		pou->accept(search_temp_variables);
 	}
+	for (symtable_c<bool>::iterator itr = referenced_vars.begin(); itr != referenced_vars.end(); ++itr)
+		if (values->find(itr->first) != values->end()) (*values)[itr->first] = nonconst_cvalue();
 
-	return ret;
+	body->accept(*this);
+
+	il_values.clear();
+	referenced_vars.clear();
+	search_var_instance_decl = NULL;
+	function_body_ = false;
+	return NULL;
 }
 
 /***************************/
@@ -1390,9 +1652,10 @@ void *constant_propagation_c::visit(library_c *symbol) {
 /*********************/
 #if DO_CONSTANT_PROPAGATION__
 void *constant_propagation_c::visit(symbolic_variable_c *symbol) {
-	std::string varName = get_var_name_c::get_name(symbol->var_name)->value;
-	if (values->count(varName) > 0) 
-		symbol->const_value = (*values)[varName];
+	if (!propagate_variables_ || (NULL == values)) return NULL;
+	map_values_t::iterator itr = values->find(get_var_name_c::get_name(symbol->var_name)->value);
+	if (itr == values->end()) symbol->const_value = variable_cvalue(nonconst_cvalue(), symbol->datatype);
+	else                      symbol->const_value = variable_cvalue(itr->second, symbol->datatype);
 	return NULL;
 }
 #endif  // DO_CONSTANT_PROPAGATION__
@@ -1561,7 +1824,7 @@ void *constant_propagation_c::visit(input_output_declarations_c *symbol) {return
 /* VAR [CONSTANT] var_init_decl_list END_VAR */
 /* option -> may be NULL ! */
 //SYM_REF2(var_declarations_c, option, var_init_decl_list)
-void *constant_propagation_c::visit(var_declarations_c *symbol) {return handle_var_decl(symbol->var_init_decl_list, false);}
+void *constant_propagation_c::visit(var_declarations_c *symbol) {return handle_var_decl(symbol->var_init_decl_list, is_constant(symbol->option));}
 
 /*  VAR RETAIN var_init_decl_list END_VAR */
 //SYM_REF1(retentive_var_declarations_c, var_init_decl_list)             // Not needed since we inherit from iterator_visitor_c!
@@ -1748,7 +2011,7 @@ void *constant_propagation_c::visit(function_declaration_c *symbol) {
 	function_pou_ = true;
 	symbol->var_declarations_list->accept(*this);
 	function_pou_ = false;
-	symbol->function_body->accept(*this);
+	handle_pou_body(symbol, symbol->function_body);
 
 	var_global_values.pop(); /* Delete inner scope */
 	values = prev_pou_values;
@@ -1787,7 +2050,7 @@ void *constant_propagation_c::visit(function_block_declaration_c *symbol) {
 	/* Add initial value of all declared variables into Values map. */
 	function_pou_ = false;
 	symbol->var_declarations->accept(*this);
-	symbol->fblock_body->accept(*this);
+	handle_pou_body(symbol, symbol->fblock_body);
 
 	var_global_values.pop(); /* Delete inner scope */
 	values = prev_pou_values;
@@ -1821,7 +2084,7 @@ void *constant_propagation_c::visit(program_declaration_c *symbol) {
 	/* Add initial value of all declared variables into Values map. */
 	function_pou_ = false;
 	symbol->var_declarations->accept(*this);
-	symbol->function_block_body->accept(*this);
+	handle_pou_body(symbol, symbol->function_block_body);
 
 	var_global_values.pop(); /* Delete inner scope */
 	values = prev_pou_values;
@@ -1829,6 +2092,34 @@ void *constant_propagation_c::visit(program_declaration_c *symbol) {
 }
 
 
+/********************************************/
+/* B 1.6 Sequential Function Chart elements */
+/********************************************/
+#if DO_CONSTANT_PROPAGATION__
+/* The order in which the steps, transitions and actions of a SFC are executed is only known at run time,
+ * so each one of them is analysed starting off with the values known at the beginning of the POU,
+ * from which we remove all the variables that are changed anywhere inside the SFC.
+ */
+// SYM_LIST(sequential_function_chart_c)
+void *constant_propagation_c::visit(sequential_function_chart_c *symbol) {
+	if (!propagate_variables_) return iterator_visitor_c::visit(symbol);
+
+	map_values_t sfc_values = *values;
+	invalidate_variables(sfc_values, symbol);
+	for (int i = 0; i < symbol->n; i++) {
+		list_c *sfc_network = dynamic_cast<list_c *>(symbol->elements[i]);
+		if (NULL == sfc_network) ERROR;
+		for (int j = 0; j < sfc_network->n; j++) {
+			*values = sfc_values;
+			sfc_network->elements[j]->accept(*this);
+		}
+	}
+	*values = sfc_values;
+	return NULL;
+}
+#endif  // DO_CONSTANT_PROPAGATION__
+
+
 /********************************/
 /* B 1.7 Configuration elements */
 /********************************/
@@ -1979,136 +2270,301 @@ void *constant_propagation_c::visit(fb_task_c *symbol) {
 
 
 
+#if DO_CONSTANT_PROPAGATION__
+/****************************************/
+/* B.2 - Language IL (Instruction List) */
+/****************************************/
+/***********************************/
+/* B 2.1 Instructions and Operands */
+/***********************************/
+/* The IL instructions are analysed in the order in which they appear in the instruction list, using the
+ * graph of the possible execution paths built by flow_control_analysis_c (i.e. the prev_il_instruction of
+ * each IL instruction). The values of the variables at the beginning of each IL instruction are the meet
+ * of the values at the end of all its prev_il_instructions.
+ * If one of these prev_il_instructions has not yet been analysed (a jump backwards, i.e. a loop), then
+ * we use the values known at the beginning of the instruction list, from which we remove all the
+ * variables that are changed anywhere in the instruction list.
+ */
+/*| instruction_list il_instruction */
+// SYM_LIST(instruction_list_c)
+void *constant_propagation_c::visit(instruction_list_c *symbol) {
+	if (!propagate_variables_) return iterator_visitor_c::visit(symbol);
+
+	map_values_t entry_values = *values;
+	map_values_t loop_values  = *values;
+	invalidate_variables(loop_values, symbol);
+
+	il_values.clear();
+	for (int i = 0; i < symbol->n; i++) {
+		il_instruction_c *il_instruction = dynamic_cast<il_instruction_c *>(symbol->elements[i]);
+		if (NULL == il_instruction) ERROR;
+
+		if (il_instruction->prev_il_instruction.empty())
+			*values = entry_values;
+		for (unsigned int j = 0; j < il_instruction->prev_il_instruction.size(); j++) {
+			std::map<symbol_c *, map_values_t>::iterator prev = il_values.find(il_instruction->prev_il_instruction[j]);
+			if (prev == il_values.end()) {*values = loop_values; break;}
+			if (j == 0) *values = prev->second;
+			else        meet_values(*values, prev->second);
+		}
+		il_instruction->accept(*this);
+		il_values[il_instruction] = *values;
+	}
+	il_values.clear();
+	return NULL;
+}
+
+
+/* | function_name [il_operand_list] */
+/* NOTE: The parameters 'called_function_declaration' and 'extensible_param_count' are used to pass data between the stage 3 and stage 4. */
+// SYM_REF2(il_function_call_c, function_name, il_operand_list, symbol_c *called_function_declaration; int extensible_param_count;)
+void *constant_propagation_c::visit(il_function_call_c *symbol) {
+	iterator_visitor_c::visit(symbol);
+	if (propagate_variables_) invalidate_call_outputs(*values, symbol, symbol->called_function_declaration, true);
+	return NULL;
+}
+
+
+/* NOTE: The parameter 'called_fb_declaration'is used to pass data between stage 3 and stage4 (although currently it is not used in stage 4 */
+// SYM_REF4(il_fb_call_c, il_call_operator, fb_name, il_operand_list, il_param_list, symbol_c *called_fb_declaration)
+void *constant_propagation_c::visit(il_fb_call_c *symbol) {
+	constant_folding_c::visit(symbol);
+	if (propagate_variables_) invalidate_call_outputs(*values, symbol, symbol->called_fb_declaration);
+	return NULL;
+}
+
+
+/* | function_name '(' eol_list [il_param_list] ')' */
+/* NOTE: The parameter 'called_function_declaration' is used to pass data between the stage 3 and stage 4. */
+// SYM_REF2(il_formal_funct_call_c, function_name, il_param_list, symbol_c *called_function_declaration; int extensible_param_count;)
+void *constant_propagation_c::visit(il_formal_funct_call_c *symbol) {
+	iterator_visitor_c::visit(symbol);
+	if (propagate_variables_) invalidate_call_outputs(*values, symbol, symbol->called_function_declaration);
+	return NULL;
+}
+
+
+/*******************/
+/* B 2.2 Operators */
+/*******************/
+void *constant_propagation_c::visit(ST_operator_c *symbol) {
+	constant_folding_c::visit(symbol);
+	if (propagate_variables_)
+		set_variable_value(il_operand, (NULL == prev_il_instruction)? nonconst_cvalue(): prev_il_instruction->const_value);
+	return NULL;
+}
+
+void *constant_propagation_c::visit(STN_operator_c *symbol) {
+	constant_folding_c::visit(symbol);
+	if (!propagate_variables_) return NULL;
+	const_value_c value = nonconst_cvalue();
+	if ((NULL != prev_il_instruction) && VALID_CVALUE(bool, prev_il_instruction))
+		value._bool.set(!GET_CVALUE(bool, prev_il_instruction));
+	set_variable_value(il_operand, value);
+	return NULL;
+}
+
+/* S and R only change the il_operand when the current value is TRUE */
+void *constant_propagation_c::visit(S_operator_c *symbol) {
+	constant_folding_c::visit(symbol);
+	if (!propagate_variables_) return NULL;
+	if ((NULL != prev_il_instruction) && VALID_CVALUE(bool, prev_il_instruction) && !GET_CVALUE(bool, prev_il_instruction))
+		return NULL;
+	const_value_c value = nonconst_cvalue();
+	if ((NULL != prev_il_instruction) && VALID_CVALUE(bool, prev_il_instruction))
+		value._bool.set(true);
+	set_variable_value(il_operand, value);
+	return NULL;
+}
+
+void *constant_propagation_c::visit(R_operator_c *symbol) {
+	constant_folding_c::visit(symbol);
+	if (!propagate_variables_) return NULL;
+	if ((NULL != prev_il_instruction) && VALID_CVALUE(bool, prev_il_instruction) && !GET_CVALUE(bool, prev_il_instruction))
+		return NULL;
+	const_value_c value = nonconst_cvalue();
+	if ((NULL != prev_il_instruction) && VALID_CVALUE(bool, prev_il_instruction))
+		value._bool.set(false);
+	set_variable_value(il_operand, value);
+	return NULL;
+}
+
+
+
 /***************************************/
 /* B.3 - Language ST (Structured Text) */
 /***************************************/
 /***********************/
 /* B 3.1 - Expressions */
 /***********************/
-#if DO_CONSTANT_PROPAGATION__
-/* TODO: handle function invocations... */
-// void *fill_candidate_datatypes_c::visit(function_invocation_c *symbol) {}
+// SYM_REF3(function_invocation_c, function_name, formal_param_list, nonformal_param_list, symbol_c *called_function_declaration; int extensible_param_count; std::vector <symbol_c *> candidate_functions;)
+void *constant_propagation_c::visit(function_invocation_c *symbol) {
+	iterator_visitor_c::visit(symbol);
+	if (propagate_variables_) invalidate_call_outputs(*values, symbol, symbol->called_function_declaration);
+	return NULL;
+}
 
 
 /*********************************/
 /* B 3.2.1 Assignment Statements */
 /*********************************/
 void *constant_propagation_c::visit(assignment_statement_c *symbol) {
-	std::string varName;
-
+	if (!propagate_variables_) return iterator_visitor_c::visit(symbol);
 	symbol->r_exp->accept(*this);
 	symbol->l_exp->accept(*this); // if the lvalue has an array, do contant folding of the array indexes!
-	symbol->l_exp->const_value = symbol->r_exp->const_value;
-	(*values)[get_var_name_c::get_name(symbol->l_exp)->value] = symbol->l_exp->const_value;
+	set_variable_value(symbol->l_exp, symbol->r_exp->const_value);
 	return NULL;
 }
 
+
+/*****************************************/
+/* B 3.2.2 Subprogram Control Statements */
+/*****************************************/
+// SYM_REF3(fb_invocation_c, fb_name, formal_param_list, nonformal_param_list, symbol_c *called_fb_declaration;)
+void *constant_propagation_c::visit(fb_invocation_c *symbol) {
+	iterator_visitor_c::visit(symbol);
+	if (propagate_variables_) invalidate_call_outputs(*values, symbol, symbol->called_fb_declaration);
+	return NULL;
+}
+
+
 /********************************/
 /* B 3.2.3 Selection Statements */
 /********************************/
+/* IF expression THEN statement_list elseif_statement_list ELSE statement_list END_IF */
+// SYM_REF4(if_statement_c, expression, statement_list, elseif_statement_list, else_statement_list)
+/* Branches whose condition is a constant FALSE (or that follow a constant TRUE condition) are never executed,
+ * and are therefore not analysed. The variables' values after the IF are the meet of the values at the end
+ * of each branch that may be executed.
+ */
 void *constant_propagation_c::visit(if_statement_c *symbol) {
-	map_values_t values_incoming;
-	map_values_t values_statement_result;
-	map_values_t values_elsestatement_result;
-	map_values_t::iterator itr;
+	if (!propagate_variables_) return iterator_visitor_c::visit(symbol);
+
+	/* The list of branches: (condition, statement_list). The ELSE branch has a NULL condition. */
+	std::vector<std::pair<symbol_c *, symbol_c *> > branches;
+	branches.push_back(std::make_pair(symbol->expression, symbol->statement_list));
+	list_c *elseif_list = dynamic_cast<list_c *>(symbol->elseif_statement_list);
+	for (int i = 0; (NULL != elseif_list) && (i < elseif_list->n); i++) {
+		elseif_statement_c *elseif = dynamic_cast<elseif_statement_c *>(elseif_list->elements[i]);
+		if (NULL == elseif) ERROR;
+		branches.push_back(std::make_pair(elseif->expression, elseif->statement_list));
+	}
+	if (NULL != symbol->else_statement_list)
+		branches.push_back(std::make_pair((symbol_c *)NULL, symbol->else_statement_list));
+
+	map_values_t values_incoming;   /* values before executing the branch being analysed */
+	map_values_t values_result;     /* meet of the values at the end of the branches already analysed */
+	bool result_empty = true;       /* no branch has been analysed yet */
+	bool exhaustive   = false;      /* one of the branches analysed so far is always executed (when reached) */
+	for (size_t i = 0; (i < branches.size()) && !exhaustive; i++) {
+		if (NULL == branches[i].first) exhaustive = true;
+		else {
+			branches[i].first->accept(*this);
+			if (VALID_CVALUE(bool, branches[i].first)) {
+				if (!GET_CVALUE(bool, branches[i].first)) continue; /* branch is never executed */
+				exhaustive = true;
+			}
+		}
+		values_incoming = *values;
+		branches[i].second->accept(*this);
+		if (result_empty) values_result = *values;
+		else              meet_values(values_result, *values);
+		result_empty = false;
+		*values = values_incoming;
+	}
+	/* Not executing any branch is also possible */
+	if (!exhaustive) {
+		if (result_empty) values_result = *values;
+		else              meet_values(values_result, *values);
+	}
+	*values = values_result;
+	return NULL;
+}
 
-	/* Optimize dead code */
-	symbol->expression->accept(*this);
-	if (VALID_CVALUE(bool, symbol->expression) && GET_CVALUE(bool, symbol->expression) == false)
-		return NULL;
 
-	values_incoming = values; /* save incoming status */
-	symbol->statement_list->accept(*this);
-	values_statement_result = values;
-	if (NULL != symbol->else_statement_list) {
-		values = values_incoming;
-		symbol->else_statement_list->accept(*this);
-		values_elsestatement_result = values;
-	} else
-		values_elsestatement_result = values_incoming;
-	values = inner_left_join_values(values_statement_result, values_elsestatement_result);
+/* CASE expression OF case_element_list ELSE statement_list END_CASE */
+// SYM_REF3(case_statement_c, expression, case_element_list, statement_list)
+void *constant_propagation_c::visit(case_statement_c *symbol) {
+	if (!propagate_variables_) return iterator_visitor_c::visit(symbol);
 
+	symbol->expression->accept(*this);
+	map_values_t values_incoming = *values;
+	/* when no ELSE is given, not executing any of the case elements is also possible */
+	map_values_t values_result   = *values;
+	if (NULL != symbol->statement_list) {
+		symbol->statement_list->accept(*this);
+		values_result = *values;
+	}
+	list_c *case_element_list = dynamic_cast<list_c *>(symbol->case_element_list);
+	if (NULL == case_element_list) ERROR;
+	for (int i = 0; i < case_element_list->n; i++) {
+		case_element_c *case_element = dynamic_cast<case_element_c *>(case_element_list->elements[i]);
+		if (NULL == case_element) ERROR;
+		*values = values_incoming;
+		case_element->case_list->accept(*this);
+		case_element->statement_list->accept(*this);
+		meet_values(values_result, *values);
+	}
+	*values = values_result;
 	return NULL;
 }
 
+
 /********************************/
 /* B 3.2.4 Iteration Statements */
 /********************************/
+/* The variables changed inside a loop have an unknown value at the beginning of each iteration, as well
+ * as after the loop. All other variables keep the value they had before the loop.
+ */
+// SYM_REF5(for_statement_c, control_variable, beg_expression, end_expression, by_expression, statement_list)
 void *constant_propagation_c::visit(for_statement_c *symbol) {
-	map_values_t values_incoming;
-	map_values_t values_statement_result;
+	if (!propagate_variables_) return iterator_visitor_c::visit(symbol);
 
-	values_incoming = values; /* save incoming status */
 	symbol->beg_expression->accept(*this);
 	symbol->end_expression->accept(*this);
-	(*values)[get_var_name_c::get_name(symbol->control_variable)->value]._int64.status = const_value_c::cs_non_const;
-
-	/* Optimize dead code */
-	if (NULL != symbol->by_expression) {
+	if (NULL != symbol->by_expression)
 		symbol->by_expression->accept(*this);
-		if (VALID_CVALUE(int64, symbol->by_expression ) &&   GET_CVALUE(int64, symbol->by_expression ) > 0 &&
-			VALID_CVALUE(int64, symbol->beg_expression) && VALID_CVALUE(int64, symbol->end_expression)     &&
-			  GET_CVALUE(int64, symbol->beg_expression) >    GET_CVALUE(int64, symbol->end_expression))
-			return NULL;
-
-		if (VALID_CVALUE(int64, symbol->by_expression ) &&   GET_CVALUE(int64, symbol->by_expression ) < 0 &&
-			VALID_CVALUE(int64, symbol->beg_expression) && VALID_CVALUE(int64, symbol->end_expression)    &&
-			  GET_CVALUE(int64, symbol->beg_expression) <    GET_CVALUE(int64, symbol->end_expression))
-			return NULL;
-
-	} else {
-		if (VALID_CVALUE(int64, symbol->beg_expression) && VALID_CVALUE(int64, symbol->end_expression)     &&
-			  GET_CVALUE(int64, symbol->beg_expression) >    GET_CVALUE(int64, symbol->end_expression))
-			return NULL;
-
-	}
-
+	invalidate_variables(*values, symbol);
+	symbol->control_variable->accept(*this);
 
+	map_values_t values_loop = *values;
 	symbol->statement_list->accept(*this);
-	values_statement_result = values;
-	values = inner_left_join_values(values_statement_result, values_incoming);
-
+	*values = values_loop;
 	return NULL;
 }
 
+
+// SYM_REF2(while_statement_c, expression, statement_list)
 void *constant_propagation_c::visit(while_statement_c *symbol) {
-	map_values_t values_incoming;
-	map_values_t values_statement_result;
+	if (!propagate_variables_) return iterator_visitor_c::visit(symbol);
 
-	/* Optimize dead code */
+	/* Loop body is never executed? */
+	map_values_t values_incoming = *values;
 	symbol->expression->accept(*this);
-	if (VALID_CVALUE(bool, symbol->expression) && GET_CVALUE(bool, symbol->expression) == false)
+	if (VALID_CVALUE(bool, symbol->expression) && !GET_CVALUE(bool, symbol->expression))
 		return NULL;
 
-	values_incoming = values; /* save incoming status */
+	/* The expression is evaluated before each iteration, so it must be analysed again with the loop's values */
+	*values = values_incoming;
+	invalidate_variables(*values, symbol);
+	map_values_t values_loop = *values;
+	symbol->expression->accept(*this);
 	symbol->statement_list->accept(*this);
-	values_statement_result = values;
-	values = inner_left_join_values(values_statement_result, values_incoming);
-
+	*values = values_loop;
 	return NULL;
 }
 
+
+// SYM_REF2(repeat_statement_c, statement_list, expression)
 void *constant_propagation_c::visit(repeat_statement_c *symbol) {
-	map_values_t values_incoming;
-	map_values_t values_statement_result;
+	if (!propagate_variables_) return iterator_visitor_c::visit(symbol);
 
-	values_incoming = values; /* save incoming status */
+	invalidate_variables(*values, symbol);
+	map_values_t values_loop = *values;
 	symbol->statement_list->accept(*this);
-
-	/* Optimize dead code */
 	symbol->expression->accept(*this);
-	if (VALID_CVALUE(bool, symbol->expression) && GET_CVALUE(bool, symbol->expression) == true)
-		return NULL;
-
-	values_statement_result = values;
-	values = inner_left_join_values(values_statement_result, values_incoming);
-
+	*values = values_loop;
 	return NULL;
 }
 
 #endif  // DO_CONSTANT_PROPAGATION__
-
-
-
-
-
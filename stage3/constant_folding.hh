@@ -45,10 +45,10 @@
 
 
 
-/* For the moment we disable constant propagation algorithm as it is not yet complete, 
- * and due to this is currently brocken and producing incorrect results!
+/* Set to 0 to disable the (flow sensitive) propagation of the values assigned to variables inside
+ * the body of each POU (see the constant_propagation_c class below).
  */
-#define DO_CONSTANT_PROPAGATION__ 0
+#define DO_CONSTANT_PROPAGATION__ 1
 
 
 
@@ -57,7 +57,6 @@ class constant_folding_c : public iterator_visitor_c {
     int error_count;
     bool warning_found;
     int current_display_error_level;
-  private:
     /* Pointer to the previous IL instruction, which contains the current cvalue of the data stored in the IL stack, i.e. the default variable, a.k.a. accumulator */
     symbol_c *prev_il_instruction;
     /* the current IL operand being analyzed */
@@ -70,7 +69,7 @@ class constant_folding_c : public iterator_visitor_c {
     virtual ~constant_folding_c(void);
     int get_error_count();
  
-  private:
+  protected:
     /*********************/
     /* B 1.2 - Constants */
     /*********************/
@@ -202,10 +201,19 @@ class constant_folding_c : public iterator_visitor_c {
 
 
 #include <deque>
-
+#include <map>
+
+/* The constant propagation algorithm is run twice by stage3:
+ *   - before data type checking (propagate_variables = false), to determine the values of the
+ *     CONSTANT variables, and their use in the declaration of other variables (e.g. array sizes);
+ *   - after data type checking (propagate_variables = true), to also propagate the values assigned
+ *     to variables inside the body of each POU (e.g.  'mode := 3; ... IF mode = 3 THEN' ).
+ *     This requires the datatype annotations, as the value stored in a variable depends on its type,
+ *     and may therefore only be done after the data type checking.
+ */
 class constant_propagation_c : public constant_folding_c {
   public:
-    constant_propagation_c(symbol_c *symbol = NULL);
+    constant_propagation_c(symbol_c *symbol = NULL, bool propagate_variables = false);
     virtual ~constant_propagation_c(void);
     typedef symtable_c<const_value_c> map_values_t;
   private:
@@ -225,7 +233,26 @@ class constant_propagation_c : public constant_folding_c {
     bool function_pou_;
     bool is_constant(symbol_c *option);
     bool is_retain  (symbol_c *option);
-    static map_values_t inner_left_join_values(map_values_t m1, map_values_t m2);
+    static void meet_values(map_values_t &m1, map_values_t &m2);
+
+    /* Data used when propagating the values assigned to variables (propagate_variables_ == true) */
+    bool propagate_variables_;
+    /* used to determine in which kind of declaration (VAR, VAR_EXTERNAL, ...) each variable of the POU being analysed was declared */
+    search_var_instance_decl_c *search_var_instance_decl;
+    /* variables of the POU being analysed whose value is never known: the variables whose address is taken with REF()
+     * (these may change without being assigned to), and the VAR_TEMP variables of FBs and PROGRAMs.
+     */
+    symtable_c<bool> referenced_vars;
+    /* whether the POU being analysed is a FUNCTION (the variables of FBs and PROGRAMs are never tracked) */
+    bool function_body_;
+    /* the values of the variables after each IL instruction of the POU being analysed */
+    std::map<symbol_c *, map_values_t> il_values;
+
+    void *handle_pou_body     (symbol_c *pou, symbol_c *body);
+    bool  is_tracked_variable (symbol_c *var);
+    void  set_variable_value  (symbol_c *var, const_value_c value);
+    /* set to non-const, in the 'values_map', all the variables that may be changed by the 'statements' */
+    void  invalidate_variables(map_values_t &values_map, symbol_c *statements);
 
 
   private:
@@ -278,6 +305,13 @@ class constant_propagation_c : public constant_folding_c {
     /**********************/
     void *visit(       program_declaration_c *symbol);
 
+    /********************************************/
+    /* B 1.6 Sequential Function Chart elements */
+    /********************************************/
+    #if DO_CONSTANT_PROPAGATION__
+    void *visit(sequential_function_chart_c *symbol);
+    #endif // DO_CONSTANT_PROPAGATION__
+
     /********************************/
     /* B 1.7 Configuration elements */
     /********************************/
@@ -287,25 +321,25 @@ class constant_propagation_c : public constant_folding_c {
     void *visit(                   fb_task_c *symbol);
 
 
+    #if DO_CONSTANT_PROPAGATION__
     /****************************************/
     /* B.2 - Language IL (Instruction List) */
     /****************************************/
     /***********************************/
     /* B 2.1 Instructions and Operands */
     /***********************************/
-    //void *visit(il_function_call_c *symbol);  /* TODO */
-    // void *visit(il_fb_call_c *symbol);       /* TODO: move from constant_folding_c */
-    //void *visit(il_formal_funct_call_c *symbol);   /* TODO */
-    //void *visit(il_operand_list_c *symbol);  /* Not needed, since we inherit from iterator_visitor_c */
-
+    void *visit(instruction_list_c *symbol);
+    void *visit(il_function_call_c *symbol);
+    void *visit(il_fb_call_c *symbol);
+    void *visit(il_formal_funct_call_c *symbol);
 
     /*******************/
     /* B 2.2 Operators */
     /*******************/
-    /* Symbol class handled together with function call checks */
-    // void *visit(il_assign_operator_c *symbol, variable_name);
-    /* Symbol class handled together with function call checks */
-    // void *visit(il_assign_operator_c *symbol, option, variable_name);
+    void *visit(   ST_operator_c *symbol);
+    void *visit(  STN_operator_c *symbol);
+    void *visit(    S_operator_c *symbol);
+    void *visit(    R_operator_c *symbol);
 
     /***************************************/
     /* B.3 - Language ST (Structured Text) */
@@ -313,18 +347,23 @@ class constant_propagation_c : public constant_folding_c {
     /***********************/
     /* B 3.1 - Expressions */
     /***********************/
-    //void *visit(function_invocation_c *symbol); /* TODO */
+    void *visit(function_invocation_c *symbol);
 
-    #if DO_CONSTANT_PROPAGATION__
     /*********************************/
     /* B 3.2.1 Assignment Statements */
     /*********************************/
     void *visit(assignment_statement_c *symbol);
 
+    /*****************************************/
+    /* B 3.2.2 Subprogram Control Statements */
+    /*****************************************/
+    void *visit(fb_invocation_c *symbol);
+
     /********************************/
     /* B 3.2.3 Selection Statements */
     /********************************/
     void *visit(if_statement_c *symbol);
+    void *visit(case_statement_c *symbol);
 
     /********************************/
     /* B 3.2.4 Iteration Statements */
@@ -334,4 +373,3 @@ class constant_propagation_c : public constant_folding_c {
     void *visit(repeat_statement_c *symbol);
     #endif // DO_CONSTANT_PROPAGATION__
 };
-
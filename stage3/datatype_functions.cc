@@ -385,10 +385,17 @@ const struct widen_entry widen_CMP_table[] = {
 /* Search for a datatype inside a candidate_datatypes list.
  * Returns: position of datatype in the list, or -1 if not found.
  */
-int search_in_candidate_datatype_list(symbol_c *datatype, const std::vector <symbol_c *> &candidate_datatypes) {
+int search_in_candidate_datatype_list(symbol_c *datatype, const candidate_datatype_list_c &candidate_datatypes) {
 	if (NULL == datatype) 
 		return -1;
 
+	/* An elementary datatype is only equal to the same elementary datatype, or to a generic datatype (which is
+	 * not elementary), so there is no need to search the list when the bitmask of the list tells us it is not there.
+	 */
+	int bit = candidate_datatype_list_c::elementary_bit(datatype);
+	if ((bit >= 0) && candidate_datatypes.has_only_elementary() && !candidate_datatypes.has_elementary(bit))
+		return -1;
+
 	for(unsigned int i = 0; i < candidate_datatypes.size(); i++)
 		if (get_datatype_info_c::is_type_equal(datatype, candidate_datatypes[i]))
 			return i;
@@ -399,7 +406,7 @@ int search_in_candidate_datatype_list(symbol_c *datatype, const std::vector <sym
 /* Remove a datatype inside a candidate_datatypes list.
  * Returns: If successful it returns true, false otherwise.
  */
-bool remove_from_candidate_datatype_list(symbol_c *datatype, std::vector <symbol_c *> &candidate_datatypes) {
+bool remove_from_candidate_datatype_list(symbol_c *datatype, candidate_datatype_list_c &candidate_datatypes) {
 	int pos = search_in_candidate_datatype_list(datatype, candidate_datatypes);
 	if (pos < 0)
 		return false;
@@ -420,13 +427,21 @@ void intersect_candidate_datatype_list(symbol_c *list1 /*origin, dest.*/, symbol
 		/* In principle, we should never call it with NULL values. Best to abort the compiler just in case! */
 		return;
 
-	for(std::vector<symbol_c *>::iterator i = list1->candidate_datatypes.begin(); i < list1->candidate_datatypes.end(); ) {
+	/* When both lists only contain elementary datatypes, the intersection is given by their bitmasks */
+	bool only_elementary =    list1->candidate_datatypes.has_only_elementary()
+	                       && list2->candidate_datatypes.has_only_elementary();
+	if (only_elementary && ((list1->candidate_datatypes.get_elementary_mask() & ~list2->candidate_datatypes.get_elementary_mask()) == 0))
+		return; /* nothing to remove */
+
+	for(candidate_datatype_list_c::iterator i = list1->candidate_datatypes.begin(); i < list1->candidate_datatypes.end(); ) {
 		/* Note that we do _not_ increment i in the for() loop!
 		 * When we erase an element from position i, a new element will take it's place, that must also be tested! 
 		 */
-		if (search_in_candidate_datatype_list(*i, list2->candidate_datatypes) < 0)
+		bool found = only_elementary? list2->candidate_datatypes.has_elementary(candidate_datatype_list_c::elementary_bit(*i))
+		                            : (search_in_candidate_datatype_list(*i, list2->candidate_datatypes) >= 0);
+		if (!found)
 			/* remove this element! This will change the value of candidate_datatypes.size() */
-			list1->candidate_datatypes.erase(i);
+			i = list1->candidate_datatypes.erase(i);
 		else i++;
 	}
 }
@@ -62,6 +62,7 @@
 #include <../main.hh>         /* required for UINT64_MAX, INT64_MAX, INT64_MIN, ... */
 #include "fill_candidate_datatypes.hh"
 #include "datatype_functions.hh"
+#include "../stats.hh"
 #include <typeinfo>
 #include <list>
 #include <string>
@@ -272,9 +273,13 @@ fill_candidate_datatypes_c::fill_candidate_datatypes_c(symbol_c *ignore) {
 	search_var_instance_decl = NULL;
 	current_enumerated_spec_type = NULL;
 	current_scope = NULL;
+	overload_cache_hits   = 0;
+	overload_cache_misses = 0;
 }
 
 fill_candidate_datatypes_c::~fill_candidate_datatypes_c(void) {
+	stats_c::add_counter("stage3", "overload_cache_hits",   overload_cache_hits);
+	stats_c::add_counter("stage3", "overload_cache_misses", overload_cache_misses);
 }
 
 
@@ -431,7 +436,7 @@ bool fill_candidate_datatypes_c::match_formal_call(symbol_c *f_call, symbol_c *f
 			return false;
 
 		/* Obtaining the type of the value being passed in the function call */
-		std::vector <symbol_c *>&call_param_types = call_param_value->candidate_datatypes;
+		candidate_datatype_list_c &call_param_types = call_param_value->candidate_datatypes;
 
 		/* Find the corresponding parameter in function declaration */
 		param_name = fp_iterator.search(call_param_name);
@@ -468,6 +473,49 @@ bool fill_candidate_datatypes_c::match_formal_call(symbol_c *f_call, symbol_c *f
 
 
 
+/* Append the candidate datatypes of a parameter to an overload_cache key.
+ * Elementary datatypes are identified by their kind, as each declaration of a variable has its own
+ * symbol for its elementary datatype (e.g. INT), and get_datatype_info_c::is_type_equal() only compares
+ * their kind. All other datatypes are identified by the address of the symbol returned by
+ * search_base_type_c, which is never freed during compilation.
+ */
+static void overload_cache_key_datatypes(std::string &key, candidate_datatype_list_c &candidate_datatypes) {
+	char buf[32];
+	for (unsigned int i = 0; i < candidate_datatypes.size(); i++) {
+		if (get_datatype_info_c::is_ANY_ELEMENTARY_compatible(candidate_datatypes[i]))
+		      snprintf(buf, sizeof(buf), "k%d,", (int)candidate_datatypes[i]->kind);
+		else  snprintf(buf, sizeof(buf), "%p,", (void *)candidate_datatypes[i]);
+		key += buf;
+	}
+}
+
+
+/* The key of the overload_cache for a function call: the name of the called function, followed by the
+ * candidate datatypes of each non-formal parameter, and the name, assignment direction and candidate
+ * datatypes of each formal parameter, being passed.
+ */
+std::string fill_candidate_datatypes_c::overload_cache_key(symbol_c *f_call, symbol_c *function_name) {
+	std::string key(get_datatype_info_c::get_id_str(function_name));
+	symbol_c *call_param_value, *call_param_name;
+
+	function_call_param_iterator_c fcp_iterator_nf(f_call);
+	while ((call_param_value = fcp_iterator_nf.next_nf()) != NULL) {
+		key += "(";
+		overload_cache_key_datatypes(key, call_param_value->candidate_datatypes);
+	}
+	function_call_param_iterator_c fcp_iterator_f(f_call);
+	while ((call_param_name = fcp_iterator_f.next_f()) != NULL) {
+		call_param_value = fcp_iterator_f.get_current_value();
+		if (NULL == call_param_value) ERROR;
+		key += std::string("(") + get_datatype_info_c::get_id_str(call_param_name);
+		key += (function_call_param_iterator_c::assign_out == fcp_iterator_f.get_assign_direction())? "=>" : ":=";
+		overload_cache_key_datatypes(key, call_param_value->candidate_datatypes);
+	}
+	for (unsigned int i = 0; i < key.size(); i++) key[i] = toupper((unsigned char)key[i]); // function and parameter names are case insensitive
+	return key;
+}
+
+
 /* Handle a generic function call!
  * Assumes that the parameter_list containing the values being passed in this function invocation
  * has already had all the candidate_datatype lists filled in!
@@ -527,22 +575,37 @@ void fill_candidate_datatypes_c::handle_function_call(symbol_c *fcall, generic_f
 			fcall_data.candidate_functions.push_back(f_decl);
 		
 	}
-	for(; lower != upper; lower++) {
-		bool compatible = false;
-		
-		f_decl = function_symtable.get_value(lower);
-		/* Check if function declaration in symbol_table is compatible with parameters */
-		if (NULL != fcall_data.nonformal_operand_list) compatible=match_nonformal_call(fcall, f_decl);
-		if (NULL != fcall_data.   formal_operand_list) compatible=   match_formal_call(fcall, f_decl);
-		if (compatible) {
-			/* Add the data type returned by the called functions. 
-			 * However, only do this if this data type is not already present in the candidate_datatypes list_c
-			 */
-			returned_parameter_type = base_type(f_decl->type_name);		
-			if (add_datatype_to_candidate_list(fcall, returned_parameter_type))
-				/* we only add it to the function declaration list if this entry was not already present in the candidate datatype list! */
-				fcall_data.candidate_functions.push_back(f_decl);
+	/* Whether an overloaded function declaration is compatible with the call depends only on the
+	 * signature of the call, which recurs very often (e.g. ADD on two INT values), so the list of
+	 * compatible declarations is looked up in (or else added to) the overload_cache.
+	 */
+	std::string key = overload_cache_key(fcall, fcall_data.function_name);
+	overload_cache_t::iterator cached = overload_cache.find(key);
+	if (cached != overload_cache.end()) {
+		overload_cache_hits++;
+	} else {
+		overload_cache_misses++;
+		std::vector <function_declaration_c *> compatible_functions;
+		for(; lower != upper; lower++) {
+			bool compatible = false;
+			
+			f_decl = function_symtable.get_value(lower);
+			/* Check if function declaration in symbol_table is compatible with parameters */
+			if (NULL != fcall_data.nonformal_operand_list) compatible=match_nonformal_call(fcall, f_decl);
+			if (NULL != fcall_data.   formal_operand_list) compatible=   match_formal_call(fcall, f_decl);
+			if (compatible) compatible_functions.push_back(f_decl);
 		}
+		cached = overload_cache.insert(std::make_pair(key, compatible_functions)).first;
+	}
+	for (unsigned int i = 0; i < cached->second.size(); i++) {
+		f_decl = cached->second[i];
+		/* Add the data type returned by the called functions. 
+		 * However, only do this if this data type is not already present in the candidate_datatypes list_c
+		 */
+		returned_parameter_type = base_type(f_decl->type_name);		
+		if (add_datatype_to_candidate_list(fcall, returned_parameter_type))
+			/* we only add it to the function declaration list if this entry was not already present in the candidate datatype list! */
+			fcall_data.candidate_functions.push_back(f_decl);
 	}
 	if (debug) std::cout << "end_function() [" << fcall->candidate_datatypes.size() << "] result.\n";
 	return;
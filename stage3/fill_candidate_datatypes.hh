@@ -52,6 +52,8 @@
 
 #include "../absyntax_utils/absyntax_utils.hh"
 #include "datatype_functions.hh"
+#include <map>
+#include <string>
 
 class fill_candidate_datatypes_c: public iterator_visitor_c {
 
@@ -86,6 +88,17 @@ class fill_candidate_datatypes_c: public iterator_visitor_c {
     symbol_c *il_operand;
     symbol_c *widening_conversion(symbol_c *left_type, symbol_c *right_type, const struct widen_entry widen_table[]);
 
+    /* Cache of the overload resolution of function calls (used by handle_function_call()).
+     * Maps the name of the called function, together with the signature of the call (the names,
+     * assignment directions and candidate datatypes of the parameters being passed), to the list
+     * of the overloaded function declarations compatible with that call.
+     */
+    typedef std::map<std::string, std::vector <function_declaration_c *> > overload_cache_t;
+    overload_cache_t overload_cache;
+    long long int    overload_cache_hits;
+    long long int    overload_cache_misses;
+    std::string overload_cache_key(symbol_c *f_call, symbol_c *function_name);
+
     /* Match a function declaration with a function call through their parameters.*/
     /* returns true if compatible function/FB invocation, otherwise returns false */
     bool  match_nonformal_call(symbol_c *f_call, symbol_c *f_decl);
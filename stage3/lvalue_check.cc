@@ -463,6 +463,7 @@ void *lvalue_check_c::visit(il_function_call_c *symbol) {
 	 */
 	real_c param_value(NULL);
 	*((symbol_c *)(&param_value)) = *((symbol_c *)symbol); /* copy the symbol location (file, line, offset) data */
+	param_value.kind = real_c::class_kind;                 /* ... but it is still a real_c! */
 	if (NULL == symbol->il_operand_list)  symbol->il_operand_list = new il_operand_list_c;
 	if (NULL == symbol->il_operand_list)  ERROR;
 	((list_c *)symbol->il_operand_list)->insert_element(&param_value, 0);
@@ -47,6 +47,9 @@
 #include "remove_forward_dependencies.hh"
 #include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
 #include "../absyntax_utils/absyntax_utils.hh"
+#include <queue>
+#include <algorithm>
+#include <functional>
 
 
 
@@ -81,6 +84,17 @@
 
 
 
+/* The key used to compare POU names (IEC 61131-3 identifiers are case insensitive) */
+static std::string name_key(symbol_c *name) {
+  const char *id = get_datatype_info_c::get_id_str(name);
+  if (NULL == id) ERROR;
+  std::string key(id);
+  for (size_t i = 0; i < key.size(); i++) key[i] = toupper((unsigned char)key[i]);
+  return key;
+}
+
+
+
 /* NOTE: We create an independent visitor for this task instead of having this done by the remove_forward_dependencies_c
  *       because we do not want to handle the ***_pragma_c classes while doing this search.
  *      (remove_forward_dependencies_c needs to visit those classes when handling all the possible entries in
@@ -91,58 +105,26 @@
  *          - FB type
  *          - Program type
  *          - Function type
- *      and by checking whether those references are in the declared_identifiers list.
  *      However, one of those objects, the ref_spec_c, may reference an FB type, or any other datatype, so we must have a way
  *      of knowing what is being referenced in this case. I have opted to introduce a new object type in the AST, the
  *      poutype_identifier_c, that will be used anywhere in the AST that references either a PROGRAM name or a FB type name
  *      or a FUNCTION name (previously a simple identifier_c was used!).
  *      This means that we merely need to visit the new poutype_identifier_c object in this visitor.
  */
-class find_forward_dependencies_c: public search_visitor_c {
+class find_forward_dependencies_c: public iterator_visitor_c {
   private:
-    identifiers_symbtable_t *declared_identifiers; // list of identifiers already declared by the symbols in the new tree
+    std::set<std::string> *references; // the names of all the POUs referenced by the symbol being searched
   public:
-    find_forward_dependencies_c(identifiers_symbtable_t *declared_identifiers_) {declared_identifiers = declared_identifiers_;}
+    void get(symbol_c *symbol, std::set<std::string> *references_)
+      {references = references_; if (NULL != symbol) symbol->accept(*this);}
   /*******************************************/
   /* B 1.1 - Letters, digits and identifiers */
   /*******************************************/
-  // return NULL if the symbol is already in the declared_identifiers symbol table, otherwise return the missing symbol!
-  void *visit(            poutype_identifier_c *symbol)
-    {if (declared_identifiers->find(symbol) != declared_identifiers->end()) return NULL; else return symbol;}
+  void *visit(            poutype_identifier_c *symbol) {references->insert(name_key(symbol)); return NULL;}
 };   /* class find_forward_dependencies_c */
 
 
 
-
-/* A class to count the number of POUs (Function, FBs Programs and Configurations) in a library.
- * This will be used to make sure whether we have copied all the POUs from the original AST (abstract
- * syntax tree) to the new AST.
- * Note that we can't simply use the number of 'elements' in the AST, as it may contain unknown/unsupported pragmas.
- */
-class pou_count_c: public search_visitor_c {
-  private:
-    static pou_count_c *singleton;
-    long long int count;
-
-  public:
-    static long long int get_count(library_c *library) {
-      if (NULL == singleton) singleton = new pou_count_c;
-      if (NULL == singleton) ERROR;
-      singleton->count = 0;
-      library->accept(*singleton);
-      return singleton->count;
-    }
-    
-    /**************************************/
-    /* B.1.5 - Program organization units */
-    /**************************************/
-    void *visit(      function_declaration_c *symbol) {count++; return NULL;}
-    void *visit(function_block_declaration_c *symbol) {count++; return NULL;} 
-    void *visit(       program_declaration_c *symbol) {count++; return NULL;} 
-    void *visit( configuration_declaration_c *symbol) {count++; return NULL;} 
-};   /* class pou_count_c */
-
-pou_count_c *pou_count_c::singleton = NULL;
 symbol_c remove_forward_dependencies_c_null_symbol;
 
 
@@ -160,7 +142,7 @@ symbol_c remove_forward_dependencies_c_null_symbol;
 
 // constructor & destructor
 remove_forward_dependencies_c:: remove_forward_dependencies_c(void) {
-  find_forward_dependencies      = new find_forward_dependencies_c(&declared_identifiers);
+  find_forward_dependencies      = new find_forward_dependencies_c;
   current_display_error_level = error_level_default;
   error_count = 0;
 }
@@ -188,31 +170,99 @@ library_c *remove_forward_dependencies_c::create_new_tree(symbol_c *tree) {
 
 
 
+/* Add the POU to the dependency graph, with all the POUs it references */
 void *remove_forward_dependencies_c::handle_library_symbol(symbol_c *symbol, symbol_c *name, symbol_c *search1, symbol_c *search2, symbol_c *search3) {
-  if (inserted_symbols.find(symbol) != inserted_symbols.end())                 return NULL; // already previously inserted into new_tree and declared_identifiers. Do not handle again!
-  if ((search1 != NULL) && (search1->accept(*find_forward_dependencies) != NULL)) return NULL; // A forward depency has not yet been satisfied. Wait for a later iteration to try again! 
-  if ((search2 != NULL) && (search2->accept(*find_forward_dependencies) != NULL)) return NULL; // A forward depency has not yet been satisfied. Wait for a later iteration to try again!
-  if ((search3 != NULL) && (search3->accept(*find_forward_dependencies) != NULL)) return NULL; // A forward depency has not yet been satisfied. Wait for a later iteration to try again!
-  /* no forward dependencies found => insert into new AST, and add to the 'defined identifiers' and 'inserted symbol' lists */
-  if (declared_identifiers.find(name) == declared_identifiers.end())
-      declared_identifiers.insert(name, NULL);  // only add if not yet in the symbol table (an overloaded version of this same POU could have been inderted previously!)
-  inserted_symbols.insert(symbol);
-  new_tree->add_element(current_code_generation_pragma);  
-  new_tree->add_element(symbol);  
+  pou_node_t node;
+  node.symbol                 = symbol;
+  node.name                   = name;
+  node.code_generation_pragma = current_code_generation_pragma;
+  node.inserted               = false;
+  find_forward_dependencies->get(search1, &node.references);
+  find_forward_dependencies->get(search2, &node.references);
+  find_forward_dependencies->get(search3, &node.references);
+  node.pending                = node.references.size();
+
+  int n = pou_nodes.size();
+  pou_nodes.push_back(node);
+  declaring_nodes[name_key(name)].push_back(n);
+  for (std::set<std::string>::iterator iter = node.references.begin(); iter != node.references.end(); ++iter)
+    referencing_nodes[*iter].push_back(n);
   return NULL;
 }
 
 
+/* Search for the circular referencing loops among the POUs that could not be inserted into the new tree,
+ * i.e. the strongly connected components of the dependency graph (Tarjan's algorithm). 
+ * Only the dependencies on names not yet declared in the new tree are followed.
+ */
+void remove_forward_dependencies_c::find_cycles(int node) {
+  scc_index[node] = scc_lowlink[node] = scc_next_index++;
+  scc_stack.push_back(node);
+  scc_on_stack[node] = true;
+
+  std::set<std::string> &references = pou_nodes[node].references;
+  for (std::set<std::string>::iterator iter = references.begin(); iter != references.end(); ++iter) {
+    if (declared_names.find(*iter) != declared_names.end()) continue;
+    name_nodes_t::iterator declaring = declaring_nodes.find(*iter);
+    if (declaring == declaring_nodes.end()) continue;
+    for (size_t i = 0; i < declaring->second.size(); i++) {
+      int next = declaring->second[i];
+      if (scc_index[next] < 0) {
+        find_cycles(next);
+        scc_lowlink[node] = std::min(scc_lowlink[node], scc_lowlink[next]);
+      } else if (scc_on_stack[next])
+        scc_lowlink[node] = std::min(scc_lowlink[node], scc_index[next]);
+    }
+  }
+
+  if (scc_lowlink[node] != scc_index[node]) return;
+  std::vector<int> members;
+  int member;
+  do {
+    member = scc_stack.back();
+    scc_stack.pop_back();
+    scc_on_stack[member] = false;
+    members.push_back(member);
+  } while (member != node);
+  print_cycle(members);
+}
+
+
+/* Tell the user that the POUs in 'members' belong in a circular referencing loop (if they do) */
+void remove_forward_dependencies_c::print_cycle(std::vector<int> &members) {
+  if (members.size() == 1) {
+    pou_node_t &node = pou_nodes[members[0]];
+    if (node.references.find(name_key(node.name)) != node.references.end())
+      STAGE3_ERROR(0, node.symbol, node.symbol, "POU (%s) contains a self-reference", get_datatype_info_c::get_id_str(node.name));
+    return;
+  }
+
+  std::sort(members.begin(), members.end()); // list the POUs in the order they are declared in the source code
+  std::string names;
+  for (size_t i = 0; i < members.size(); i++)
+    names += std::string((i == 0)? "" : ", ") + get_datatype_info_c::get_id_str(pou_nodes[members[i]].name);
+  for (size_t i = 0; i < members.size(); i++) {
+    pou_node_t &node = pou_nodes[members[i]];
+    STAGE3_ERROR(0, node.symbol, node.symbol, "POU (%s) belongs in a circular referencing loop (%s)", get_datatype_info_c::get_id_str(node.name), names.c_str());
+  }
+}
+
+
 /* Tell the user that the source code contains a circular dependency */
-void remove_forward_dependencies_c::print_circ_error(library_c *symbol) {
-  /* Note that we only print Functions and FBs, as Programs and Configurations cannot contain circular references due to syntax rules */
-  /* Note too that circular references in derived datatypes is also not possible due to sytax!                                        */
+void remove_forward_dependencies_c::print_circ_error(void) {
+  /* Note that Programs and Configurations cannot contain circular references due to syntax rules,     */
+  /* and circular references in derived datatypes are also not possible due to sytax!                  */
+  /* All the circular referencing loops are reported, each with the list of all the POUs it contains.  */
   int initial_error_count = error_count;
-  for (int i = 0; i < symbol->n; i++) 
-    if (   (inserted_symbols.find(symbol->elements[i]) == inserted_symbols.end())            // if not copied to new AST
-        &&(  (NULL != dynamic_cast <function_block_declaration_c *>(symbol->elements[i]))    // and (is a FB  
-           ||(NULL != dynamic_cast <      function_declaration_c *>(symbol->elements[i]))))  //      or a Function)
-      STAGE3_ERROR(0, symbol->elements[i], symbol->elements[i], "POU (%s) contains a self-reference and/or belongs in a circular referencing loop", get_datatype_info_c::get_id_str(symbol->elements[i]));
+  int n = pou_nodes.size();
+  scc_index   .assign(n, -1);
+  scc_lowlink .assign(n, -1);
+  scc_on_stack.assign(n, false);
+  scc_stack   .clear();
+  scc_next_index = 0;
+  for (int i = 0; i < n; i++)
+    if (!pou_nodes[i].inserted && (NULL != pou_nodes[i].name) && (scc_index[i] < 0))
+      find_cycles(i);
   if (error_count == initial_error_count) ERROR; // We were unable to determine which POUs contain the circular references!!
 }
 
@@ -231,21 +281,41 @@ void *remove_forward_dependencies_c::visit(library_c *symbol) {
     if (NULL != dynamic_cast <data_type_declaration_c *>(symbol->elements[i]))
       new_tree->add_element(symbol->elements[i]);  
 
-  /* now do the POUs, in whatever order is necessary to guarantee no forward references. */    
-  long long int old_tree_pou_count = pou_count_c::get_count(symbol);
+  /* build the dependency graph of the POUs, visiting each POU only once. */
     // if no code generation pragma exists before the first entry in the library, the default is to enable code generation.
-  enable_code_generation_pragma_c *default_code_generation_pragma = new enable_code_generation_pragma_c; 
-  int prev_n;
-  cycle_count = 0;
-  do {
-    cycle_count++;
-    prev_n = new_tree->n;
-    current_code_generation_pragma = default_code_generation_pragma;
-    for (int i = 0; i < symbol->n; i++)  symbol->elements[i]->accept(*this);
-  } while (prev_n != new_tree->n); // repeat while new elementns are still being added to the new AST
+  current_code_generation_pragma = new enable_code_generation_pragma_c; 
+  pou_nodes.clear();
+  declaring_nodes.clear();
+  referencing_nodes.clear();
+  declared_names.clear();
+  for (int i = 0; i < symbol->n; i++)  symbol->elements[i]->accept(*this);
+
+  /* now insert the POUs, in whatever order is necessary to guarantee no forward references (a topological sort). */
+  /* Of all the POUs whose dependencies have already been inserted, the one declared first in the original AST is  */
+  /* always inserted next, so the original order is kept whenever possible.                                        */
+  std::priority_queue<int, std::vector<int>, std::greater<int> > ready;
+  for (size_t i = 0; i < pou_nodes.size(); i++)
+    if (0 == pou_nodes[i].pending) ready.push(i);
+  size_t inserted_count = 0;
+  while (!ready.empty()) {
+    pou_node_t &node = pou_nodes[ready.top()];
+    ready.pop();
+    node.inserted = true;
+    inserted_count++;
+    if (NULL == node.name) {new_tree->add_element(node.symbol); continue;} // unknown pragma
+    new_tree->add_element(node.code_generation_pragma);
+    new_tree->add_element(node.symbol);
+    /* an overloaded version of this same POU could have been inserted previously! */
+    std::string key = name_key(node.name);
+    if (!declared_names.insert(key).second) continue;
+    name_nodes_t::iterator referencing = referencing_nodes.find(key);
+    if (referencing == referencing_nodes.end()) continue;
+    for (size_t i = 0; i < referencing->second.size(); i++)
+      if (0 == --pou_nodes[referencing->second[i]].pending) ready.push(referencing->second[i]);
+  }
   
-  if (old_tree_pou_count != pou_count_c::get_count(new_tree)) 
-    print_circ_error(symbol);
+  if (inserted_count != pou_nodes.size()) 
+    print_circ_error();
 
   return NULL;
 }
@@ -292,9 +362,14 @@ void *remove_forward_dependencies_c::visit( enable_code_generation_pragma_c *sym
  */
 // TODO: print error message!
 void *remove_forward_dependencies_c::visit(pragma_c *symbol) {
-  if (1 != cycle_count) return NULL; // only handle unknown pragmas in the first cycle!
   STAGE3_WARNING(symbol, symbol, "Unrecognized pragma. Including the pragma when using the '-p' command line option for 'allow use of forward references' may result in unwanted behaviour.");
-  new_tree->add_element(symbol);
+  pou_node_t node;
+  node.symbol                 = symbol;
+  node.name                   = NULL;
+  node.code_generation_pragma = NULL;
+  node.pending                = 0;
+  node.inserted               = false;
+  pou_nodes.push_back(node);
   return NULL;
 }
 
@@ -47,12 +47,13 @@
 
 #include "../absyntax/absyntax.hh"
 #include "../absyntax/visitor.hh"
-#include "../util/symtable.hh"
 #include <set>
+#include <map>
+#include <vector>
+#include <string>
 
 
 class   find_forward_dependencies_c;
-typedef symtable_c<symbol_c *> identifiers_symbtable_t;
 
 
 
@@ -70,12 +71,30 @@ class remove_forward_dependencies_c: public search_visitor_c {
     int             error_count;
     bool            warning_found;
     library_c      *new_tree;
-    int             cycle_count; // main algorithm runs in a loop. The nuber of the current cycle...
-    // NOTE: we need two lists in order to correctly handle overloaded functions
-    identifiers_symbtable_t      declared_identifiers; // list of identifiers already declared by the symbols in the new tree
-    std::set <symbol_c *>        inserted_symbols;     // list of symbols already inserted in the new tree 
     symbol_c       *current_code_generation_pragma;    // points to any currently 'active' enable_code_generation_pragma_c
-    find_forward_dependencies_c    *find_forward_dependencies;  
+
+    /* The dependency graph of the POUs in the library, built in a single pass over the original AST.
+     * A POU depends on the (upper case) names of all the POUs it references. A name is declared by
+     * one, or more (overloaded functions), POUs. Unknown pragmas are included as nodes without dependencies.
+     */
+    typedef struct {
+      symbol_c                *symbol;                 // the POU (or unknown pragma) in the original AST
+      symbol_c                *name;                   // name of the POU (NULL for pragmas)
+      symbol_c                *code_generation_pragma; // the code generation pragma 'active' for this POU in the original AST
+      std::set<std::string>    references;             // names of the POUs referenced by this POU
+      int                      pending;                // number of referenced names not yet declared in the new tree
+      bool                     inserted;               // already inserted into the new tree
+    } pou_node_t;
+    typedef std::map<std::string, std::vector<int> > name_nodes_t; // name -> indexes into pou_nodes
+    std::vector<pou_node_t>      pou_nodes;
+    name_nodes_t                 declaring_nodes;      // the POUs declaring each name
+    name_nodes_t                 referencing_nodes;    // the POUs referencing each name
+    std::set<std::string>        declared_names;       // names already declared by the POUs in the new tree
+    find_forward_dependencies_c *find_forward_dependencies;
+    /* state of the search for circular referencing loops (Tarjan's strongly connected components algorithm) */
+    std::vector<int>             scc_index, scc_lowlink, scc_stack;
+    std::vector<bool>            scc_on_stack;
+    int                          scc_next_index;
 
   public:
      remove_forward_dependencies_c(void);
@@ -85,7 +104,9 @@ class remove_forward_dependencies_c: public search_visitor_c {
 
   private:
     void *handle_library_symbol(symbol_c *symbol, symbol_c *name, symbol_c *search1, symbol_c *search2 = NULL, symbol_c *search3 = NULL);
-    void  print_circ_error(library_c *symbol);
+    void  find_cycles(int node);
+    void  print_cycle(std::vector<int> &members);
+    void  print_circ_error(void);
 
     /***************************/
     /* B 0 - Programming Model */
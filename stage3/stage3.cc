@@ -46,6 +46,7 @@
 #include "declaration_check.hh"
 #include "enum_declaration_check.hh"
 #include "remove_forward_dependencies.hh"
+#include "../stats.hh"
 
 
 
@@ -89,6 +90,17 @@ static int constant_propagation(symbol_c *tree_root){
 }
 
 
+/* Propagation of the values assigned to variables inside each POU's body (e.g. 'mode := 3; ... IF mode = 3 THEN').
+ * This uses the datatype of each variable, so it must be run after type safety analysis, and only if no errors
+ * were found (i.e. if all datatypes were successfully determined).
+ */
+static int variable_propagation(symbol_c *tree_root){
+    constant_propagation_c constant_propagation(tree_root, true /* propagate_variables */);
+    tree_root->accept(constant_propagation);
+    return constant_propagation.get_error_count();
+}
+
+
 /* Type safety analysis assumes that 
  *    - flow control analysis 
  *    - constant folding (constant check)
@@ -97,13 +109,17 @@ static int constant_propagation(symbol_c *tree_root){
  */
 static int type_safety(symbol_c *tree_root){
 	fill_candidate_datatypes_c fill_candidate_datatypes(tree_root);
-	tree_root->accept(fill_candidate_datatypes);
+	{stats_timer_c timer("stage3/type_safety/fill_candidate_datatypes");
+	 tree_root->accept(fill_candidate_datatypes);}
 	narrow_candidate_datatypes_c narrow_candidate_datatypes(tree_root);
-	tree_root->accept(narrow_candidate_datatypes);
+	{stats_timer_c timer("stage3/type_safety/narrow_candidate_datatypes");
+	 tree_root->accept(narrow_candidate_datatypes);}
 	print_datatypes_error_c print_datatypes_error(tree_root);
-	tree_root->accept(print_datatypes_error);
+	{stats_timer_c timer("stage3/type_safety/print_datatypes_error");
+	 tree_root->accept(print_datatypes_error);}
 	forced_narrow_candidate_datatypes_c forced_narrow_candidate_datatypes(tree_root);
-	tree_root->accept(forced_narrow_candidate_datatypes);
+	{stats_timer_c timer("stage3/type_safety/forced_narrow_candidate_datatypes");
+	 tree_root->accept(forced_narrow_candidate_datatypes);}
 	return print_datatypes_error.get_error_count();
 }
 
@@ -155,17 +171,22 @@ static int remove_forward_dependencies(symbol_c *tree_root, symbol_c **ordered_t
 }
 
 
+/* Run one of the stage 3 passes, measuring the time it takes (for the '--stats' command line option) */
+#define RUN_PASS(pass, ...) {stats_timer_c timer("stage3/" #pass); error_count += pass(__VA_ARGS__);}
+
 int stage3(symbol_c *tree_root, symbol_c **ordered_tree_root) {
 	int error_count = 0;
-	error_count += enum_declaration_check(tree_root);
-	error_count += flow_control_analysis(tree_root);
-	error_count += constant_propagation(tree_root);
-	error_count += declaration_safety(tree_root);
-	error_count += type_safety(tree_root);
-	error_count += lvalue_check(tree_root);
-	error_count += array_range_check(tree_root);
-	error_count += case_elements_check(tree_root);
-	error_count += remove_forward_dependencies(tree_root, ordered_tree_root);
+	RUN_PASS(enum_declaration_check,      tree_root);
+	RUN_PASS(flow_control_analysis,       tree_root);
+	RUN_PASS(constant_propagation,        tree_root);
+	RUN_PASS(declaration_safety,          tree_root);
+	RUN_PASS(type_safety,                 tree_root);
+	RUN_PASS(lvalue_check,                tree_root);
+	if (DO_CONSTANT_PROPAGATION__ && (error_count == 0))
+	  RUN_PASS(variable_propagation,      tree_root);
+	RUN_PASS(array_range_check,           tree_root);
+	RUN_PASS(case_elements_check,         tree_root);
+	RUN_PASS(remove_forward_dependencies, tree_root, ordered_tree_root);
 	
 	if (error_count > 0) {
 		fprintf(stderr, "%d error(s) found. Bailing out!\n", error_count); 
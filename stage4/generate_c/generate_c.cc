@@ -28,6 +28,8 @@
 #include <typeinfo>
 #include <list>
 #include <map>
+#include <set>
+#include <vector>
 #include <sstream>
 #include <strings.h>
 
@@ -37,6 +39,8 @@
 #include "../../absyntax/visitor.hh"
 #include "../../absyntax_utils/absyntax_utils.hh"
 #include "../../main.hh" // required for ERROR() and ERROR_MSG() macros.
+#include "../../stats.hh"
+#include "../../config/config.h" // PACKAGE_VERSION
 
 #include "../stage4.hh"
 
@@ -86,6 +90,11 @@
 /* Idem as body, but for initializer FB function */
 #define FB_INIT_SUFFIX "_init__"
 
+/* Idem as initializer, but for the static function with the member initializations of a FB,
+ * used to build the pre-initialised image that the initializer then copies onto each instance.
+ */
+#define FB_INIT_IMAGE_SUFFIX "_init_image__"
+
 /* Idem as body, but for run CONFIG and RESOURCE function */
 #define FB_RUN_SUFFIX "_run__"
 
@@ -116,6 +125,8 @@
 #define DECLARE_EXTERNAL_FB "__DECLARE_EXTERNAL_FB"
 #define DECLARE_LOCATED "__DECLARE_LOCATED"
 #define DECLARE_GLOBAL_PROTOTYPE "__DECLARE_GLOBAL_PROTOTYPE"
+#define DECLARE_CONST "__DECLARE_CONST"
+#define DEFINE_CONST "__DEFINE_CONST"
 
 /* Variable declaration symbol for accessor macros */
 #define INIT_VAR "__INIT_VAR"
@@ -132,21 +143,25 @@
 #define GET_EXTERNAL "__GET_EXTERNAL"
 #define GET_EXTERNAL_FB "__GET_EXTERNAL_FB"
 #define GET_LOCATED "__GET_LOCATED"
+#define GET_CONST "__GET_CONST"
 
 #define GET_VAR_REF "__GET_VAR_REF"
 #define GET_EXTERNAL_REF "__GET_EXTERNAL_REF"
 #define GET_EXTERNAL_FB_REF "__GET_EXTERNAL_FB_REF"
 #define GET_LOCATED_REF "__GET_LOCATED_REF"
+#define GET_CONST_REF "__GET_CONST_REF"
 
 #define GET_VAR_DREF "__GET_VAR_DREF"
 #define GET_EXTERNAL_DREF "__GET_EXTERNAL_DREF"
 #define GET_EXTERNAL_FB_DREF "__GET_EXTERNAL_FB_DREF"
 #define GET_LOCATED_DREF "__GET_LOCATED_DREF"
+#define GET_CONST_DREF "__GET_CONST_DREF"
 
 #define GET_VAR_BY_REF "__GET_VAR_BY_REF"
 #define GET_EXTERNAL_BY_REF "__GET_EXTERNAL_BY_REF"
 #define GET_EXTERNAL_FB_BY_REF "__GET_EXTERNAL_FB_BY_REF"
 #define GET_LOCATED_BY_REF "__GET_LOCATED_BY_REF"
+#define GET_CONST_BY_REF "__GET_CONST_BY_REF"
 
 /* Variable setter symbol for accessor macros */
 #define SET_VAR "__SET_VAR"
@@ -178,13 +193,17 @@
 
 static int generate_line_directives__ = 0;
 static int generate_pou_filepairs__   = 0;
+static int generate_incremental__     = 0;
+static int generate_separate_pous__   = 0;
+static int generate_profiling__       = 0;
+static int inline_function_max_size__ = -1; /* -1: use the default (INLINE_FUNCTION_MAX_SIZE, see generate_c_inline.cc) */
 
 #ifdef __unix__
 /* Parse command line options passed from main.c !! */
 #include <stdlib.h> // for getsybopt()
 int  stage4_parse_options(char *options) {
-  enum {                    LINE_OPT = 0            ,  SEPTFILE_OPT              /*, SOME_OTHER_OPT, YET_ANOTHER_OPT */};
-  char *const token[] = { /*[LINE_OPT]=*/(char *)"l",/*SEPTFILE_OPT*/(char *)"p" /*, SOME_OTHER_OPT, ...             */, NULL };
+  enum {                    LINE_OPT = 0            ,  SEPTFILE_OPT              ,  INCREMENTAL_OPT             ,  SEPARATE_OPT              ,  PROFILE_OPT              ,  INLINE_OPT                   /*, SOME_OTHER_OPT, YET_ANOTHER_OPT */};
+  char *const token[] = { /*[LINE_OPT]=*/(char *)"l",/*SEPTFILE_OPT*/(char *)"p",/*INCREMENTAL_OPT*/(char *)"i",/*SEPARATE_OPT*/(char *)"s",/*PROFILE_OPT*/(char *)"t",/*INLINE_OPT*/(char *)"inline" /*, SOME_OTHER_OPT, ...             */, NULL };
   /* unfortunately, the above commented out syntax for array initialization is valid in C, but not in C++ */
   
   char *subopts = options;
@@ -195,6 +214,18 @@ int  stage4_parse_options(char *options) {
     switch (getsubopt(&subopts, token, &value)) {
       case     LINE_OPT: generate_line_directives__  = 1; break;
       case SEPTFILE_OPT: generate_pou_filepairs__    = 1; break;
+      case INCREMENTAL_OPT: generate_incremental__   = 1;
+                            generate_pou_filepairs__ = 1; break; /* incremental compilation works at the granularity of the POU file pairs */
+      case SEPARATE_OPT: generate_separate_pous__    = 1; break;
+      case  PROFILE_OPT: generate_profiling__        = 1; break;
+      case   INLINE_OPT: {
+                           char *end = NULL;
+                           inline_function_max_size__ = (NULL == value)? -1 : strtol(value, &end, 10);
+                           if ((inline_function_max_size__ < 0) || (end == value) || (*end != '\0')) {
+                             fprintf(stderr, "Option -O inline requires a size (e.g. -O inline=64)\n"); return -1;
+                           }
+                           break;
+                         }
       default          : fprintf(stderr, "Unrecognized option: -O %s\n", value); return -1; break;
      }
   }     
@@ -206,6 +237,12 @@ void stage4_print_options(void) {
   printf("          (options must be separated by commas. Example: 'l,w,x')\n"); 
   printf("      l : insert '#line' directives in generated C code.\n"); 
   printf("      p : place each POU in a separate pair of files (<pou_name>.c, <pou_name>.h).\n"); 
+  printf("      i : incremental compilation: do not re-generate the <pou_name>.c/.h files of POUs that have not changed (implies 'p').\n"); 
+  printf("      s : separate compilation: POUS.c (or each <pou_name>.c, with 'p') is a stand alone C translation unit,\n");
+  printf("          and is no longer #included by the RESOURCE .c files (it must be compiled and linked explicitly).\n"); 
+  printf("      t : measure the execution time of each FB and PROGRAM instance (see lib/C/iec_profile.h).\n"); 
+  printf("      inline=<n> : generate leaf FUNCTIONs whose body has up to <n> nodes as 'static inline' C functions\n");
+  printf("          (default: 128; 0 only inlines the FUNCTIONs marked with the {inline} pragma).\n");
 }
 #else /* not __unix__ */
 /* getsubopt isn't supported with mingw, 
@@ -226,6 +263,9 @@ int  stage4_parse_options(char *options) {}
 #include "generate_c_configbody.cc"
 #include "generate_location_list.cc"
 #include "generate_var_list.cc"
+#include "generate_profile_table.cc"
+#include "generate_c_en_eno.cc"
+#include "generate_c_inline.cc"
 
 /***********************************************************************/
 /***********************************************************************/
@@ -470,6 +510,50 @@ class analyse_variable_c: public search_visitor_c {
     }
     
     
+    /* returns true if the variable returned by find_first_nonfb() is a CONSTANT variable of a FB or PROGRAM,
+     * which is not stored in the FB's data structure but in a const C object (see generate_c_vardecl_c::constdecl_vf),
+     * or a VAR_EXTERNAL CONSTANT referring to a VAR_GLOBAL CONSTANT stored in a const C object (see global_const_analysis_c).
+     * The names of the POU (or configuration, or resource) and of the variable (to be passed to the __GET_CONST*() macros)
+     * are returned in pou_name and var_name.
+     * eg:
+     *      const1.real            returns TRUE, if const1 is declared in a VAR CONSTANT of the current FB
+     *      fb1.const1             returns TRUE, if const1 is declared in a VAR CONSTANT of the FB type of fb1
+     *      fb1.fb2                returns FALSE
+     */
+    static bool first_nonfb_is_static_const(symbol_c *symbol, symbol_c *scope, symbol_c **pou_name, symbol_c **var_name) {
+      if (NULL == symbol) ERROR;
+
+      /* variables whose datatype was not determined can only be looked up in the current scope */
+      if (get_datatype_info_c::is_type_valid(symbol->datatype)) {
+        if (NULL == find_first_nonfb(symbol)) return false;
+        if (NULL != singleton_->last_fb)
+          scope = singleton_->last_fb->datatype;
+        symbol = singleton_->first_non_fb_identifier;
+      }
+
+      if (NULL == scope) return false;
+      function_block_declaration_c *fb_decl = scope->as<function_block_declaration_c>();
+      program_declaration_c        *p_decl  = scope->as<program_declaration_c>();
+      if      (NULL != fb_decl) *pou_name = fb_decl->fblock_name;
+      else if (NULL != p_decl ) *pou_name = p_decl ->program_type_name;
+      else return false;
+
+      search_var_instance_decl_c search_var_instance_decl(scope);
+      if (search_var_instance_decl.get_option(symbol) != search_var_instance_decl_c::constant_opt) return false;
+      *var_name = get_var_name_c::get_name(symbol);
+      switch (search_var_instance_decl.get_vartype(symbol)) {
+        case search_var_instance_decl_c::private_vt:
+          return generate_c_vardecl_c::is_static_const_type(search_var_instance_decl.get_decl(symbol));
+        case search_var_instance_decl_c::external_vt:
+          /* a VAR_GLOBAL CONSTANT stored in a const C object of the configuration or resource (see global_const_analysis_c) */
+          *pou_name = global_const_analysis_c::get_domain(*var_name);
+          return (NULL != *pou_name);
+        default:
+          return false;
+      }
+    }
+    
+    
     /*********************/
     /* B 1.4 - Variables */
     /*********************/
@@ -536,8 +620,8 @@ analyse_variable_c *analyse_variable_c::singleton_ = NULL;
 unsigned long long calculate_time(symbol_c *symbol) {
   if (NULL == symbol) return 0;
   
-  interval_c *interval = dynamic_cast<interval_c *>(symbol);
-  duration_c *duration = dynamic_cast<duration_c *>(symbol);
+  interval_c *interval = symbol->as<interval_c>();
+  duration_c *duration = symbol->as<duration_c>();
   
   if ((NULL == interval) && (NULL == duration))
   	  {STAGE4_ERROR(symbol, symbol, "This type of interval value is not currently supported"); ERROR;}
@@ -757,6 +841,72 @@ void *generate_c_SFC_IL_ST_c::visit(statement_list_c *symbol) {
 
 
 
+/* Searches the VAR_EXTERNAL variables of a FUNCTION_BLOCK, and the FB instances it declares whose FB type
+ * has VAR_EXTERNAL variables (directly, or in its own FB instances). These are not shared with the image
+ * of the FB, but initialised on each instance (see generate_c_pous_c::handle_function_block()).
+ * The VAR_EXTERNAL variables of the VAR_GLOBAL CONSTANT variables stored in const C objects are not
+ * stored in the FB (see global_const_analysis_c), and are ignored.
+ */
+class search_fb_externals_c: public iterator_visitor_c {
+  public:
+    /* (FB type name, FB instance name) */
+    typedef std::vector<std::pair<symbol_c *, symbol_c *> > fb_instances_t;
+
+  private:
+    bool           found_externals;
+    fb_instances_t fb_instances;
+
+    search_fb_externals_c(function_block_declaration_c *fb_decl) {
+      found_externals = false;
+      fb_decl->var_declarations->accept(*this);
+    }
+
+  public:
+    /* The FB, or any of its FB instances, has VAR_EXTERNAL variables */
+    static bool has_externals(function_block_declaration_c *fb_decl) {
+      static std::map<symbol_c *, bool> results;
+      std::map<symbol_c *, bool>::iterator iter = results.find(fb_decl);
+      if (iter != results.end()) return iter->second;
+      search_fb_externals_c search_fb_externals(fb_decl);
+      return results[fb_decl] = (search_fb_externals.found_externals || !search_fb_externals.fb_instances.empty());
+    }
+
+    /* The FB itself declares VAR_EXTERNAL variables */
+    static bool declares_externals(function_block_declaration_c *fb_decl) {
+      search_fb_externals_c search_fb_externals(fb_decl);
+      return search_fb_externals.found_externals;
+    }
+
+    /* The FB instances declared in the FB, whose FB type has VAR_EXTERNAL variables */
+    static fb_instances_t get_fb_instances(function_block_declaration_c *fb_decl) {
+      search_fb_externals_c search_fb_externals(fb_decl);
+      return search_fb_externals.fb_instances;
+    }
+
+  private:
+    void *visit(external_declaration_c *symbol) {
+      if (NULL == global_const_analysis_c::get_domain(symbol->global_var_name))
+        found_externals = true;
+      return NULL;
+    }
+
+    void *visit(fb_name_decl_c *symbol) {
+      fb_spec_init_c *fb_spec_init = symbol->fb_spec_init->as<fb_spec_init_c>();
+      if (NULL == fb_spec_init) ERROR;
+      function_block_type_symtable_t::iterator iter = function_block_type_symtable.find(fb_spec_init->function_block_type_name);
+      if (iter == function_block_type_symtable.end()) ERROR; // The FB type MUST be in the symtable.
+      if (!has_externals(iter->second)) return NULL;
+      list_c *fb_name_list = dynamic_cast<list_c *>(symbol->fb_name_list);
+      if (NULL == fb_name_list) ERROR;
+      for (int i = 0; i < fb_name_list->n; i++)
+        fb_instances.push_back(std::make_pair(fb_spec_init->function_block_type_name, fb_name_list->elements[i]));
+      return NULL;
+    }
+};
+
+
+
+
 /***********************************************************************/
 /***********************************************************************/
 /***********************************************************************/
@@ -807,58 +957,32 @@ class generate_c_pous_c {
     /*   FUNCTION derived_function_name ':' elementary_type_name io_OR_function_var_declarations_list function_body END_FUNCTION */
     /* | FUNCTION derived_function_name ':' derived_type_name io_OR_function_var_declarations_list function_body END_FUNCTION */
     static void handle_function(function_declaration_c *symbol, stage4out_c &s4o, bool print_declaration) {
-      generate_c_vardecl_c          *vardecl = NULL;
-      generate_c_base_and_typeid_c   print_base(&s4o);
-      
-      TRACE("function_declaration_c");
-    
-      /* (A) Function declaration... */
-      /* (A.1) Function return type */
-      s4o.print("// FUNCTION\n");
-      symbol->type_name->accept(print_base); /* return type */
-      s4o.print(" ");
-      /* (A.2) Function name */
-      symbol->derived_function_name->accept(print_base);
-      s4o.print("(");
-    
-      /* (A.3) Function parameters */
-      s4o.indent_right();
-      vardecl = new generate_c_vardecl_c(&s4o,
-                                         generate_c_vardecl_c::finterface_vf,
-                                         generate_c_vardecl_c::input_vt    |
-                                         generate_c_vardecl_c::output_vt   |
-                                         generate_c_vardecl_c::inoutput_vt |
-                                         generate_c_vardecl_c::en_vt       |
-                                         generate_c_vardecl_c::eno_vt);
-      vardecl->print(symbol->var_declarations_list);
-      delete vardecl;
-      
-      s4o.indent_left();
-      
-      s4o.print(")");
-      
-      /* If we only want the declaration/prototype, then return!! */
-      if (print_declaration) 
-        {s4o.print(";\n"); return;}
-      
-      /* continue generating the function definition/code... */
-      s4o.print("\n" + s4o.indent_spaces + "{\n");
-    
-      /* (B) Function local variable declaration */
-      /* (B.1) Variables declared in ST source code */
-      s4o.indent_right();
-      
-      vardecl = new generate_c_vardecl_c(&s4o,
-                    generate_c_vardecl_c::localinit_vf,
-                    generate_c_vardecl_c::output_vt   |
-                    generate_c_vardecl_c::inoutput_vt |
-                    generate_c_vardecl_c::private_vt  |
-                    generate_c_vardecl_c::eno_vt);
-      vardecl->print(symbol->var_declarations_list);
-      delete vardecl;
-    
-      /* (B.2) Temporary variable for function's return value */
-      /* It will have the same name as the function itself! */
+      /* The definition of an inlined function is printed in POUS.h instead (see handle_inline_function()). */
+      if (!print_declaration && inline_function_analysis_c::is_inline(symbol))
+        return;
+      print_function(symbol, s4o, print_declaration);
+    }
+
+    /* Print the definition of a function generated as 'static inline' (see generate_c_inline.cc).
+     * Called once, with s4o referencing the POUS.h file, after the prototypes of all the POUs.
+     */
+    static void handle_inline_function(function_declaration_c *symbol, stage4out_c &s4o) {
+      print_function(symbol, s4o, false);
+    }
+
+  private:
+    static void print_function(function_declaration_c *symbol, stage4out_c &s4o, bool print_declaration) {
+      /* The lean variant (if any) is printed first, as it is called by the normal variant. */
+      if (en_eno_analysis_c::has_lean_variant(symbol))
+        handle_function_variant(symbol, s4o, print_declaration, true);
+      handle_function_variant(symbol, s4o, print_declaration, false);
+    }
+
+    /* Print the variable that will store the function's return value (if not VOID), initialised to the default value of its datatype.
+     * It will have the same name as the function itself!
+     */
+    static void print_return_variable(function_declaration_c *symbol, stage4out_c &s4o) {
+      generate_c_base_and_typeid_c print_base(&s4o);
       /* NOTE: matiec supports a non-standard syntax, in which functions do not return a value
        *       (declared as returning the special non-standard datatype VOID)
        *       e.g.:   FUNCTION foo: VOID
@@ -910,6 +1034,123 @@ class generate_c_pous_c {
           }
         }
       }
+    }
+
+
+    /* The normal variant of a function that also has a lean variant (see generate_c_en_eno.cc)
+     * only handles EN and ENO, and calls the lean variant.
+     */
+    static void print_en_eno_wrapper_body(function_declaration_c *symbol, stage4out_c &s4o) {
+      generate_c_base_and_typeid_c print_base(&s4o);
+      bool is_void = get_datatype_info_c::is_VOID(symbol->type_name->datatype);
+
+      s4o.print("\n" + s4o.indent_spaces + "{\n");
+      s4o.indent_right();
+      print_return_variable(symbol, s4o);
+      s4o.print(";\n\n");
+
+      s4o.print(s4o.indent_spaces + "// Control execution\n");
+      s4o.print(s4o.indent_spaces + "if (!EN) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "if (__ENO != NULL) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "*__ENO = __BOOL_LITERAL(FALSE);\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      if (!is_void) {
+        s4o.print(s4o.indent_spaces + "return ");
+        symbol->derived_function_name->accept(print_base);
+        s4o.print(";\n");
+      }
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+      s4o.print(s4o.indent_spaces + "if (__ENO != NULL) {\n");
+      s4o.indent_right();
+      s4o.print(s4o.indent_spaces + "*__ENO = __BOOL_LITERAL(TRUE);\n");
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n");
+
+      /* call the lean variant, passing on all parameters except EN and ENO */
+      s4o.print(s4o.indent_spaces + (is_void? "" : "return "));
+      symbol->derived_function_name->accept(print_base);
+      s4o.print(FUNCTION_LEAN_SUFFIX "(");
+      function_param_iterator_c fp_iterator(symbol);
+      identifier_c *param_name;
+      int nb_param = 0;
+      while ((param_name = fp_iterator.next()) != NULL) {
+        if (en_eno_analysis_c::is_en_eno_param(param_name)) continue;
+        if (nb_param++ > 0) s4o.print(", ");
+        if (   (fp_iterator.param_direction() == function_param_iterator_c::direction_out)
+            || (fp_iterator.param_direction() == function_param_iterator_c::direction_inout))
+          s4o.print("__");
+        param_name->accept(print_base);
+      }
+      s4o.print(");\n");
+
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}\n\n\n");
+    }
+
+
+    /* Print the normal variant of the function or, when 'lean' is true, the variant without the EN and ENO parameters. */
+    static void handle_function_variant(function_declaration_c *symbol, stage4out_c &s4o, bool print_declaration, bool lean) {
+      generate_c_vardecl_c          *vardecl = NULL;
+      generate_c_base_and_typeid_c   print_base(&s4o);
+      
+      TRACE("function_declaration_c");
+    
+      /* (A) Function declaration... */
+      /* (A.1) Function return type */
+      s4o.print("// FUNCTION\n");
+      if (inline_function_analysis_c::is_inline(symbol))
+        s4o.print("static inline ");
+      symbol->type_name->accept(print_base); /* return type */
+      s4o.print(" ");
+      /* (A.2) Function name */
+      symbol->derived_function_name->accept(print_base);
+      if (lean) s4o.print(FUNCTION_LEAN_SUFFIX);
+      s4o.print("(");
+    
+      /* (A.3) Function parameters */
+      s4o.indent_right();
+      vardecl = new generate_c_vardecl_c(&s4o,
+                                         generate_c_vardecl_c::finterface_vf,
+                                         generate_c_vardecl_c::input_vt    |
+                                         generate_c_vardecl_c::output_vt   |
+                                         generate_c_vardecl_c::inoutput_vt |
+                                         (lean? 0 : generate_c_vardecl_c::en_vt | generate_c_vardecl_c::eno_vt));
+      vardecl->print(symbol->var_declarations_list);
+      delete vardecl;
+      
+      s4o.indent_left();
+      
+      s4o.print(")");
+      
+      /* If we only want the declaration/prototype, then return!! */
+      if (print_declaration) 
+        {s4o.print(";\n"); return;}
+      
+      if (!lean && en_eno_analysis_c::has_lean_variant(symbol))
+        {print_en_eno_wrapper_body(symbol, s4o); return;}
+      
+      /* continue generating the function definition/code... */
+      s4o.print("\n" + s4o.indent_spaces + "{\n");
+    
+      /* (B) Function local variable declaration */
+      /* (B.1) Variables declared in ST source code */
+      s4o.indent_right();
+      
+      vardecl = new generate_c_vardecl_c(&s4o,
+                    generate_c_vardecl_c::localinit_vf,
+                    generate_c_vardecl_c::output_vt   |
+                    generate_c_vardecl_c::inoutput_vt |
+                    generate_c_vardecl_c::private_vt  |
+                    (lean? 0 : generate_c_vardecl_c::eno_vt));
+      vardecl->print(symbol->var_declarations_list);
+      delete vardecl;
+    
+      /* (B.2) Temporary variable for function's return value */
+      print_return_variable(symbol, s4o);
       s4o.print(";\n\n");
       
       
@@ -919,7 +1160,8 @@ class generate_c_pous_c {
       identifier_c  en_var("EN");
       identifier_c eno_var("ENO");
       if (   (search_var.get_vartype(& en_var) == search_var_instance_decl_c::input_vt)
-          && (search_var.get_vartype(&eno_var) == search_var_instance_decl_c::output_vt)) {
+          && (search_var.get_vartype(&eno_var) == search_var_instance_decl_c::output_vt)
+          && !lean) {
         s4o.print(s4o.indent_spaces + "// Control execution\n");
         s4o.print(s4o.indent_spaces + "if (!EN) {\n");
         s4o.indent_right();
@@ -947,7 +1189,7 @@ class generate_c_pous_c {
                     generate_c_vardecl_c::foutputassign_vf,
                     generate_c_vardecl_c::output_vt   |
                     generate_c_vardecl_c::inoutput_vt |
-                    generate_c_vardecl_c::eno_vt);
+                    (lean? 0 : generate_c_vardecl_c::eno_vt));
       vardecl->print(symbol->var_declarations_list);
       delete vardecl;
       
@@ -1020,15 +1262,29 @@ class generate_c_pous_c {
         sfcdecl->generate(symbol->fblock_body, generate_c_sfcdecl_c::sfcdecl_sd);
         delete sfcdecl;
         s4o.print("\n");
+
+        /* Execution time counters ('-O t' option) */
+        if (generate_profiling__)
+          s4o.print(s4o.indent_spaces + "__IEC_PROFILE_t __profile;\n\n");
       
         /* (A.5) Function Block data structure type name. */
         s4o.indent_left();
         s4o.print("} ");
         symbol->fblock_name->accept(print_base);
         s4o.print(";\n\n");
+
+        /* CONSTANT variables, stored in const C objects instead of the data structure */
+        vardecl = new generate_c_vardecl_c(&s4o, generate_c_vardecl_c::constdecl_vf, generate_c_vardecl_c::private_vt);
+        vardecl->print(symbol->var_declarations, symbol->fblock_name);
+        delete vardecl;
       }
       
       if (!print_declaration) {
+        /* Definition of the const C objects of the CONSTANT variables (declared in the .h file) */
+        vardecl = new generate_c_vardecl_c(&s4o, generate_c_vardecl_c::constdef_vf, generate_c_vardecl_c::private_vt);
+        vardecl->print(symbol->var_declarations, symbol->fblock_name);
+        delete vardecl;
+
         /* (A.6) Function Block inline function declaration for function invocation */
         generate_c_inlinefcall_c *inlinedecl = new generate_c_inlinefcall_c(&s4o, symbol->fblock_name, symbol, FB_FUNCTION_PARAM"->");
         symbol->fblock_body->accept(*inlinedecl);
@@ -1036,22 +1292,49 @@ class generate_c_pous_c {
       }
       
       /* (B) Constructor */
-      /* (B.1) Constructor name... */
-      s4o.print(s4o.indent_spaces + "void ");
-      symbol->fblock_name->accept(print_base);
-      s4o.print(FB_INIT_SUFFIX);
-      s4o.print("(");
-    
-      /* first and only parameter is a pointer to the data */
-      symbol->fblock_name->accept(print_base);
-      s4o.print(" *");
-      s4o.print(FB_FUNCTION_PARAM);
-      s4o.print(", BOOL retain)");
-
+      /* The member initializations are not printed in the constructor itself, but in a static
+       * function that is used to build a pre-initialised image of the FB (with retain == 0).
+       * The constructor builds the image the first time it is called, and then simply copies
+       * it onto the instance, instead of executing the (long) list of member initializations
+       * for every instance of the FB. Only when retain is set are the member initializations
+       * executed again on the instance, to set the retain flags.
+       * The image may be shared by all instances since every value it contains is the same
+       * for all of them: the initial values are constants.
+       * The VAR_EXTERNAL variables are left out of the image, and are initialised on each instance
+       * after copying the image, as the global variable a pointer refers to may depend on the
+       * instance, and its address may not yet be known when the image is built (e.g. a located
+       * global variable, when an instance is initialised before the CONFIGURATION initialised the
+       * global). For the same reason, the FB instances whose FB type has VAR_EXTERNAL variables
+       * (see search_fb_externals_c) are initialised again on each instance.
+       * NOTE: REF_TO variables may only be initialised to NULL, so the image never contains
+       *       a pointer into itself.
+       * NOTE: FBs may not declare located variables with an initial value (only PROGRAMs may),
+       *       so building the image never writes to any location (__INIT_LOCATED_VALUE).
+       * NOTE: Since the image is copied onto the instance, all flags of the instance's variables
+       *       (including the force flags) are reset to the values they have in the image, instead
+       *       of keeping the flags the variables had before the constructor was called.
+       */
       if (print_declaration) {
-        s4o.print(";\n");
+        /* (B.1) Constructor name... */
+        s4o.print(s4o.indent_spaces + "void ");
+        symbol->fblock_name->accept(print_base);
+        s4o.print(FB_INIT_SUFFIX);
+        s4o.print("(");
+        /* first and only parameter is a pointer to the data */
+        symbol->fblock_name->accept(print_base);
+        s4o.print(" *");
+        s4o.print(FB_FUNCTION_PARAM);
+        s4o.print(", BOOL retain);\n");
       } else {
-        s4o.print(" {\n");
+        /* (B.1) Image builder name... */
+        s4o.print(s4o.indent_spaces + "static void ");
+        symbol->fblock_name->accept(print_base);
+        s4o.print(FB_INIT_IMAGE_SUFFIX);
+        s4o.print("(");
+        symbol->fblock_name->accept(print_base);
+        s4o.print(" *");
+        s4o.print(FB_FUNCTION_PARAM);
+        s4o.print(", BOOL retain) {\n");
         s4o.indent_right();
       
         /* (B.2) Member initializations... */
@@ -1063,12 +1346,13 @@ class generate_c_pous_c {
                                            generate_c_vardecl_c::inoutput_vt |
                                            generate_c_vardecl_c::private_vt  |
                                            generate_c_vardecl_c::located_vt  |
-                                           generate_c_vardecl_c::external_vt |
                                            generate_c_vardecl_c::en_vt       |
                                            generate_c_vardecl_c::eno_vt);
         vardecl->print(symbol->var_declarations, NULL, FB_FUNCTION_PARAM"->");
         delete vardecl;
         s4o.print("\n");
+        if (generate_profiling__)
+          s4o.print(s4o.indent_spaces + "__PROFILE_INIT(" FB_FUNCTION_PARAM "->__profile)\n");
             
         /* (B.3) Generate private internal variables for SFC */
         sfcdecl = new generate_c_sfcdecl_c(&s4o, symbol, FB_FUNCTION_PARAM"->");
@@ -1077,6 +1361,67 @@ class generate_c_pous_c {
         s4o.indent_left();
         s4o.print(s4o.indent_spaces + "}\n\n");
 
+        /* (B.4) Constructor, copying the image onto the instance */
+        s4o.print(s4o.indent_spaces + "void ");
+        symbol->fblock_name->accept(print_base);
+        s4o.print(FB_INIT_SUFFIX);
+        s4o.print("(");
+        symbol->fblock_name->accept(print_base);
+        s4o.print(" *");
+        s4o.print(FB_FUNCTION_PARAM);
+        s4o.print(", BOOL retain) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces + "static ");
+        symbol->fblock_name->accept(print_base);
+        s4o.print(" __image;\n");
+        s4o.print(s4o.indent_spaces + "static BOOL __image_valid = 0;\n");
+        s4o.print(s4o.indent_spaces + "if (!__image_valid) {\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces);
+        symbol->fblock_name->accept(print_base);
+        s4o.print(FB_INIT_IMAGE_SUFFIX);
+        s4o.print("(&__image, 0);\n");
+        s4o.print(s4o.indent_spaces + "__image_valid = 1;\n");
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n");
+        s4o.print(s4o.indent_spaces + "memcpy(" FB_FUNCTION_PARAM ", &__image, sizeof(");
+        symbol->fblock_name->accept(print_base);
+        s4o.print("));\n");
+        s4o.print(s4o.indent_spaces + "if (retain)\n");
+        s4o.indent_right();
+        s4o.print(s4o.indent_spaces);
+        symbol->fblock_name->accept(print_base);
+        s4o.print(FB_INIT_IMAGE_SUFFIX);
+        s4o.print("(" FB_FUNCTION_PARAM ", retain);\n");
+        s4o.indent_left();
+        search_fb_externals_c::fb_instances_t fb_instances = search_fb_externals_c::get_fb_instances(symbol);
+        if (!fb_instances.empty()) {
+          s4o.print(s4o.indent_spaces + "else {\n");
+          s4o.indent_right();
+          for (size_t i = 0; i < fb_instances.size(); i++) {
+            s4o.print(s4o.indent_spaces);
+            fb_instances[i].first->accept(print_base);
+            s4o.print(FB_INIT_SUFFIX);
+            s4o.print("(&" FB_FUNCTION_PARAM "->");
+            fb_instances[i].second->accept(print_base);
+            s4o.print(",retain);\n");
+          }
+          s4o.indent_left();
+          s4o.print(s4o.indent_spaces + "}\n");
+        }
+        /* (B.5) VAR_EXTERNAL variables, left out of the image */
+        if (search_fb_externals_c::declares_externals(symbol)) {
+          s4o.print(s4o.indent_spaces);
+          vardecl = new generate_c_vardecl_c(&s4o,
+                                             generate_c_vardecl_c::constructorinit_vf,
+                                             generate_c_vardecl_c::external_vt);
+          vardecl->print(symbol->var_declarations, NULL, FB_FUNCTION_PARAM"->");
+          delete vardecl;
+          s4o.print("\n");
+        }
+        s4o.indent_left();
+        s4o.print(s4o.indent_spaces + "}\n\n");
+
         /* (C) Function with FB body */
         /* (C.1) Step definitions */
         sfcdecl->generate(symbol->fblock_body, generate_c_sfcdecl_c::stepdef_sd);
@@ -1104,6 +1449,8 @@ class generate_c_pous_c {
       } else {
         s4o.print(" {\n");
         s4o.indent_right();
+        if (generate_profiling__)
+          s4o.print(s4o.indent_spaces + "unsigned long long __profile_start__;\n\n");
 
         // Only generate the code that controls the execution of the function's body if the
         // function contains a declaration of both the EN and ENO variables
@@ -1138,6 +1485,10 @@ class generate_c_pous_c {
           s4o.indent_left();
           s4o.print(s4o.indent_spaces + "}\n");
         }
+
+        /* The time is only measured when the FB body is actually executed (i.e. with EN set to TRUE) */
+        if (generate_profiling__)
+          s4o.print(s4o.indent_spaces + "__PROFILE_START(__profile_start__)\n");
       
         /* (C.4) Initialize TEMP variables */
         /* function body */
@@ -1153,6 +1504,8 @@ class generate_c_pous_c {
         generate_c_SFC_IL_ST_c generate_c_code(&s4o, symbol->fblock_name, symbol, FB_FUNCTION_PARAM"->");
         symbol->fblock_body->accept(generate_c_code);
         print_end_of_block_label(s4o);
+        if (generate_profiling__)
+          s4o.print(s4o.indent_spaces + "__PROFILE_STOP(" FB_FUNCTION_PARAM "->__profile, __profile_start__)\n");
         s4o.print(s4o.indent_spaces + "return;\n");
         s4o.indent_left();
         s4o.print(s4o.indent_spaces + "} // ");
@@ -1229,15 +1582,29 @@ class generate_c_pous_c {
         sfcdecl->generate(symbol->function_block_body, generate_c_sfcdecl_c::sfcdecl_sd);
         delete sfcdecl;
         s4o.print("\n");
+
+        /* Execution time counters ('-O t' option) */
+        if (generate_profiling__)
+          s4o.print(s4o.indent_spaces + "__IEC_PROFILE_t __profile;\n\n");
         
         /* (A.5) Program data structure type name. */
         s4o.indent_left();
         s4o.print("} ");
         symbol->program_type_name->accept(print_base);
         s4o.print(";\n\n");
+
+        /* CONSTANT variables, stored in const C objects instead of the data structure */
+        vardecl = new generate_c_vardecl_c(&s4o, generate_c_vardecl_c::constdecl_vf, generate_c_vardecl_c::private_vt);
+        vardecl->print(symbol->var_declarations, symbol->program_type_name);
+        delete vardecl;
       }
       
-      if (!print_declaration) {      
+      if (!print_declaration) {
+        /* Definition of the const C objects of the CONSTANT variables (declared in the .h file) */
+        vardecl = new generate_c_vardecl_c(&s4o, generate_c_vardecl_c::constdef_vf, generate_c_vardecl_c::private_vt);
+        vardecl->print(symbol->var_declarations, symbol->program_type_name);
+        delete vardecl;
+      
         /* (A.6) Function Block inline function declaration for function invocation */
         generate_c_inlinefcall_c *inlinedecl = new generate_c_inlinefcall_c(&s4o, symbol->program_type_name, symbol, FB_FUNCTION_PARAM"->");
         symbol->function_block_body->accept(*inlinedecl);
@@ -1276,6 +1643,8 @@ class generate_c_pous_c {
         vardecl->print(symbol->var_declarations, NULL,  FB_FUNCTION_PARAM"->");
         delete vardecl;
         s4o.print("\n");
+        if (generate_profiling__)
+          s4o.print(s4o.indent_spaces + "__PROFILE_INIT(" FB_FUNCTION_PARAM "->__profile)\n");
       
         /* (B.3) Generate private internal variables for SFC */
         sfcdecl = new generate_c_sfcdecl_c(&s4o, symbol, FB_FUNCTION_PARAM"->");
@@ -1377,7 +1746,9 @@ class generate_c_config_c: public generate_c_base_and_typeid_c {
       initprotos_dt,
       initdeclare_dt,
       runprotos_dt,
-      rundeclare_dt
+      rundeclare_dt,
+      profileprotos_dt,
+      profiledeclare_dt
     } declaretype_t;
 
     declaretype_t wanted_declaretype;
@@ -1459,6 +1830,24 @@ void *visit(configuration_declaration_c *symbol) {
   delete vardecl;
   s4o_incl.print("\n");
 
+  /* (A.4) Declare the resources' global prototypes in include file too (the POUs are not compiled
+   *       within the RESOURCE's C file when doing separate compilation, so they need these prototypes).
+   */
+  if (generate_separate_pous__) {
+    resource_declaration_list_c *resource_list = symbol->resource_declarations->as<resource_declaration_list_c>();
+    for (int i = 0; (NULL != resource_list) && (i < resource_list->n); i++) {
+      resource_declaration_c *resource = resource_list->elements[i]->as<resource_declaration_c>();
+      if ((NULL == resource) || (NULL == resource->global_var_declarations)) continue;
+      vardecl = new generate_c_vardecl_c(&s4o_incl,
+                                         generate_c_vardecl_c::globalprototype_vf,
+                                         generate_c_vardecl_c::global_vt,
+                                         resource->resource_name);
+      vardecl->print(resource->global_var_declarations);
+      delete vardecl;
+      s4o_incl.print("\n");
+    }
+  }
+
   /* (B) Initialisation Function */
   /* (B.1) Ressources initialisation protos... */
   wanted_declaretype = initprotos_dt;
@@ -1513,6 +1902,30 @@ void *visit(configuration_declaration_c *symbol) {
   s4o.indent_left();
   s4o.print(s4o.indent_spaces + "}\n");
 
+  /* (D) Execution time counters of the POU instances ('-O t' option) */
+  if (generate_profiling__) {
+    /* (D.1) Resources tables... */
+    s4o.print("\n");
+    wanted_declaretype = profileprotos_dt;
+    symbol->resource_declarations->accept(*this);
+    s4o.print("\n");
+    s4o.print(s4o.indent_spaces + "static __IEC_PROFILE_ENTRY_t *profile_tables__[] = {\n");
+    s4o.indent_right();
+    wanted_declaretype = profiledeclare_dt;
+    symbol->resource_declarations->accept(*this);
+    s4o.print(s4o.indent_spaces + "NULL\n");
+    s4o.indent_left();
+    s4o.print(s4o.indent_spaces + "};\n\n");
+
+    /* (D.2) Runtime API (see lib/C/iec_profile.h)... */
+    s4o.print(s4o.indent_spaces + "__IEC_PROFILE_ENTRY_t *config_profile_entry__(unsigned int n) {\n");
+    s4o.print(s4o.indent_spaces + "  return __profile_entry(profile_tables__, n);\n");
+    s4o.print(s4o.indent_spaces + "}\n\n");
+    s4o.print(s4o.indent_spaces + "void config_profile_reset__(void) {\n");
+    s4o.print(s4o.indent_spaces + "  __profile_reset(profile_tables__);\n");
+    s4o.print(s4o.indent_spaces + "}\n");
+  }
+
   return NULL;
 }
 
@@ -1541,6 +1954,16 @@ void *visit(resource_declaration_c *symbol) {
       s4o.print("(tick);\n");
     }
   }
+  if (wanted_declaretype == profileprotos_dt) {
+    s4o.print(s4o.indent_spaces + "extern __IEC_PROFILE_ENTRY_t ");
+    symbol->resource_name->accept(*this);
+    s4o.print("_profile_table__[];\n");
+  }
+  if (wanted_declaretype == profiledeclare_dt) {
+    s4o.print(s4o.indent_spaces);
+    symbol->resource_name->accept(*this);
+    s4o.print("_profile_table__,\n");
+  }
   return NULL;
 }
 
@@ -1567,6 +1990,10 @@ void *visit(single_resource_declaration_c *symbol) {
       s4o.print("(tick);\n");
     }
   }
+  if (wanted_declaretype == profileprotos_dt)
+    s4o.print(s4o.indent_spaces + "extern __IEC_PROFILE_ENTRY_t RESOURCE_profile_table__[];\n");
+  if (wanted_declaretype == profiledeclare_dt)
+    s4o.print(s4o.indent_spaces + "RESOURCE_profile_table__,\n");
   return NULL;
 }
 
@@ -1774,8 +2201,9 @@ END_RESOURCE
         s4o.print("\n");
       }
       
-      /* (A.3) POUs inclusion */
-      s4o.print("#include \"POUS.c\"\n\n");
+      /* (A.3) POUs inclusion (when doing separate compilation, POUS.c is compiled on its own) */
+      if (!generate_separate_pous__)
+        s4o.print("#include \"POUS.c\"\n\n");
       
       wanted_declaretype = declare_dt;
       
@@ -1840,6 +2268,12 @@ END_RESOURCE
       
       s4o.indent_left();
       s4o.print("}\n\n");
+
+      /* (D) Table of the execution time counters of the POU instances ('-O t' option) */
+      if (generate_profiling__) {
+        generate_profile_table_c generate_profile_table(&s4o, current_resource_name);
+        symbol->program_configuration_list->accept(generate_profile_table);
+      }
       
       if (single_resource) {
         delete current_resource_name;
@@ -1879,7 +2313,7 @@ END_RESOURCE
           s4o.print(");\n");
           break;
         case run_dt: 
-          { identifier_c *tmp_id = dynamic_cast<identifier_c*>(symbol->program_name);
+          { identifier_c *tmp_id = symbol->program_name->as<identifier_c>();
             if (NULL == tmp_id) ERROR;
             current_program_name = tmp_id->value;
 	  }
@@ -1895,12 +2329,25 @@ END_RESOURCE
           if (symbol->prog_conf_elements != NULL)
             symbol->prog_conf_elements->accept(*this);
           
+          /* the execution time of the PROGRAM is measured here, and not inside the <program>_body__() function */
+          if (generate_profiling__ && generate_profile_table_c::is_profiled(symbol->program_type_name)) {
+            s4o.print(s4o.indent_spaces + "{unsigned long long __profile_start__;\n");
+            s4o.indent_right();
+            s4o.print(s4o.indent_spaces + "__PROFILE_START(__profile_start__)\n");
+          }
           s4o.print(s4o.indent_spaces);
           symbol->program_type_name->accept(*this);
           s4o.print(FB_FUNCTION_SUFFIX);
           s4o.print("(&");
           symbol->program_name->accept(*this);
           s4o.print(");\n");
+          if (generate_profiling__ && generate_profile_table_c::is_profiled(symbol->program_type_name)) {
+            s4o.print(s4o.indent_spaces + "__PROFILE_STOP(");
+            symbol->program_name->accept(*this);
+            s4o.print(".__profile, __profile_start__)\n");
+            s4o.indent_left();
+            s4o.print(s4o.indent_spaces + "}\n");
+          }
           
           wanted_assigntype = send_at;
           if (symbol->prog_conf_elements != NULL)
@@ -2110,6 +2557,101 @@ END_RESOURCE
 /***********************************************************************/
 /***********************************************************************/
 
+/* Cache of the fingerprints of the POUs for which C code was generated in a previous run of iec2c.
+ * Used for incremental compilation ('-O i' option), so that the <pou_name>.c and <pou_name>.h files
+ * are only re-generated for POUs that were changed (or that reference changed datatypes/POUs).
+ *
+ * The cache is stored in a text file in the build directory, with the format:
+ *     iec2c-fingerprints <version> <compiler version> <options>
+ *     <pou_name> <fingerprint>
+ *     ...
+ * The cache is discarded if it was generated by another version of the compiler (whose generated code
+ * may differ), or with other code generation options.
+ */
+#define FINGERPRINT_CACHE_FILE    ".iec2c_fingerprints"
+#define FINGERPRINT_CACHE_VERSION 2
+
+class generate_c_fingerprint_cache_c {
+  private:
+    typedef std::map<std::string, std::string> cache_t;
+    cache_t     old_cache, new_cache;
+    std::string filename;
+    std::string options;
+    pou_fingerprint_c *fingerprints;
+
+  public:
+    generate_c_fingerprint_cache_c(const char *builddir, symbol_c *tree_root) {
+      if (NULL != builddir) {filename = builddir; filename += "/";}
+      filename += FINGERPRINT_CACHE_FILE;
+      std::ostringstream opts;
+      opts << "e" << runtime_options.disable_implicit_en_eno << "l" << generate_line_directives__ << "s" << generate_separate_pous__ << "t" << generate_profiling__;
+      /* the code generated for a POU also depends on the use of EN and ENO by the other POUs */
+      opts << "n" << en_eno_analysis_c::digest();
+      /* ... and on the FUNCTIONs that are inlined (these have no code in their <pou_name>.c file) */
+      opts << "f" << inline_function_analysis_c::digest();
+      /* ... and on the VAR_GLOBAL CONSTANT variables the POUs access directly */
+      opts << "g" << global_const_analysis_c::digest();
+      options = opts.str();
+      fingerprints = new pou_fingerprint_c(tree_root, generate_line_directives__ /* line numbers are printed in the generated code */);
+      load();
+    }
+
+    ~generate_c_fingerprint_cache_c(void) {
+      delete fingerprints;
+    }
+
+    /* Determine the fingerprint of the POU, and return true if it is unchanged since the last run. */
+    bool is_unchanged(symbol_c *pou, const char *pou_name) {
+      char fingerprint[17];
+      snprintf(fingerprint, sizeof(fingerprint), "%016" PRIx64, (uint64_t)fingerprints->get(pou));
+      new_cache[pou_name] = fingerprint;
+      cache_t::iterator iter = old_cache.find(pou_name);
+      return ((iter != old_cache.end()) && (iter->second == fingerprint));
+    }
+
+    void save(void) {
+      FILE *file = fopen(filename.c_str(), "w");
+      if (NULL == file) return; /* not fatal: next run will simply re-generate everything */
+      fprintf(file, "iec2c-fingerprints %d %s %s\n", FINGERPRINT_CACHE_VERSION, PACKAGE_VERSION, options.c_str());
+      for (cache_t::iterator iter = new_cache.begin(); iter != new_cache.end(); ++iter)
+        fprintf(file, "%s %s\n", iter->first.c_str(), iter->second.c_str());
+      fclose(file);
+    }
+
+  private:
+    void load(void) {
+      FILE *file = fopen(filename.c_str(), "r");
+      if (NULL == file) return; /* no cache => first run */
+      char name[1024], value[1024];
+      int  version;
+      if (   (fscanf(file, "iec2c-fingerprints %d %1023s %1023s", &version, name, value) == 3)
+          && (version == FINGERPRINT_CACHE_VERSION) && (0 == strcmp(name, PACKAGE_VERSION)) && (options == value)) {
+        while (fscanf(file, "%1023s %1023s", name, value) == 2)
+          old_cache[name] = value;
+      }
+      fclose(file);
+    }
+};
+
+
+/* Check whether a previously generated file is still in the build directory */
+static bool file_exists(const char *dir, const char *radix, const char *extension) {
+  std::string filepath("");
+  if (dir != NULL) {filepath += dir; filepath += "/";}
+  filepath += radix; filepath += "."; filepath += extension;
+  FILE *file = fopen(filepath.c_str(), "r");
+  if (NULL == file) return false;
+  fclose(file);
+  return true;
+}
+
+
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+
+
 class generate_c_c: public iterator_visitor_c {
   protected:
     stage4out_c                      &s4o;
@@ -2127,6 +2669,8 @@ class generate_c_c: public iterator_visitor_c {
     const char *current_name;
     const char *current_builddir;
 
+    generate_c_fingerprint_cache_c *fingerprint_cache;
+
     bool        allow_output;
     
     unsigned long long common_ticktime;
@@ -2143,6 +2687,7 @@ class generate_c_c: public iterator_visitor_c {
     {
       current_builddir = builddir;
       current_configuration = NULL;
+      fingerprint_cache = NULL;
       allow_output = true;
     }
             
@@ -2190,10 +2735,54 @@ class generate_c_c: public iterator_visitor_c {
       
       pous_incl_s4o.print("#include \"accessor.h\"\n#include \"iec_std_lib.h\"\n\n");
 
+      if (generate_profiling__) {
+        pous_incl_s4o.print("#include \"iec_profile.h\"\n\n");
+        generate_profile_table_c::collect_profiled_pous(symbol);
+      }
+
+      /* When doing separate compilation, POUS.c is a translation unit of its own. */
+      if (generate_separate_pous__ && !generate_pou_filepairs__)
+        pous_s4o.print("#include \"POUS.h\"\n\n");
+
+      en_eno_analysis_c::analyse(symbol);
+      inline_function_analysis_c::analyse(symbol);
+      global_const_analysis_c::analyse(symbol);
+
+      if (generate_incremental__)
+        fingerprint_cache = new generate_c_fingerprint_cache_c(current_builddir, symbol);
+
       for(int i = 0; i < symbol->n; i++) {
         symbol->elements[i]->accept(*this);
       }
 
+      if (NULL != fingerprint_cache) {
+        fingerprint_cache->save();
+        delete fingerprint_cache;
+        fingerprint_cache = NULL;
+      }
+
+      /* When doing separate compilation, the POUs also need the prototypes of the global variables
+       * (in the RESOURCE's C file they get them from the CONFIGURATION's .h file, included before "POUS.c").
+       */
+      if (generate_separate_pous__) {
+        for(int i = 0; i < symbol->n; i++) {
+          configuration_declaration_c *configuration = symbol->elements[i]->as<configuration_declaration_c>();
+          if (NULL == configuration) continue;
+          configuration->configuration_name->accept(*this);
+          pous_incl_s4o.print("#include \"");
+          pous_incl_s4o.print(current_name);
+          pous_incl_s4o.print(".h\"\n\n");
+          break; /* C code generation only supports a single configuration */
+        }
+      }
+
+      /* The definitions of the inlined FUNCTIONs, which may use any of the datatypes declared above. */
+      for(int i = 0; i < symbol->n; i++) {
+        function_declaration_c *f_decl = symbol->elements[i]->as<function_declaration_c>();
+        if ((NULL != f_decl) && inline_function_analysis_c::is_inline(f_decl))
+          generate_c_pous_c::handle_inline_function(f_decl, pous_incl_s4o);
+      }
+
       pous_incl_s4o.print("#endif //__POUS_H\n");
       
       generate_var_list_c generate_var_list(&variables_s4o, symbol);
@@ -2245,8 +2834,14 @@ class generate_c_c: public iterator_visitor_c {
       if (!allow_output) return NULL;\
       if (generate_pou_filepairs__) {\
         const char *pou_name = get_datatype_info_c::get_id_str(pname);\
+        if (   (NULL != fingerprint_cache) && fingerprint_cache->is_unchanged(symbol, pou_name)\
+            && file_exists(current_builddir, pou_name, "c") && file_exists(current_builddir, pou_name, "h")) {\
+          /* incremental compilation: re-use the files generated in a previous run. */\
+          std::cout << pou_name << ".c\n" << pou_name << ".h\n";\
+        } else {\
         stage4out_c s4o_c(current_builddir, pou_name, "c");\
         stage4out_c s4o_h(current_builddir, pou_name, "h");\
+        if (generate_separate_pous__) s4o_c.print("#include \"POUS.h\"\n");\
         s4o_c.print("#include \""); s4o_c.print(pou_name); s4o_c.print(".h\"\n");\
         s4o_h.print("#ifndef __");  s4o_h.print(pou_name); s4o_h.print("_H\n");\
         s4o_h.print("#define __");  s4o_h.print(pou_name); s4o_h.print("_H\n");\
@@ -2255,13 +2850,17 @@ class generate_c_c: public iterator_visitor_c {
         generate_c_pous_c::fname(symbol, s4o_h, true); /* generate the <pou_name>.h file */\
         generate_c_pous_c::fname(symbol, s4o_c, false);/* generate the <pou_name>.c file */\
         s4o_h.print("#endif /* __");  s4o_h.print(pou_name); s4o_h.print("_H */\n");\
+        }\
         /* add #include directives to the POUS.h and POUS.c files... */\
+        /* (with separate compilation, each <pou_name>.c file is a translation unit of its own) */\
         pous_incl_s4o.print("#include \"");\
-        pous_s4o.     print("#include \"");\
         pous_incl_s4o.print(pou_name);\
-        pous_s4o.     print(pou_name);\
         pous_incl_s4o.print(".h\"\n");\
+        if (!generate_separate_pous__) {\
+        pous_s4o.     print("#include \"");\
+        pous_s4o.     print(pou_name);\
         pous_s4o.     print(".c\"\n");\
+        }\
       } else {\
         symbol->accept(generate_c_implicit_typedecl);\
         generate_c_pous_c::fname(symbol, pous_incl_s4o, true);\
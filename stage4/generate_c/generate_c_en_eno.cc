@@ -0,0 +1,163 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/* Determine where the C code that handles the implicit EN and ENO parameters of FUNCTIONs may be left out.
+ *
+ * Unless the '-e' option is used, every FUNCTION gets implicit EN and ENO parameters, even though
+ * most calls never pass a value to EN, nor read ENO.
+ *
+ * For every FUNCTION whose body does not reference EN or ENO, a 'lean' variant (<function_name>_lean__)
+ * is generated, without the EN and ENO parameters, and without the code that tests EN. The normal
+ * variant then simply tests EN, sets ENO, and calls the lean variant. Each call that does not pass a
+ * value to ENO, and that either does not pass a value to EN or passes a constant TRUE, calls the lean
+ * variant.
+ *
+ * Only FUNCTIONs with implicitly declared EN and ENO parameters, and whose C code is generated by
+ * iec2c (i.e. not inside a {disable code generation} ... {enable code generation} block, such as
+ * the standard library) are handled.
+ *
+ * FUNCTION_BLOCKs always keep the code that tests EN and sets ENO. Their EN and ENO are variables
+ * stored in the FB instance, which are listed in VARIABLES.csv, and so may be forced by the debugger.
+ */
+
+#define FUNCTION_LEAN_SUFFIX "_lean__"
+
+
+/* A digest of a set of POU names (case insensitive), used to key the incremental compilation cache */
+static std::string names_digest(const std::set<std::string> &names) {
+  uint64_t hash = 14695981039346656037ULL; /* FNV-1a */
+  for (std::set<std::string>::const_iterator iter = names.begin(); iter != names.end(); ++iter)
+    for (size_t i = 0; i <= iter->size(); i++) /* include the terminating '\0', as a separator */
+      {hash ^= (unsigned char)toupper((*iter).c_str()[i]); hash *= 1099511628211ULL;}
+  char digest[17];
+  snprintf(digest, sizeof(digest), "%016" PRIx64, hash);
+  return digest;
+}
+
+
+class en_eno_analysis_c: public iterator_visitor_c {
+  private:
+    /* the FUNCTIONs with implicit EN and ENO parameters, whose C code is generated by iec2c */
+    static std::set<symbol_c *> candidate_pous;
+    /* the FUNCTIONs whose EN or ENO parameters are used by the function's body */
+    static std::set<symbol_c *> en_eno_used;
+
+    symbol_c *current_pou;
+
+    en_eno_analysis_c(void) {current_pou = NULL;}
+
+    static bool is_en_eno(symbol_c *name) {
+      token_c *token = dynamic_cast<token_c *>(name);
+      return ((NULL != token) && ((strcasecmp(token->value, "EN") == 0) || (strcasecmp(token->value, "ENO") == 0)));
+    }
+
+    static bool is_const_true(symbol_c *expression) {
+      return (expression->const_value._bool.is_valid() && expression->const_value._bool.get());
+    }
+
+    static bool has_implicit_en_eno(symbol_c *pou) {
+      function_param_iterator_c fp_iterator(pou);
+      identifier_c  en_param("EN");
+      identifier_c eno_param("ENO");
+      if ((NULL == fp_iterator.search(& en_param)) || !fp_iterator.is_en_eno_param_implicit()) return false;
+      if ((NULL == fp_iterator.search(&eno_param)) || !fp_iterator.is_en_eno_param_implicit()) return false;
+      return true;
+    }
+
+    /* A call passes a value to ENO, or to EN (other than a constant TRUE) */
+    static bool call_uses_en_eno(symbol_c *f_call) {
+      function_call_param_iterator_c function_call_param_iterator(f_call);
+      symbol_c * en_value = function_call_param_iterator.search_f("EN");
+      symbol_c *eno_value = function_call_param_iterator.search_f("ENO");
+      return ((NULL != eno_value) || ((NULL != en_value) && !is_const_true(en_value)));
+    }
+
+  public:
+    /* Must be called once, before generating the C code of any POU. */
+    static void analyse(library_c *library) {
+      bool code_generation = true;
+      candidate_pous.clear();
+      en_eno_used.clear();
+      if (runtime_options.disable_implicit_en_eno) return;
+
+      for (int i = 0; i < library->n; i++) {
+        symbol_c *element = library->elements[i];
+        if      (element->is< enable_code_generation_pragma_c>()) code_generation = true;
+        else if (element->is<disable_code_generation_pragma_c>()) code_generation = false;
+        else if (!code_generation) continue;
+        else if (element->is<function_declaration_c>() && has_implicit_en_eno(element))
+          candidate_pous.insert(element);
+      }
+
+      en_eno_analysis_c en_eno_analysis;
+      library->accept(en_eno_analysis);
+    }
+
+    /* A lean variant of the function (without EN and ENO parameters) is generated */
+    static bool has_lean_variant(function_declaration_c *f_decl) {
+      return (   (candidate_pous.find(f_decl) != candidate_pous.end())
+              && (en_eno_used   .find(f_decl) == en_eno_used   .end()));
+    }
+
+    /* The function call (function_invocation_c, il_function_call_c or il_formal_funct_call_c) may call the lean variant */
+    static bool is_lean_call(symbol_c *f_call, function_declaration_c *f_decl) {
+      return (has_lean_variant(f_decl) && !call_uses_en_eno(f_call));
+    }
+
+    /* parameter 'param_name' is EN or ENO (to be left out of calls to the lean variant) */
+    static bool is_en_eno_param(symbol_c *param_name) {return is_en_eno(param_name);}
+
+    /* A digest of the results of the analysis (the generated C code of the POUs depends on these results) */
+    static std::string digest(void) {
+      std::set<std::string> names; /* sorted, so the digest does not depend on the addresses of the symbols */
+      for (std::set<symbol_c *>::iterator iter = candidate_pous.begin(); iter != candidate_pous.end(); ++iter) {
+        function_declaration_c *f_decl = (*iter)->as<function_declaration_c>();
+        if (has_lean_variant(f_decl)) names.insert(get_datatype_info_c::get_id_str(f_decl->derived_function_name));
+      }
+      return names_digest(names);
+    }
+
+
+  private:
+    /* Only the bodies of the FUNCTIONs are of interest */
+    void *visit(function_declaration_c *symbol) {
+      current_pou = symbol;
+      symbol->function_body->accept(*this);
+      current_pou = NULL;
+      return NULL;
+    }
+    void *visit(function_block_declaration_c *symbol) {return NULL;}
+    void *visit(program_declaration_c        *symbol) {return NULL;}
+    void *visit(configuration_declaration_c  *symbol) {return NULL;}
+
+    /* EN or ENO referenced by the body of the function itself */
+    void *visit(symbolic_variable_c *symbol) {
+      if (is_en_eno(symbol->var_name)) en_eno_used.insert(current_pou);
+      return NULL;
+    }
+};
+
+
+std::set<symbol_c *> en_eno_analysis_c::candidate_pous;
+std::set<symbol_c *> en_eno_analysis_c::en_eno_used;
@@ -82,8 +82,9 @@ class il_default_variable_visitor_c {
  * It includes a reference to its name,
  * and the data type of the data currently stored
  * in this C++ variable... This is required because the
- * C++ variable is a union, and we must know which member
- * of the union top reference!!
+ * IL implicit variable is mapped onto one C variable per
+ * data type (e.g. __IL_DEFVAR_INT, __IL_DEFVAR_BOOL, ...),
+ * and we must know which of these variables to reference!!
  *
  * Note that we also need to keep track of the data type of
  * the value currently being stored in the IL implicit variable.
@@ -117,6 +118,72 @@ class il_default_variable_c: public symbol_c {
 };
 
 
+/* Determine the data types stored in the IL implicit variables of an instruction list,
+ * or of a parenthesised simple instruction list.
+ *
+ * Instead of a single union of all the elementary data types (which the C compiler must keep 
+ * in memory), the IL implicit variable is mapped onto one C variable for each data type that 
+ * is actually stored in it (as determined by stage 3), e.g.:
+ *     INT  __IL_DEFVAR_INT;
+ *     BOOL __IL_DEFVAR_BOOL;
+ * The C compiler may then keep each of these variables in a register.
+ *
+ *   current_types: the data types stored in the IL implicit variable (IL_DEFVAR) of the list itself;
+ *   back_types:    the data types of the results of the parenthesised lists, that are passed to the
+ *                  enclosing scope in the IL_DEFVAR_BACK variable.
+ *
+ * The data types are identified by the name of the C data type (the SAFE data types are
+ * mapped onto the same C data types as the corresponding non SAFE data types).
+ */
+class il_implicit_variable_types_c: public iterator_visitor_c {
+  public:
+    std::set<std::string> current_types, back_types;
+
+  private:
+    symbol_c *root;
+    int       depth; /* nesting level of the parenthesised lists */
+
+  public:
+    il_implicit_variable_types_c(symbol_c *il) {
+      root  = il;
+      depth = 0;
+      if (NULL == il) return;
+      /* a parenthesised list passes its own result to the enclosing scope too */
+      if (il->is<simple_instr_list_c>()) add(back_types, il->datatype);
+      il->accept(*this);
+    }
+
+  private:
+    static void add(std::set<std::string> &types, symbol_c *datatype) {
+      if (   !get_datatype_info_c::is_ANY_ELEMENTARY    (datatype)
+          && !get_datatype_info_c::is_ANY_SAFEELEMENTARY(datatype)) return;
+      const char *name = get_datatype_info_c::get_id_str(datatype);
+      if (NULL == name) ERROR;
+      if (strncmp(name, "SAFE", 4) == 0) name += 4;
+      types.insert(name);
+    }
+
+    void add_instruction(symbol_c *instruction, std::vector<symbol_c *> &prev_il_instruction) {
+      if (depth > 0) return; /* the nested lists declare their own IL implicit variable */
+      add(current_types, instruction->datatype);
+      for (size_t i = 0; i < prev_il_instruction.size(); i++)
+        add(current_types, prev_il_instruction[i]->datatype);
+    }
+
+    void *visit(il_instruction_c        *symbol) {add_instruction(symbol, symbol->prev_il_instruction); return iterator_visitor_c::visit(symbol);}
+    void *visit(il_simple_instruction_c *symbol) {add_instruction(symbol, symbol->prev_il_instruction); return iterator_visitor_c::visit(symbol);}
+
+    void *visit(simple_instr_list_c *symbol) {
+      if (symbol == root) return iterator_visitor_c::visit(symbol);
+      add(back_types, symbol->datatype);
+      depth++;
+      iterator_visitor_c::visit(symbol);
+      depth--;
+      return NULL;
+    }
+};
+
+
 /***********************************************************************/
 /***********************************************************************/
 /***********************************************************************/
@@ -147,9 +214,7 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
      */
     symbol_c *jump_label;
 
-    /* the data type of the IL implicit variable... */
-    #define IL_DEFVAR_T VAR_LEADER "IL_DEFVAR_T"
-    /* The name of the IL implicit variable... */
+    /* The name of the IL implicit variable (the name of the data type is appended, see il_implicit_variable_types_c)... */
     #define IL_DEFVAR   VAR_LEADER "IL_DEFVAR"
     /* The name of the variable used to pass the result of a
      * parenthesised instruction list to the immediately preceding
@@ -186,6 +251,7 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
 
     search_varfb_instance_type_c *search_varfb_instance_type;
     search_var_instance_decl_c   *search_var_instance_decl;
+    symbol_c *scope_;
 
     symbol_c* current_array_type;
     symbol_c* current_param_type;
@@ -205,6 +271,7 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
       search_fb_instance_decl    = new search_fb_instance_decl_c   (scope);
       search_varfb_instance_type = new search_varfb_instance_type_c(scope);
       search_var_instance_decl   = new search_var_instance_decl_c  (scope);
+      scope_ = scope;
       
       current_operand = NULL;
       current_array_type = NULL;
@@ -226,25 +293,30 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
     }
 
   private:
-    /* Declare an implicit IL variable... */
-    void declare_implicit_variable(il_default_variable_c *implicit_var) {
-      s4o.print(s4o.indent_spaces);
-      s4o.print(IL_DEFVAR_T);
-      s4o.print(" ");
-      implicit_var->datatype = NULL;
-      implicit_var->accept(*this);
-      s4o.print(";\n");
+    /* Declare an implicit IL variable (one C variable for each data type stored in it)... */
+    void declare_implicit_variable(il_default_variable_c *implicit_var, std::set<std::string> &types) {
+      for (std::set<std::string>::iterator iter = types.begin(); iter != types.end(); ++iter) {
+        s4o.print(s4o.indent_spaces);
+        s4o.print(*iter);
+        s4o.print(" ");
+        implicit_var->var_name->accept(*this);
+        s4o.print("_");
+        s4o.print(*iter);
+        s4o.print(";\n");
+      }
     }
     
   public:  
-    /* Declare the default variable, that will store the result of the IL operations */
-    void declare_implicit_variable(void) {
-      declare_implicit_variable(&this->implicit_variable_result);
+    /* Declare the default variable, that will store the result of the IL operations of the (simple) instruction list 'il' */
+    void declare_implicit_variable(symbol_c *il) {
+      il_implicit_variable_types_c il_implicit_variable_types(il);
+      declare_implicit_variable(&this->implicit_variable_result, il_implicit_variable_types.current_types);
     }
     
     /* Declare the backup to the default variable, that will store the result of the IL operations executed inside a parenthesis... */
-    void declare_implicit_variable_back(void) {
-      declare_implicit_variable(&this->implicit_variable_result_back);
+    void declare_implicit_variable_back(symbol_c *il) {
+      il_implicit_variable_types_c il_implicit_variable_types(il);
+      declare_implicit_variable(&this->implicit_variable_result_back, il_implicit_variable_types.back_types);
     }
     
     void print_implicit_variable_back(void) {
@@ -298,9 +370,9 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
       }
 
       if (NULL == fb_name) ERROR;
-      symbolic_variable_c *sv = dynamic_cast<symbolic_variable_c *>(fb_name);
+      symbolic_variable_c *sv = fb_name->as<symbolic_variable_c>();
       if (NULL == sv) ERROR;
-      identifier_c *id = dynamic_cast<identifier_c *>(sv->var_name);
+      identifier_c *id = sv->var_name->as<identifier_c>();
       if (NULL == id) ERROR;
       
       identifier_c param(param_name);
@@ -350,7 +422,27 @@ class generate_c_il_c: public generate_c_base_and_typeid_c, il_default_variable_
     }
 
 
+    /* CONSTANT variables of FBs and PROGRAMs are read directly from their static const C object */
+    void *print_const_getter(symbol_c *symbol, const char *getter, symbol_c *pou_name, symbol_c *var_name) {
+      variablegeneration_t old_wanted_variablegeneration = wanted_variablegeneration;
+      s4o.print(getter);
+      s4o.print("(");
+      pou_name->accept(*this);
+      s4o.print(",");
+      var_name->accept(*this);
+      s4o.print(",");
+      wanted_variablegeneration = complextype_suffix_vg;
+      symbol->accept(*this);
+      s4o.print(")");
+      wanted_variablegeneration = old_wanted_variablegeneration;
+      return NULL;
+    }
+
     void *print_getter(symbol_c *symbol) {
+      symbol_c *const_pou, *const_name;
+      if (analyse_variable_c::first_nonfb_is_static_const(symbol, scope_, &const_pou, &const_name))
+        return print_const_getter(symbol, (wanted_variablegeneration == fparam_output_vg)? GET_CONST_BY_REF : GET_CONST, const_pou, const_name);
+
       unsigned int vartype = search_var_instance_decl->get_vartype(symbol);
       if (wanted_variablegeneration == fparam_output_vg) {
         if (vartype == search_var_instance_decl_c::external_vt) {
@@ -475,9 +567,8 @@ public:
 void *visit(il_default_variable_c *symbol) {
   symbol->var_name->accept(*this);
   if (NULL != symbol->datatype) {
-    s4o.print(".");
+    s4o.print("_");
     symbol->datatype->accept(*this);
-    s4o.print("var");
   } return NULL;
 }
 
@@ -705,21 +796,45 @@ void *visit(array_initial_elements_list_c *symbol) {
 void *visit(instruction_list_c *symbol) {
   
   /* Declare the IL implicit variable, that will store the result of the IL operations... */
-  declare_implicit_variable();
+  declare_implicit_variable(symbol);
 
   /* Declare the backup to the IL implicit variable, that will store the result of the IL operations executed inside a parenthesis... */
-  declare_implicit_variable_back();
+  declare_implicit_variable_back(symbol);
   
+  /* The IL instructions following an unconditional jump (JMP or RET) are never executed,
+   * unless they are the target of a jump (i.e. up to the next labeled instruction).
+   * We do not generate C code for these instructions.
+   */
+  bool unreachable = false;
+  int  removed     = 0;
   for(int i = 0; i < symbol->n; i++) {
+    /* NOTE: the instruction list may also contain pragmas, which are always generated */
+    il_instruction_c *il_instruction = symbol->elements[i]->as<il_instruction_c>();
+    if ((NULL != il_instruction) && (NULL != il_instruction->label)) unreachable = false;
+    if ((NULL != il_instruction) && unreachable) {
+      if (NULL != il_instruction->il_instruction) removed++;
+      continue;
+    }
     print_line_directive(symbol->elements[i]);
     s4o.print(s4o.indent_spaces);
     symbol->elements[i]->accept(*this);
     s4o.print(";\n");
+    if (NULL != il_instruction) unreachable = is_unconditional_jump(il_instruction->il_instruction);
   }
+  if (removed > 0)
+    stats_c::add_counter("stage4", "dead_il_instructions_removed", removed);
   return NULL;
 }
 
 
+static bool is_unconditional_jump(symbol_c *il_instruction) {
+  if (NULL == il_instruction) return false;
+  if (il_instruction->is<RET_operator_c>()) return true;
+  il_jump_operation_c *jump_operation = il_instruction->as<il_jump_operation_c>();
+  return ((NULL != jump_operation) && (jump_operation->il_jump_operator->is<JMP_operator_c>()));
+}
+
+
 /* | label ':' [il_incomplete_instruction] eol_list */
 // SYM_REF2(il_instruction_c, label, il_instruction)
 void *visit(il_instruction_c *symbol) {
@@ -884,6 +999,10 @@ void *visit(il_function_call_c *symbol) {
   int fdecl_mutiplicity =  function_symtable.count(symbol->function_name);
   if (fdecl_mutiplicity == 0) ERROR;
 
+  /* Check whether we may call the variant of the function without EN and ENO (see generate_c_en_eno.cc) */
+  /* NOTE: the inline function called when has_output_params is true takes care of this itself. */
+  bool lean_call = en_eno_analysis_c::is_lean_call(symbol, f_decl);
+
   /* when function returns a void, we do not store the value in the default variable! */
   if (!get_datatype_info_c::is_VOID(symbol->datatype)) {
     this->implicit_variable_result.accept(*this);
@@ -924,6 +1043,8 @@ void *visit(il_function_call_c *symbol) {
     }
     if (function_type_suffix != NULL)
       function_type_suffix->accept(*this);
+    if (lean_call)
+      s4o.print(FUNCTION_LEAN_SUFFIX);
   }
   s4o.print("(");
   s4o.indent_right();
@@ -933,6 +1054,8 @@ void *visit(il_function_call_c *symbol) {
   PARAM_LIST_ITERATOR() {
     symbol_c *param_value = PARAM_VALUE;
     current_param_type = PARAM_TYPE;
+    if (lean_call && !has_output_params && en_eno_analysis_c::is_en_eno_param(PARAM_NAME))
+      continue;
     
     switch (PARAM_DIRECTION) {
       case function_param_iterator_c::direction_in:
@@ -1287,6 +1410,10 @@ void *visit(il_formal_funct_call_c *symbol) {
   /* (fdecl_mutiplicity > 1)  => calling overloaded function */
   int fdecl_mutiplicity =  function_symtable.count(symbol->function_name);
   if (fdecl_mutiplicity == 0) ERROR;
+
+  /* Check whether we may call the variant of the function without EN and ENO (see generate_c_en_eno.cc) */
+  /* NOTE: the inline function called when has_output_params is true takes care of this itself. */
+  bool lean_call = en_eno_analysis_c::is_lean_call(symbol, f_decl);
   if (fdecl_mutiplicity == 1) 
     /* function being called is NOT overloaded! */
     f_decl = NULL; 
@@ -1331,6 +1458,8 @@ void *visit(il_formal_funct_call_c *symbol) {
     }  
     if (function_type_suffix != NULL)
       function_type_suffix->accept(*this);
+    if (lean_call)
+      s4o.print(FUNCTION_LEAN_SUFFIX);
   }
   s4o.print("(");
   s4o.indent_right();
@@ -1339,6 +1468,8 @@ void *visit(il_formal_funct_call_c *symbol) {
   PARAM_LIST_ITERATOR() {
     symbol_c *param_value = PARAM_VALUE;
     current_param_type = PARAM_TYPE;
+    if (lean_call && !has_output_params && en_eno_analysis_c::is_en_eno_param(PARAM_NAME))
+      continue;
     switch (PARAM_DIRECTION) {
       case function_param_iterator_c::direction_in:
         if (nb_param > 0)
@@ -1420,20 +1551,20 @@ void *visit(simple_instr_list_c *symbol) {
    * value to the outside scope...
    *
    * The above example will result in the following C++ code:
-   * {__IL_DEFVAR_T __IL_DEFVAR_BACK;
-   *  __IL_DEFVAR_T __IL_DEFVAR;
+   * {INT __IL_DEFVAR_BACK_INT;
+   *  INT __IL_DEFVAR_INT;
    *
-   *  __IL_DEFVAR.INTvar = var1;
+   *  __IL_DEFVAR_INT = var1;
    *  {
-   *    __IL_DEFVAR_T __IL_DEFVAR;
+   *    INT __IL_DEFVAR_INT;
    *
-   *    __IL_DEFVAR.INTvar = var2;
-   *    __IL_DEFVAR.INTvar |= var3;
-   *    __IL_DEFVAR.INTvar |= var4;
+   *    __IL_DEFVAR_INT = var2;
+   *    __IL_DEFVAR_INT |= var3;
+   *    __IL_DEFVAR_INT |= var4;
    *
-   *    __IL_DEFVAR_BACK = __IL_DEFVAR;
+   *    __IL_DEFVAR_BACK_INT = __IL_DEFVAR_INT;
    *  }
-   *  __IL_DEFVAR.INTvar &= __IL_DEFVAR_BACK.INTvar;
+   *  __IL_DEFVAR_INT &= __IL_DEFVAR_BACK_INT;
    *
    * }
    *
@@ -1447,7 +1578,7 @@ void *visit(simple_instr_list_c *symbol) {
   /* Declare the IL implicit variable, that will store the result of the IL operations... */
   s4o.print("{\n");
   s4o.indent_right();
-  declare_implicit_variable();
+  declare_implicit_variable(symbol);
     
   print_list(symbol, s4o.indent_spaces, ";\n" + s4o.indent_spaces, ";\n");
 
@@ -0,0 +1,175 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/* Determine which user defined FUNCTIONs are generated as 'static inline' C functions.
+ *
+ * By default, a FUNCTION is inlined when:
+ *   - its body is small (no more than INLINE_FUNCTION_MAX_SIZE nodes in the abstract syntax tree);
+ *   - it is a leaf of the call graph, i.e. its body does not call any FUNCTION whose C code is
+ *     generated by iec2c (calls to the standard library functions are allowed, as these are
+ *     already 'static inline'), nor any FUNCTION_BLOCK. This also excludes recursive FUNCTIONs;
+ *   - it does not declare VAR_EXTERNAL or located variables.
+ *
+ * The default may be overridden for each FUNCTION, by placing one of the following pragmas
+ * just before the FUNCTION's declaration:
+ *     {inline}     the FUNCTION is always inlined
+ *     {noinline}   the FUNCTION is never inlined
+ *   e.g.
+ *     {noinline}
+ *     FUNCTION scale : REAL
+ *       ...
+ *     END_FUNCTION
+ *
+ * The definition of an inlined FUNCTION (and of its lean variant, see generate_c_en_eno.cc)
+ * is printed at the end of POUS.h (after the declaration of all the datatypes and the
+ * prototypes of all the POUs), so it is visible in every translation unit that may call it.
+ * Nothing is printed in POUS.c (or in the FUNCTION's <pou_name>.c file).
+ */
+
+/* The default maximum size (number of nodes of the body) of an inlined FUNCTION, which may be
+ * changed with '-O inline=<n>'.
+ * Measured with tests/benchmark/cyclebench on workloads/functions.st (5 leaf FUNCTIONs of 17-24, 25-32,
+ * 33-64, 65-128 and 129-256 nodes, called 200 times per cycle), gcc -O2, median p50 of the cycle time:
+ *     threshold               0       64      128      256
+ *     -O p,s (POU per file)   2039 ns 1909 ns 1773 ns  1768 ns
+ *     default, -O s           no difference beyond the noise (~10%), as the calling POU and the
+ *                             FUNCTIONs are in the same translation unit, where the C compiler
+ *                             already inlines them itself.
+ * Beyond 128 nodes the cycle time no longer improves, while the inlined FUNCTIONs are compiled again
+ * in every translation unit that includes POUS.h.
+ */
+#define INLINE_FUNCTION_MAX_SIZE 128
+
+
+class inline_function_analysis_c: public fcall_iterator_visitor_c {
+  private:
+    /* the FUNCTIONs whose C code is generated by iec2c */
+    static std::set<symbol_c *> generated_functions;
+    /* the FUNCTIONs that are generated as 'static inline' */
+    static std::set<symbol_c *> inline_functions;
+
+    int  size;     /* number of nodes in the FUNCTION's body */
+    bool is_leaf;  /* the FUNCTION's body does not call any other POU */
+    bool has_refs; /* the FUNCTION declares VAR_EXTERNAL or located variables */
+
+    inline_function_analysis_c(void) {size = 0; is_leaf = true; has_refs = false;}
+
+    typedef enum {no_override, force_inline, force_noinline} override_t;
+
+    static override_t get_override(pragma_c *pragma) {
+      std::string value(pragma->value);
+      size_t beg = value.find_first_not_of(" \t\r\n");
+      size_t end = value.find_last_not_of (" \t\r\n");
+      if (beg == std::string::npos) return no_override;
+      value = value.substr(beg, end - beg + 1);
+      if (strcasecmp(value.c_str(),   "inline") == 0) return force_inline;
+      if (strcasecmp(value.c_str(), "noinline") == 0) return force_noinline;
+      return no_override;
+    }
+
+    static bool use_default_heuristic(function_declaration_c *f_decl) {
+      inline_function_analysis_c analysis;
+      f_decl->var_declarations_list->accept(analysis);
+      analysis.size = 0;
+      f_decl->function_body->accept(analysis);
+      int max_size = (inline_function_max_size__ < 0)? INLINE_FUNCTION_MAX_SIZE : inline_function_max_size__;
+      return ((max_size > 0) && analysis.is_leaf && !analysis.has_refs && (analysis.size <= max_size));
+    }
+
+  public:
+    /* Must be called once, before generating the C code of any POU. */
+    static void analyse(library_c *library) {
+      bool       code_generation = true;
+      override_t override        = no_override;
+      generated_functions.clear();
+      inline_functions.clear();
+
+      for (int i = 0; i < library->n; i++) {
+        symbol_c *element = library->elements[i];
+        if      (element->is< enable_code_generation_pragma_c>()) code_generation = true;
+        else if (element->is<disable_code_generation_pragma_c>()) code_generation = false;
+        else if (!code_generation) continue;
+        else if (element->is<function_declaration_c>()) generated_functions.insert(element);
+      }
+
+      for (int i = 0; i < library->n; i++) {
+        symbol_c *element = library->elements[i];
+        pragma_c               *pragma = element->as<pragma_c>();
+        function_declaration_c *f_decl = element->as<function_declaration_c>();
+        if (NULL != pragma) {
+          override_t pragma_override = get_override(pragma);
+          if (no_override != pragma_override) override = pragma_override;
+          continue;
+        }
+        if ((NULL != f_decl) && (generated_functions.find(f_decl) != generated_functions.end())) {
+          if (   (force_inline == override)
+              || ((no_override == override) && use_default_heuristic(f_decl)))
+            inline_functions.insert(f_decl);
+        }
+        override = no_override; /* the pragma only applies to the POU that immediately follows it */
+      }
+      stats_c::add_counter("stage4", "functions_inlined", inline_functions.size());
+    }
+
+    /* The FUNCTION is generated as a 'static inline' C function */
+    static bool is_inline(function_declaration_c *f_decl) {
+      return (inline_functions.find(f_decl) != inline_functions.end());
+    }
+
+    /* A digest of the results of the analysis (the generated C code of the POUs depends on these results) */
+    static std::string digest(void) {
+      std::set<std::string> names;
+      for (std::set<symbol_c *>::iterator iter = inline_functions.begin(); iter != inline_functions.end(); ++iter)
+        names.insert(get_datatype_info_c::get_id_str((*iter)->as<function_declaration_c>()->derived_function_name));
+      return names_digest(names);
+    }
+
+
+  private:
+    void prefix_fcall(symbol_c *symbol) {size++;}
+
+    /* calls to other POUs */
+    void *visit(function_invocation_c *symbol) {
+      if (generated_functions.find(symbol->called_function_declaration) != generated_functions.end()) is_leaf = false;
+      return fcall_iterator_visitor_c::visit(symbol);
+    }
+    void *visit(il_function_call_c *symbol) {
+      if (generated_functions.find(symbol->called_function_declaration) != generated_functions.end()) is_leaf = false;
+      return fcall_iterator_visitor_c::visit(symbol);
+    }
+    void *visit(il_formal_funct_call_c *symbol) {
+      if (generated_functions.find(symbol->called_function_declaration) != generated_functions.end()) is_leaf = false;
+      return fcall_iterator_visitor_c::visit(symbol);
+    }
+    void *visit(fb_invocation_c *symbol) {is_leaf = false; return fcall_iterator_visitor_c::visit(symbol);}
+    void *visit(il_fb_call_c    *symbol) {is_leaf = false; return fcall_iterator_visitor_c::visit(symbol);}
+
+    /* references to variables declared outside the FUNCTION */
+    void *visit(external_var_declarations_c *symbol) {has_refs = true; return NULL;}
+    void *visit(located_var_declarations_c  *symbol) {has_refs = true; return NULL;}
+};
+
+
+std::set<symbol_c *> inline_function_analysis_c::generated_functions;
+std::set<symbol_c *> inline_function_analysis_c::inline_functions;
@@ -55,6 +55,7 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
 
     search_varfb_instance_type_c *search_varfb_instance_type;
     search_var_instance_decl_c   *search_var_instance_decl;
+    symbol_c *scope_;
 
     variablegeneration_t wanted_variablegeneration;
 
@@ -65,6 +66,7 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
     {
       search_varfb_instance_type = new search_varfb_instance_type_c(scope);
       search_var_instance_decl   = new search_var_instance_decl_c  (scope);
+      scope_ = scope;
       
       this->set_variable_prefix(variable_prefix);
       fcall_number = 0;
@@ -92,7 +94,8 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
             symbol_c *function_type_prefix,
             symbol_c *function_type_suffix,
             std::list<FUNCTION_PARAM*> param_list,
-            function_declaration_c *f_decl = NULL) {
+            function_declaration_c *f_decl = NULL,
+            bool lean_call = false /* call the variant of the function without EN and ENO (see generate_c_en_eno.cc) */) {
 
       std::list<FUNCTION_PARAM*>::iterator pt;
       generating_inlinefunction = true;
@@ -104,7 +107,11 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
       }
 
       s4o.print(s4o.indent_spaces);
-      s4o.print("inline ");
+      /* These functions are only called from the POUs' translation unit. A C99 'inline' function
+       * (without 'static') has no external definition, so its calls fail to link when the C compiler
+       * decides not to inline them (e.g. without optimisation).
+       */
+      s4o.print("static inline ");
       function_type_prefix->accept(*this);
       s4o.print(" __");
       fbname->accept(*this);
@@ -172,11 +179,16 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
 
       if (function_type_suffix)
         function_type_suffix->accept(*this);
+      if (lean_call)
+        s4o.print(FUNCTION_LEAN_SUFFIX);
       s4o.print("(");
       s4o.indent_right();
 
+      int nb_param = 0;
       PARAM_LIST_ITERATOR() {
-        if (pt != param_list.begin())
+        if (lean_call && en_eno_analysis_c::is_en_eno_param(PARAM_NAME))
+          continue;
+        if (nb_param++ > 0)
         s4o.print(",\n" + s4o.indent_spaces);
         if (PARAM_DIRECTION == function_param_iterator_c::direction_in)
           PARAM_NAME->accept(*this);
@@ -225,6 +237,22 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
 
 
     void *print_getter(symbol_c *symbol) {
+      /* CONSTANT variables of FBs and PROGRAMs are read directly from their static const C object */
+      symbol_c *const_pou, *const_name;
+      if (analyse_variable_c::first_nonfb_is_static_const(symbol, scope_, &const_pou, &const_name)) {
+        s4o.print(GET_CONST);
+        s4o.print("(");
+        const_pou->accept(*this);
+        s4o.print(",");
+        const_name->accept(*this);
+        s4o.print(",");
+        wanted_variablegeneration = complextype_suffix_vg;
+        symbol->accept(*this);
+        s4o.print(")");
+        wanted_variablegeneration = expression_vg;
+        return NULL;
+      }
+
       unsigned int vartype = search_var_instance_decl->get_vartype(symbol);
       if (vartype == search_var_instance_decl_c::external_vt) {
         if (!get_datatype_info_c::is_type_valid    (symbol->datatype)) ERROR;
@@ -557,12 +585,13 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
       /* (fdecl_mutiplicity > 1)  => calling overloaded function */
       int fdecl_mutiplicity =  function_symtable.count(symbol->function_name);
       if (fdecl_mutiplicity == 0) ERROR;
+      bool lean_call = en_eno_analysis_c::is_lean_call(symbol, f_decl);
       if (fdecl_mutiplicity == 1) 
         /* function being called is NOT overloaded! */
         f_decl = NULL; 
 
       if (has_output_params)
-        generate_inline(function_name, function_type_prefix, function_type_suffix, param_list, f_decl);
+        generate_inline(function_name, function_type_prefix, function_type_suffix, param_list, f_decl, lean_call);
 
       CLEAR_PARAM_LIST()
       return NULL;
@@ -719,12 +748,13 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
       /* (fdecl_mutiplicity > 1)  => calling overloaded function */
       int fdecl_mutiplicity =  function_symtable.count(symbol->function_name);
       if (fdecl_mutiplicity == 0) ERROR;
+      bool lean_call = en_eno_analysis_c::is_lean_call(symbol, f_decl);
       if (fdecl_mutiplicity == 1) 
         /* function being called is NOT overloaded! */
         f_decl = NULL; 
 
       if (has_output_params)
-        generate_inline(function_name, function_type_prefix, function_type_suffix, param_list, f_decl);
+        generate_inline(function_name, function_type_prefix, function_type_suffix, param_list, f_decl, lean_call);
 
       CLEAR_PARAM_LIST()
       return NULL;
@@ -882,12 +912,13 @@ class generate_c_inlinefcall_c: public generate_c_base_and_typeid_c {
       /* (fdecl_mutiplicity > 1)  => calling overloaded function */
       int fdecl_mutiplicity =  function_symtable.count(symbol->function_name);
       if (fdecl_mutiplicity == 0) ERROR;
+      bool lean_call = en_eno_analysis_c::is_lean_call(symbol, f_decl);
       if (fdecl_mutiplicity == 1) 
         /* function being called is NOT overloaded! */
         f_decl = NULL; 
 
       if (has_output_params)
-        generate_inline(function_name, function_type_prefix, function_type_suffix, param_list, f_decl);
+        generate_inline(function_name, function_type_prefix, function_type_suffix, param_list, f_decl, lean_call);
 
       CLEAR_PARAM_LIST()
 
@@ -326,7 +326,7 @@ class generate_c_sfc_elements_c: public generate_c_base_and_typeid_c {
         case transitiontestdebug_sg:
           // Transition condition is in IL
           if (symbol->transition_condition_il != NULL) {
-            generate_c_il->declare_implicit_variable_back();
+            generate_c_il->declare_implicit_variable_back(symbol->transition_condition_il);
             s4o.print(s4o.indent_spaces);
             symbol->transition_condition_il->accept(*generate_c_il);
             s4o.print(SET_VAR);
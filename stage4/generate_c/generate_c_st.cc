@@ -82,6 +82,11 @@ class generate_c_st_c: public generate_c_base_and_typeid_c {
 
     bool first_subrange_case_list;
 
+    /* The nesting depth of the FOR loop being generated. Appended to the names of
+     * the __for_end and __for_by variables, so nested loops do not shadow them.
+     */
+    int for_depth;
+
     variablegeneration_t wanted_variablegeneration;
 
   public:
@@ -96,6 +101,7 @@ class generate_c_st_c: public generate_c_base_and_typeid_c {
       current_array_type = NULL;
       current_param_type = NULL;
       fcall_number = 0;
+      for_depth = 0;
       fbname = name;
       wanted_variablegeneration = expression_vg;
     }
@@ -119,7 +125,72 @@ class generate_c_st_c: public generate_c_base_and_typeid_c {
 
 
 
+/* Check whether the value of the (BOOL) expression was determined at compile time (by the constant
+ * folding and constant propagation done in stage3), and is equal to 'value'.
+ * Used to remove the code that will never be executed (e.g. IF branches with a constant FALSE condition).
+ */
+static bool is_const_bool(symbol_c *expression, bool value) {
+  return (expression->const_value._bool.is_valid() && (expression->const_value._bool.get() == value));
+}
+
+/* Check whether the value of the (integer) expression was determined at compile time. */
+static bool is_const_int(symbol_c *expression) {
+  return (expression->const_value._int64.is_valid() || expression->const_value._uint64.is_valid());
+}
+
+/* Get the value of an (integer) expression determined at compile time, if it fits in an int64_t. */
+static bool get_const_int(symbol_c *expression, int64_t *value) {
+  if (expression->const_value._int64.is_valid()) {*value = expression->const_value._int64.get(); return true;}
+  if (expression->const_value._uint64.is_valid() && (expression->const_value._uint64.get() <= INT64_MAX))
+    {*value = (int64_t)expression->const_value._uint64.get(); return true;}
+  return false;
+}
+
+/* The sign (-1, 0, 1) of the value of an expression for which is_const_int() returns true. */
+static int const_int_sign(symbol_c *expression) {
+  if (expression->const_value._int64.is_valid()) {
+    int64_t value = expression->const_value._int64.get();
+    return (value > 0) - (value < 0);
+  }
+  return (expression->const_value._uint64.get() > 0);
+}
+
+/* Print the value of an expression for which is_const_int() returns true. */
+void print_const_int(symbol_c *expression) {
+  if (expression->const_value._int64.is_valid()) {
+    int64_t value = expression->const_value._int64.get();
+    if (value == INT64_MIN) {s4o.print("(-"); s4o.print((long long int)INT64_MAX); s4o.print("LL - 1)"); return;}
+    if (value < 0) {s4o.print("("); s4o.print((long long int)value); s4o.print(")"); return;}
+    s4o.print((long long int)value);
+    return;
+  }
+  s4o.print_long_long_integer(expression->const_value._uint64.get(), expression->const_value._uint64.get() > INT64_MAX);
+}
+
+
+
+/* CONSTANT variables of FBs and PROGRAMs are read directly from their static const C object */
+void *print_const_getter(symbol_c *symbol, const char *getter, symbol_c *pou_name, symbol_c *var_name) {
+  variablegeneration_t old_wanted_variablegeneration = wanted_variablegeneration;
+  s4o.print(getter);
+  s4o.print("(");
+  pou_name->accept(*this);
+  s4o.print(",");
+  var_name->accept(*this);
+  s4o.print(",");
+  wanted_variablegeneration = complextype_suffix_vg;
+  symbol->accept(*this);
+  s4o.print(")");
+  wanted_variablegeneration = old_wanted_variablegeneration;
+  return NULL;
+}
+
+
 void *print_getter(symbol_c *symbol) {
+  symbol_c *const_pou, *const_name;
+  if (analyse_variable_c::first_nonfb_is_static_const(symbol, scope_, &const_pou, &const_name))
+    return print_const_getter(symbol, (wanted_variablegeneration == fparam_output_vg)? GET_CONST_BY_REF : GET_CONST, const_pou, const_name);
+
   unsigned int vartype = analyse_variable_c::first_nonfb_vardecltype(symbol, scope_);
   if (wanted_variablegeneration == fparam_output_vg) {
     if (vartype == search_var_instance_decl_c::external_vt) {
@@ -332,7 +403,7 @@ void *visit(structured_variable_c *symbol) {
         search_var_instance_decl_c search_var_instance_decl(symbol->record_variable->scope);
         if      (search_var_instance_decl_c::external_vt == search_var_instance_decl.get_vartype(get_var_name_c::get_last_field(symbol->record_variable)))
           s4o.print("->");
-        else if (dynamic_cast<deref_operator_c *>(symbol->record_variable) != NULL)
+        else if (symbol->record_variable->is<deref_operator_c>())
           s4o.print("->"); /* please read the comment in visit(deref_operator_c *) tio understand what this line is doing! */
         else  
           s4o.print(".");
@@ -344,7 +415,7 @@ void *visit(structured_variable_c *symbol) {
       // the following condition MUST be a negation of the above condition used in the 'case complextype_base_vg:'
       if (!(   get_datatype_info_c::is_function_block(symbol->record_variable->datatype)     // if the record variable is not a FB... 
             || get_datatype_info_c::is_sfc_step      (symbol->record_variable->datatype))) { // ...nor an SFC step name, then it will certainly be a structure!
-        if (dynamic_cast<deref_operator_c *>(symbol->record_variable) != NULL)
+        if (symbol->record_variable->is<deref_operator_c>())
           s4o.print("->"); /* please read the comment in visit(deref_operator_c *) tio understand what this line is doing! */
         else
           s4o.print(".");
@@ -384,7 +455,7 @@ void *visit(array_variable_c *symbol) {
       current_array_type = search_varfb_instance_type->get_basetype_decl(symbol->subscripted_variable);
       if (current_array_type == NULL) ERROR;
 
-      if (dynamic_cast<deref_operator_c *>(symbol->subscripted_variable) != NULL)
+      if (symbol->subscripted_variable->is<deref_operator_c>())
         s4o.print("->"); /* please read the comment in visit(deref_operator_c *) tio understand what this line is doing! */
       else
         s4o.print(".");
@@ -484,14 +555,15 @@ void *visit(deref_operator_c *symbol) {
     s4o.print(")");  
   } else {
     /* For code in FBs, and PROGRAMS... */
-    if (   (NULL == dynamic_cast<structured_variable_c *>(symbol->parent)) 
-        && (NULL == dynamic_cast<     array_variable_c *>(symbol->parent))) {
+    if (   (NULL == symbol->parent)
+        || (   !symbol->parent->is<structured_variable_c>()
+            && !symbol->parent->is<array_variable_c>())) {
       s4o.print("(*");  
       symbol->exp->accept(*this);    
       s4o.print(")");  
     } else {
       /* We are in a structured variable - the structured_variable_c or the array_variable_c will already have printed out the '->' !! */ 
-      if (NULL != dynamic_cast<deref_operator_c *>(symbol->exp))
+      if (symbol->exp->is<deref_operator_c>())
         STAGE4_ERROR(symbol, symbol->exp, "The use of two or more consecutive derefencing operators between a struct variable and its record elem (ex: struct_ref_ref^^.elem) is currently not supported for code inside a Function_Block.");
       symbol->exp->accept(*this);
     }
@@ -510,6 +582,12 @@ void *visit(deref_expression_c *symbol) {
     s4o.print("");  
   } else {
     /* For code in FBs, and PROGRAMS... */
+    symbol_c *const_pou, *const_name;
+    if (analyse_variable_c::first_nonfb_is_static_const(symbol->exp, scope_, &const_pou, &const_name)) {
+      print_const_getter(symbol->exp, GET_CONST_DREF, const_pou, const_name);
+      s4o.print(")");
+      return NULL;
+    }
     unsigned int vartype = analyse_variable_c::first_nonfb_vardecltype(symbol->exp, scope_);
     if (vartype == search_var_instance_decl_c::external_vt) {
       if (!get_datatype_info_c::is_type_valid    (symbol->exp->datatype)) ERROR;
@@ -550,6 +628,12 @@ void *visit(ref_expression_c *symbol) {
   } else {
     /* For code in FBs, and PROGRAMS... */
     s4o.print("(");  
+    symbol_c *const_pou, *const_name;
+    if (analyse_variable_c::first_nonfb_is_static_const(symbol->exp, scope_, &const_pou, &const_name)) {
+      print_const_getter(symbol->exp, GET_CONST_REF, const_pou, const_name);
+      s4o.print("))");
+      return NULL;
+    }
     unsigned int vartype = analyse_variable_c::first_nonfb_vardecltype(symbol->exp, scope_);
     if (vartype == search_var_instance_decl_c::external_vt) {
       if (!get_datatype_info_c::is_type_valid    (symbol->exp->datatype)) ERROR;
@@ -834,6 +918,10 @@ void *visit(function_invocation_c *symbol) {
   int fdecl_mutiplicity =  function_symtable.count(symbol->function_name);
   if (fdecl_mutiplicity == 0) ERROR;
 
+  /* Check whether we may call the variant of the function without EN and ENO (see generate_c_en_eno.cc) */
+  /* NOTE: the inline function called when has_output_params is true takes care of this itself. */
+  bool lean_call = en_eno_analysis_c::is_lean_call(symbol, f_decl);
+
   if (has_output_params) {
     fcall_number++;
     s4o.print("__");
@@ -856,6 +944,8 @@ void *visit(function_invocation_c *symbol) {
       print_function_parameter_data_types_c overloaded_func_suf(&s4o);
       f_decl->accept(overloaded_func_suf);
     }
+    if (lean_call)
+      s4o.print(FUNCTION_LEAN_SUFFIX);
   }
   s4o.print("(");
   s4o.indent_right();
@@ -865,6 +955,8 @@ void *visit(function_invocation_c *symbol) {
   PARAM_LIST_ITERATOR() {
     symbol_c *param_value = PARAM_VALUE;
     current_param_type = PARAM_TYPE;
+    if (lean_call && !has_output_params && en_eno_analysis_c::is_en_eno_param(PARAM_NAME))
+      continue;
           
     switch (PARAM_DIRECTION) {
       case function_param_iterator_c::direction_in:
@@ -1124,22 +1216,47 @@ void *visit(not_paramassign_c *symbol) {
 /********************************/
 /* B 3.2.3 Selection Statements */
 /********************************/
+/* NOTE: The branches whose condition is constant FALSE are not generated, and neither are the
+ *       branches following a branch whose condition is constant TRUE (that branch then becomes
+ *       the 'else' of the C code). The number of branches removed is added to the statistics.
+ */
 void *visit(if_statement_c *symbol) {
-  s4o.print("if (");
-  symbol->expression->accept(*this);
-  s4o.print(") {\n");
-  s4o.indent_right();
-  symbol->statement_list->accept(*this);
-  s4o.indent_left();
-  symbol->elseif_statement_list->accept(*this);
-
-  if (symbol->else_statement_list != NULL) {
-    s4o.print(s4o.indent_spaces); s4o.print("} else {\n");
+  /* The list of branches: (condition, statement_list). The ELSE branch has a NULL condition. */
+  std::vector<std::pair<symbol_c *, symbol_c *> > branches;
+  branches.push_back(std::make_pair(symbol->expression, symbol->statement_list));
+  list_c *elseif_list = dynamic_cast<list_c *>(symbol->elseif_statement_list);
+  for (int i = 0; (NULL != elseif_list) && (i < elseif_list->n); i++) {
+    elseif_statement_c *elseif = elseif_list->elements[i]->as<elseif_statement_c>();
+    if (NULL == elseif) ERROR;
+    branches.push_back(std::make_pair(elseif->expression, elseif->statement_list));
+  }
+  if (symbol->else_statement_list != NULL)
+    branches.push_back(std::make_pair((symbol_c *)NULL, symbol->else_statement_list));
+
+  size_t generated = 0;
+  for (size_t i = 0; i < branches.size(); i++) {
+    symbol_c *condition = branches[i].first;
+    if ((condition != NULL) && is_const_bool(condition, false))
+      continue; /* never executed */
+    bool always = (condition == NULL) || is_const_bool(condition, true);
+
+    if (generated > 0) {s4o.print(s4o.indent_spaces); s4o.print("} else ");}
+    if (always) s4o.print("{\n");
+    else {
+      s4o.print("if (");
+      condition->accept(*this);
+      s4o.print(") {\n");
+    }
     s4o.indent_right();
-    symbol->else_statement_list->accept(*this);
+    branches[i].second->accept(*this);
     s4o.indent_left();
+    generated++;
+    if (always) break; /* the remaining branches are never executed */
   }
-  s4o.print(s4o.indent_spaces); s4o.print("}");
+  if (generated > 0) {s4o.print(s4o.indent_spaces); s4o.print("}");}
+
+  if (generated < branches.size())
+    stats_c::add_counter("stage4", "dead_if_branches_removed", branches.size() - generated);
   return NULL;
 }
 
@@ -1157,7 +1274,58 @@ void *visit(elseif_statement_c *symbol) {
   return NULL;
 }
 
+/* Find the statement list of the CASE statement that is executed, when the value of the
+ * selector and of all the case labels were determined at compile time.
+ * Returns false if this is not possible. Otherwise, *statement_list is the selected
+ * statement list (NULL when no statement is executed), and *removed the number of
+ * statement lists that are never executed.
+ */
+bool get_const_case(case_statement_c *symbol, symbol_c **statement_list, int *removed) {
+  int64_t selector, lower, upper;
+  if (!get_const_int(symbol->expression, &selector)) return false;
+  list_c *elements = dynamic_cast<list_c *>(symbol->case_element_list);
+  if (NULL == elements) return false;
+
+  *statement_list = NULL;
+  for (int i = 0; i < elements->n; i++) {
+    case_element_c *element = elements->elements[i]->as<case_element_c>();
+    list_c *labels = (NULL == element)? NULL : dynamic_cast<list_c *>(element->case_list);
+    if (NULL == labels) return false;
+    for (int j = 0; j < labels->n; j++) {
+      subrange_c *subrange = labels->elements[j]->as<subrange_c>();
+      if (NULL == subrange) {
+        if (!get_const_int(labels->elements[j], &lower)) return false;
+        upper = lower;
+      } else {
+        if (!get_const_int(subrange->lower_limit, &lower) || !get_const_int(subrange->upper_limit, &upper)) return false;
+      }
+      /* the first matching case element is executed */
+      if ((NULL == *statement_list) && (selector >= lower) && (selector <= upper))
+        *statement_list = element->statement_list;
+    }
+  }
+  if (NULL == *statement_list) *statement_list = symbol->statement_list; /* the ELSE statements, if any */
+  *removed = elements->n + ((NULL == symbol->statement_list)? 0 : 1) - ((NULL == *statement_list)? 0 : 1);
+  return true;
+}
+
+/* NOTE: When the value of the selector is known at compile time (and so are the case labels), only
+ *       the statements that are executed are generated, and the number of statement lists removed
+ *       is added to the statistics.
+ */
 void *visit(case_statement_c *symbol) {
+  symbol_c *const_statement_list;
+  int removed;
+  if (get_const_case(symbol, &const_statement_list, &removed)) {
+    if (removed > 0) stats_c::add_counter("stage4", "dead_case_branches_removed", removed);
+    s4o.print("{\n");
+    s4o.indent_right();
+    if (NULL != const_statement_list) const_statement_list->accept(*this);
+    s4o.indent_left();
+    s4o.print(s4o.indent_spaces + "}");
+    return NULL;
+  }
+
   symbol_c *expression_type = symbol->expression->datatype;
   s4o.print("{\n");
   s4o.indent_right();
@@ -1213,7 +1381,7 @@ void *visit(case_list_c *symbol) {
      */
     if (0 != i)  s4o.print(" ||\n" + s4o.indent_spaces + "         ");
     s4o.print("(");
-    subrange_c *subrange = dynamic_cast<subrange_c *>(symbol->elements[i]);
+    subrange_c *subrange = symbol->elements[i]->as<subrange_c>();
     if (NULL == subrange) {
       s4o.print("__case_expression == ");
       symbol->elements[i]->accept(*this);
@@ -1233,43 +1401,83 @@ void *visit(case_list_c *symbol) {
 /* B 3.2.4 Iteration Statements */
 /********************************/
 void *visit(for_statement_c *symbol) {
+  /* The end and BY expressions are evaluated only once, right after the initial value
+   * has been assigned to the control variable, and before the first iteration.
+   * Their values are stored in the __for_end<n> and __for_by<n> temporary variables (where
+   * <n> is the nesting depth of the loop, starting at 1), so the
+   * C compiler knows they do not change inside the loop. When their values were
+   * determined at compile time (by stage3), these values are used directly instead.
+   *
+   * When the sign of the BY value is known at compile time, only the corresponding
+   * test ('<=' or '>=') is generated. Otherwise, the test is chosen at runtime,
+   * based on the (loop invariant) __for_by variable.
+   *
+   * e.g.:  FOR i := 1 TO n BY step DO ... END_FOR;
+   *  {
+   *    INT __for_end1, __for_by1;
+   *    for(i = 1, __for_end1 = n, __for_by1 = step; ((__for_by1 > 0)? (i <= __for_end1) : (i >= __for_end1)); i += __for_by1) {
+   *      ...
+   *    }
+   *  }
+   */
+  bool const_end = is_const_int(symbol->end_expression);
+  bool const_by  = (symbol->by_expression == NULL) || is_const_int(symbol->by_expression);
+  /* the sign of the BY value, when known */
+  bool by_positive = (symbol->by_expression == NULL) || !const_by || (const_int_sign(symbol->by_expression) > 0);
+  for_depth++;
+
+  if (!const_end || !const_by) {
+    s4o.print("{\n");
+    s4o.indent_right();
+    s4o.print(s4o.indent_spaces);
+    symbol->control_variable->datatype->accept(*this);
+    if (!const_end)                {s4o.print(" __for_end"); s4o.print(for_depth);}
+    if (!const_end && !const_by)   s4o.print(",");
+    if (!const_by)                 {s4o.print(" __for_by");  s4o.print(for_depth);}
+    s4o.print(";\n");
+    s4o.print(s4o.indent_spaces);
+  }
+
+  /* initialisation */
   s4o.print("for(");
   symbol->control_variable->accept(*this);
   s4o.print(" = ");
   symbol->beg_expression->accept(*this);
-  s4o.print("; ");
-  if (symbol->by_expression == NULL) {
-    /* increment by 1 */
-    symbol->control_variable->accept(*this);
-    s4o.print(" <= ");
+  if (!const_end) {
+    s4o.print(", __for_end"); s4o.print(for_depth); s4o.print(" = ");
     symbol->end_expression->accept(*this);
-    s4o.print("; ");
-    symbol->control_variable->accept(*this);
-    s4o.print("++");
-  } else {
-    /* increment by user defined value  */
-    /* The user defined increment value may be negative, in which case
-     * the expression to determine whether we have reached the end of the loop
-     * changes from a '<=' to a '>='.
-     * Since the increment value may change during runtime (remember, it is
-     * an expression, so may contain variables), choosing which test
-     * to use has to be done at runtime.
-     */
-    s4o.print("((");
+  }
+  if (!const_by) {
+    s4o.print(", __for_by"); s4o.print(for_depth); s4o.print(" = ");
     symbol->by_expression->accept(*this);
-    s4o.print(") > 0)? (");
-    symbol->control_variable->accept(*this);
-    s4o.print(" <= (");
-    symbol->end_expression->accept(*this);
-    s4o.print(")) : (");
+  }
+  s4o.print("; ");
+
+  /* test */
+  if (!const_by) {s4o.print("((__for_by"); s4o.print(for_depth); s4o.print(" > 0)? (");}
+  if (!const_by || by_positive) {
     symbol->control_variable->accept(*this);
-    s4o.print(" >= (");
-    symbol->end_expression->accept(*this);
-    s4o.print(")); ");
+    s4o.print(" <= ");
+    if (const_end) print_const_int(symbol->end_expression);
+    else           {s4o.print("__for_end"); s4o.print(for_depth);}
+  }
+  if (!const_by) s4o.print(") : (");
+  if (!const_by || !by_positive) {
     symbol->control_variable->accept(*this);
-    s4o.print(" += (");
-    symbol->by_expression->accept(*this);
-    s4o.print(")");
+    s4o.print(" >= ");
+    if (const_end) print_const_int(symbol->end_expression);
+    else           {s4o.print("__for_end"); s4o.print(for_depth);}
+  }
+  if (!const_by) s4o.print("))");
+  s4o.print("; ");
+
+  /* increment */
+  symbol->control_variable->accept(*this);
+  if      (symbol->by_expression == NULL) s4o.print("++");
+  else if (!const_by)                     {s4o.print(" += __for_by"); s4o.print(for_depth);}
+  else {
+    s4o.print(" += ");
+    print_const_int(symbol->by_expression);
   }
   s4o.print(")");
   
@@ -1278,10 +1486,22 @@ void *visit(for_statement_c *symbol) {
   symbol->statement_list->accept(*this);
   s4o.indent_left();
   s4o.print(s4o.indent_spaces); s4o.print("}");
+
+  if (!const_end || !const_by) {
+    s4o.print("\n");
+    s4o.indent_left();
+    s4o.print(s4o.indent_spaces); s4o.print("}");
+  }
+  for_depth--;
   return NULL;
 }
 
 void *visit(while_statement_c *symbol) {
+  if (is_const_bool(symbol->expression, false)) {
+    /* the loop body is never executed */
+    stats_c::add_counter("stage4", "dead_while_loops_removed");
+    return NULL;
+  }
   s4o.print("while (");
   symbol->expression->accept(*this);
   s4o.print(") {\n");
@@ -1292,14 +1512,23 @@ void *visit(while_statement_c *symbol) {
   return NULL;
 }
 
+/* The loop is repeated while the UNTIL expression is FALSE. When the value of the expression was
+ * determined at compile time, the loop is either executed once or forever (until an EXIT), and the
+ * test is not generated. The do { } while() is kept in both cases, as the body may contain an EXIT.
+ */
 void *visit(repeat_statement_c *symbol) {
   s4o.print("do {\n");
   s4o.indent_right();
   symbol->statement_list->accept(*this);
   s4o.indent_left();
-  s4o.print(s4o.indent_spaces); s4o.print("} while(");
-  symbol->expression->accept(*this);
-  s4o.print(")");
+  s4o.print(s4o.indent_spaces);
+  if      (is_const_bool(symbol->expression, true )) s4o.print("} while(0)");
+  else if (is_const_bool(symbol->expression, false)) s4o.print("} while(1)");
+  else {
+    s4o.print("} while(!(");
+    symbol->expression->accept(*this);
+    s4o.print("))");
+  }
   return NULL;
 }
 
@@ -872,7 +872,7 @@ void *visit(ref_type_decl_c *symbol) {
    *       only declare the datatypes that have not been previously defined.
    */
   identifier_c *tmp_id;
-  tmp_id = dynamic_cast<identifier_c *>(symbol->ref_type_name);
+  tmp_id = symbol->ref_type_name->as<identifier_c>();
   if (NULL == tmp_id) ERROR;
   if (datatypes_already_defined.find(tmp_id->value) != datatypes_already_defined.end())
     return NULL; // already defined. No need to define it again!!
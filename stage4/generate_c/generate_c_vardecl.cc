@@ -24,6 +24,192 @@
 
 #include <limits>  // required for std::numeric_limits<XXX>
 
+
+/* returns true if the initial value of a variable of this datatype is a C constant expression, so it may
+ * be stored in a static const C object. This is not the case for FB instances, references, and DATE and DT
+ * values (which are converted by the __date_to_timespec() and __dt_to_timespec() functions), nor for arrays
+ * and structures containing any of these.
+ */
+static bool is_c_constant_type(symbol_c *type_symbol) {
+  if (get_datatype_info_c::is_function_block(type_symbol) || get_datatype_info_c::is_ref_to(type_symbol)) return false;
+  symbol_c *type_decl = search_base_type_c::get_basetype_decl(type_symbol);
+  if (NULL == type_decl) return true; /* e.g. STRING[n] */
+  if (   type_decl->is<date_type_name_c>() || type_decl->is<safedate_type_name_c>()
+      || type_decl->is<dt_type_name_c>()   || type_decl->is<safedt_type_name_c>())
+    return false;
+  array_specification_c *array = type_decl->as<array_specification_c>();
+  if (NULL != array)
+    return is_c_constant_type(array->non_generic_type_name);
+  structure_element_declaration_list_c *elements = type_decl->as<structure_element_declaration_list_c>();
+  if (NULL != elements) {
+    for (int i = 0; i < elements->n; i++) {
+      structure_element_declaration_c *element = elements->elements[i]->as<structure_element_declaration_c>();
+      if ((NULL == element) || !is_c_constant_type(element->spec_init)) return false;
+    }
+  }
+  return true;
+}
+
+
+/* defined in generate_c_en_eno.cc */
+static std::string names_digest(const std::set<std::string> &names);
+
+
+/* Determines the VAR_GLOBAL CONSTANT variables of the configuration and of its resources that are declared
+ * as const C objects (see generate_c_vardecl_c::constdecl_vf), instead of as __IEC_<type>_t global variables.
+ * The POUs access these directly (using the __GET_CONST*() macros) instead of through the pointers of their
+ * VAR_EXTERNAL CONSTANT variables, which are left out of the POU's data structure.
+ *
+ * Since the C code of a POU is shared by all of its instances, a VAR_GLOBAL CONSTANT is only handled this way when:
+ *   - its name is declared only once in the configuration and its resources, so every VAR_EXTERNAL of that
+ *     name refers to it, whichever resource the POU instance belongs to;
+ *   - every VAR_EXTERNAL of that name is CONSTANT;
+ *   - it is not located, and its initial value is a C constant expression (see is_c_constant_type());
+ *   - it is not referenced by the configuration itself (task single sources, program connections, VAR_ACCESS
+ *     and VAR_CONFIG), whose C code accesses the global variables through __GET_GLOBAL_<name>().
+ * These variables are not listed in VARIABLES.csv, so they cannot be debugged.
+ */
+class global_const_analysis_c: public iterator_visitor_c {
+  private:
+    typedef std::map<std::string, symbol_c *, nocasecmp_c> domain_map_t;
+    typedef std::map<std::string, int,        nocasecmp_c> count_map_t;
+    typedef std::set<std::string,             nocasecmp_c> name_set_t;
+
+    /* the VAR_GLOBAL CONSTANT variables declared as const C objects -> name of the configuration or resource declaring them */
+    static domain_map_t const_globals;
+
+    domain_map_t candidates;   /* the VAR_GLOBAL CONSTANT variables that may be declared as const C objects */
+    count_map_t  declarations; /* the number of declarations of each global variable name */
+    name_set_t   excluded;     /* the names of non CONSTANT VAR_EXTERNALs, and the names referenced by the configuration */
+    symbol_c    *current_domain;
+    bool         configuration_found;
+    bool         collect_references;
+
+    global_const_analysis_c(void) {current_domain = NULL; configuration_found = false; collect_references = false;}
+
+  public:
+    /* Must be called once, before generating the C code of any POU or configuration. */
+    static void analyse(library_c *library) {
+      const_globals.clear();
+      global_const_analysis_c global_const_analysis;
+      library->accept(global_const_analysis);
+      for (domain_map_t::iterator iter = global_const_analysis.candidates.begin(); iter != global_const_analysis.candidates.end(); ++iter)
+        if (   (global_const_analysis.declarations[iter->first] == 1)
+            && (global_const_analysis.excluded.find(iter->first) == global_const_analysis.excluded.end()))
+          const_globals[iter->first] = iter->second;
+    }
+
+    /* Returns the name of the configuration or resource declaring the global variable 'var_name', if
+     * it is declared as a const C object, or NULL otherwise.
+     */
+    static symbol_c *get_domain(symbol_c *var_name) {
+      token_c *token = dynamic_cast<token_c *>(var_name);
+      if (NULL == token) return NULL;
+      domain_map_t::iterator iter = const_globals.find(token->value);
+      return (iter == const_globals.end())? NULL : iter->second;
+    }
+
+    /* A digest of the results of the analysis (the generated C code of the POUs depends on these results) */
+    static std::string digest(void) {
+      std::set<std::string> names;
+      for (domain_map_t::iterator iter = const_globals.begin(); iter != const_globals.end(); ++iter) {
+        token_c *domain = dynamic_cast<token_c *>(iter->second);
+        names.insert(std::string((NULL == domain)? "" : domain->value) + "." + iter->first);
+      }
+      return names_digest(names);
+    }
+
+  private:
+    /* C code generation only supports a single configuration */
+    void *visit(configuration_declaration_c *symbol) {
+      if (configuration_found) return NULL;
+      configuration_found = true;
+      current_domain = symbol->configuration_name;
+      if (NULL != symbol->global_var_declarations) symbol->global_var_declarations->accept(*this);
+      symbol->resource_declarations->accept(*this);
+      collect_references = true;
+      if (NULL != symbol->access_declarations)              symbol->access_declarations->accept(*this);
+      if (NULL != symbol->instance_specific_initializations) symbol->instance_specific_initializations->accept(*this);
+      collect_references = false;
+      current_domain = NULL;
+      return NULL;
+    }
+
+    void *visit(resource_declaration_c *symbol) {
+      symbol_c *configuration_name = current_domain;
+      current_domain = symbol->resource_name;
+      if (NULL != symbol->global_var_declarations) symbol->global_var_declarations->accept(*this);
+      symbol->resource_declaration->accept(*this);
+      current_domain = configuration_name;
+      return NULL;
+    }
+
+    /* task and program configurations */
+    void *visit(single_resource_declaration_c *symbol) {
+      collect_references = true;
+      iterator_visitor_c::visit(symbol);
+      collect_references = false;
+      return NULL;
+    }
+
+    void *visit(identifier_c *symbol) {
+      if (collect_references) excluded.insert(symbol->value);
+      return NULL;
+    }
+
+    /* VAR_GLOBAL [CONSTANT|RETAIN] global_var_decl_list END_VAR */
+    void *visit(global_var_declarations_c *symbol) {
+      bool is_constant = (NULL != symbol->option) && symbol->option->is<constant_option_c>();
+      list_c *decl_list = dynamic_cast<list_c *>(symbol->global_var_decl_list);
+      if (NULL == decl_list) ERROR;
+      for (int i = 0; i < decl_list->n; i++) {
+        global_var_decl_c *decl = decl_list->elements[i]->as<global_var_decl_c>();
+        if (NULL == decl) ERROR;
+        global_var_spec_c *located = decl->global_var_spec->as<global_var_spec_c>();
+        if (NULL != located) {
+          token_c *name = dynamic_cast<token_c *>(located->global_var_name);
+          if (NULL != name) declarations[name->value]++;
+          continue;
+        }
+        list_c *name_list = dynamic_cast<list_c *>(decl->global_var_spec);
+        if (NULL == name_list) ERROR;
+        symbol_c *type_symbol = spec_init_sperator_c::get_spec(decl->type_specification);
+        for (int j = 0; j < name_list->n; j++) {
+          token_c *name = dynamic_cast<token_c *>(name_list->elements[j]);
+          if (NULL == name) ERROR;
+          declarations[name->value]++;
+          if (is_constant && (NULL != type_symbol) && is_c_constant_type(type_symbol))
+            candidates[name->value] = current_domain;
+        }
+      }
+      return NULL;
+    }
+
+    /* VAR_EXTERNAL [CONSTANT] external_declaration_list END_VAR */
+    void *visit(external_var_declarations_c *symbol) {
+      if ((NULL != symbol->option) && symbol->option->is<constant_option_c>()) return NULL;
+      list_c *decl_list = dynamic_cast<list_c *>(symbol->external_declaration_list);
+      if (NULL == decl_list) ERROR;
+      for (int i = 0; i < decl_list->n; i++) {
+        external_declaration_c *decl = decl_list->elements[i]->as<external_declaration_c>();
+        token_c *name = (NULL == decl)? NULL : dynamic_cast<token_c *>(decl->global_var_name);
+        if (NULL == name) ERROR;
+        excluded.insert(name->value);
+      }
+      return NULL;
+    }
+
+    /* only the variable declarations of the POUs are of interest */
+    void *visit(function_declaration_c       *symbol) {return NULL;}
+    void *visit(function_block_declaration_c *symbol) {return symbol->var_declarations->accept(*this);}
+    void *visit(program_declaration_c        *symbol) {return symbol->var_declarations->accept(*this);}
+    void *visit(data_type_declaration_c      *symbol) {return NULL;}
+};
+
+
+global_const_analysis_c::domain_map_t global_const_analysis_c::const_globals;
+
+
 class initialization_analyzer_c: public null_visitor_c {
   public:
     typedef enum {
@@ -60,6 +246,16 @@ class initialization_analyzer_c: public null_visitor_c {
 
 
 
+/* Single dimension arrays with more elements than the following, whose elements are of an elementary
+ * datatype, are initialised by C code that handles each run of repeated values with a loop (see init_array()),
+ * instead of by copying a fully expanded C literal.
+ */
+#define ARRAY_INIT_MAX_LITERAL_SIZE 256
+/* In the above case, runs of at least this number of repeated values are initialised by a loop.
+ * The remaining values are copied from a (static const) C array containing only those values.
+ */
+#define ARRAY_INIT_MIN_RUN 8
+
 class generate_c_array_initialization_c: public generate_c_base_and_typeid_c {
 
   public:
@@ -78,16 +274,135 @@ class generate_c_array_initialization_c: public generate_c_base_and_typeid_c {
 
   private:
     int current_dimension;
+    int array_dimensions;
     unsigned long long int array_size;
     unsigned long long int defined_values_count;
     unsigned long long int current_initialization_count;
 
+    /* The values of the elements of the array, in order, as a list of runs of repeated values
+     * (i.e. the value, and the number of consecutive elements initialised to that value).
+     */
+    typedef std::vector<std::pair<symbol_c *, unsigned long long int> > runs_t;
+    runs_t runs;
+
+    void add_run(symbol_c *value, unsigned long long int count) {
+      if (count == 0) return;
+      if (!runs.empty() && (runs.back().first == value)) runs.back().second += count;
+      else                                               runs.push_back(std::make_pair(value, count));
+    }
+
+    /* Determine the values of all the elements of the array (the runs) */
+    void get_array_values(symbol_c *array_initialization) {
+      runs.clear();
+      current_mode = initializationvalue_am;
+      array_initialization->accept(*this);
+
+      if (array_default_initialization != NULL && defined_values_count < array_size)
+        array_default_initialization->accept(*this);
+      if (defined_values_count < array_size) {
+        add_run(array_default_value, array_size - defined_values_count);
+        defined_values_count = array_size;
+      }
+    }
+
+    /* Print the values of the elements in runs[first..last[, separated by commas */
+    void print_array_values(size_t first, size_t last) {
+      current_mode = initializationvalue_am;
+      for (size_t r = first; r < last; r++)
+        for (unsigned long long int i = 0; i < runs[r].second; i++) {
+          if ((r > first) || (i > 0))
+            s4o.print(",");
+          runs[r].first->accept(*this);
+        }
+    }
+
+    /* Initialise the (single dimension) array variables in var1_list one run of repeated values at a time
+     *   e.g.   ARRAY [0..999] OF REAL := [2(1.5), 2.5, 997(0.0)]
+     *   {
+     *     static const REAL __values0[] = {1.5,1.5,2.5};
+     *     unsigned long long int __i;
+     *     for (__i = 0; __i < 3; __i++) __SET_VAR(data__->,A,.table[0 + __i],__values0[__i]);
+     *     for (__i = 0; __i < 997; __i++) __SET_VAR(data__->,A,.table[3 + __i],0.0);
+     *   }
+     * Each element is set with __SET_VAR(), like the other variables, so a variable forced
+     * by the debugger keeps its forced value.
+     */
+    /* Print the start of the __SET_VAR() of element (<index> + __i) of the array variable, up to the new value */
+    void print_set_element(symbol_c *var_name, unsigned long long int index) {
+      s4o.print(SET_VAR "(");
+      print_variable_prefix();
+      s4o.print(",");
+      var_name->accept(*this);
+      s4o.print(",.table[");
+      s4o.print_long_long_integer(index, false);
+      s4o.print(" + __i],");
+    }
+
+    void init_array_runs(symbol_c *var1_list) {
+      /* group the short runs into segments, whose values are stored in static const C arrays */
+      std::vector<std::pair<size_t, size_t> > segments; /* [first run, last run[ */
+      for (size_t r = 0; r < runs.size(); r++) {
+        if (runs[r].second >= ARRAY_INIT_MIN_RUN) continue;
+        if (segments.empty() || (segments.back().second != r)) segments.push_back(std::make_pair(r, r + 1));
+        else                                                   segments.back().second = r + 1;
+      }
+
+      s4o.print("\n");
+      s4o.print(s4o.indent_spaces + "{\n");
+      s4o.indent_right();
+      for (size_t k = 0; k < segments.size(); k++) {
+        s4o.print(s4o.indent_spaces + (is_c_constant_type(array_base_type)? "static const " : "const "));
+        current_mode = typedecl_am;
+        array_base_type->accept(*this);
+        s4o.print(" __values");
+        s4o.print((unsigned long)k);
+        s4o.print("[] = {");
+        print_array_values(segments[k].first, segments[k].second);
+        s4o.print("};\n");
+      }
+      s4o.print(s4o.indent_spaces + "unsigned long long int __i;\n");
+
+      list_c *list = dynamic_cast<list_c *>(var1_list);
+      if (NULL == list) ERROR;
+      for (int v = 0; v < list->n; v++) {
+        unsigned long long int index = 0;
+        size_t k = 0;
+        for (size_t r = 0; r < runs.size(); ) {
+          s4o.print(s4o.indent_spaces + "for (__i = 0; __i < ");
+          if ((k < segments.size()) && (segments[k].first == r)) {
+            unsigned long long int count = 0;
+            for (size_t i = segments[k].first; i < segments[k].second; i++) count += runs[i].second;
+            s4o.print_long_long_integer(count, false);
+            s4o.print("; __i++) ");
+            print_set_element(list->elements[v], index);
+            s4o.print("__values");
+            s4o.print((unsigned long)k);
+            s4o.print("[__i]);\n");
+            index += count;
+            r = segments[k++].second;
+          } else {
+            s4o.print_long_long_integer(runs[r].second, false);
+            s4o.print("; __i++) ");
+            print_set_element(list->elements[v], index);
+            current_mode = initializationvalue_am;
+            runs[r].first->accept(*this);
+            s4o.print(");\n");
+            index += runs[r].second;
+            r++;
+          }
+        }
+      }
+      s4o.indent_left();
+      s4o.print(s4o.indent_spaces + "}");
+    }
+
   public:
     generate_c_array_initialization_c(stage4out_c *s4o_ptr): generate_c_base_and_typeid_c(s4o_ptr) {}
     ~generate_c_array_initialization_c(void) {}
 
     void init_array_size(symbol_c *array_specification) {
       array_size = 1;
+      array_dimensions = 0;
       defined_values_count = 0;
       current_initialization_count = 0;
       array_base_type = array_default_value = array_default_initialization = NULL;
@@ -101,45 +416,35 @@ class generate_c_array_initialization_c: public generate_c_base_and_typeid_c {
     }
 
     void init_array(symbol_c *var1_list, symbol_c *array_specification, symbol_c *array_initialization) {
-      int i;
-      
       init_array_size(array_specification);
+      get_array_values(array_initialization);
+
+      if (   (array_size > ARRAY_INIT_MAX_LITERAL_SIZE)
+          && (array_dimensions == 1)
+          && (   get_datatype_info_c::is_ANY_ELEMENTARY    (array_base_type)
+              || get_datatype_info_c::is_ANY_SAFEELEMENTARY(array_base_type)))
+        {init_array_runs(var1_list); return;}
       
       s4o.print("\n");
       s4o.print(s4o.indent_spaces + "{\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
-      s4o.print("static const ");
+      s4o.print(is_c_constant_type(array_base_type)? "static const " : "const ");
 
       current_mode = typedecl_am;
       array_specification->accept(*this);
-      s4o.print(" temp = ");
-
-      init_array_values(array_initialization);
-
-      s4o.print(";\n");
+      s4o.print(" temp = {{");
+      print_array_values(0, runs.size());
+      s4o.print("}};\n");
       var1_list->accept(*this);
       s4o.indent_left();
       s4o.print(s4o.indent_spaces + "}");
     }
     
     void init_array_values(symbol_c *array_initialization) {
+      get_array_values(array_initialization);
       s4o.print("{{");
-
-      current_mode = initializationvalue_am;
-      array_initialization->accept(*this);
-
-      if (array_default_initialization != NULL && defined_values_count < array_size)
-        array_default_initialization->accept(*this);
-      if (defined_values_count < array_size) {
-        for (unsigned long long int i = defined_values_count; i < array_size; i++) {
-          if (defined_values_count > 0)
-            s4o.print(",");
-          array_default_value->accept(*this);
-          defined_values_count++;
-        }
-      }
-
+      print_array_values(0, runs.size());
       s4o.print("}}");
     }
     
@@ -225,6 +530,7 @@ class generate_c_array_initialization_c: public generate_c_base_and_typeid_c {
     void *visit(subrange_c *symbol) {
       switch (current_mode) {
         case arraysize_am:
+          array_dimensions++;
           /* res = a * b; --->  Check for overflow by pre-condition: If (UINT_MAX / a) < b => overflow! */
           if ((std::numeric_limits< unsigned long long int >::max() / array_size) < symbol->dimension)
             STAGE4_ERROR(symbol, symbol, "The array containing this subrange has a total number of elements larger than the maximum currently supported (%llu).", 
@@ -247,13 +553,14 @@ class generate_c_array_initialization_c: public generate_c_base_and_typeid_c {
             if (current_initialization_count >= defined_values_count) {
               if (defined_values_count >= array_size)
                 ERROR;
-              if (defined_values_count > 0)
-                s4o.print(",");
-              symbol->elements[i]->accept(*this);
+              if (symbol->elements[i]->is<array_initial_elements_c>())
+                symbol->elements[i]->accept(*this);
+              else
+                add_run(symbol->elements[i], 1);
               defined_values_count++;
             }
             else {
-              array_initial_elements_c *array_initial_element = dynamic_cast<array_initial_elements_c *>(symbol->elements[i]);
+              array_initial_elements_c *array_initial_element = symbol->elements[i]->as<array_initial_elements_c>();
             
               if (array_initial_element != NULL) {
                 symbol->elements[i]->accept(*this);
@@ -292,25 +599,17 @@ class generate_c_array_initialization_c: public generate_c_base_and_typeid_c {
               temp_element_number = initial_element_count - diff;
             current_initialization_count += initial_element_count - 1;
             initial_element_count = temp_element_number;
-            if (initial_element_count > 0) {
+            if (initial_element_count > 0)
               defined_values_count++;
-              s4o.print(",");
-            }
           }
           else
             current_initialization_count += initial_element_count - 1;
           if (defined_values_count + initial_element_count > array_size)
             ERROR;
-          for (unsigned long long int i = 0; i < initial_element_count; i++) {
-            if (i > 0)
-              s4o.print(",");
-            if (symbol->array_initial_element != NULL) {
-              symbol->array_initial_element->accept(*this);
-            }
-            else {
-              array_default_value->accept(*this);
-            }
-          }
+          if (symbol->array_initial_element != NULL)
+            add_run(symbol->array_initial_element, initial_element_count);
+          else
+            add_run(array_default_value, initial_element_count);
           if (initial_element_count > 1)
             defined_values_count += initial_element_count - 1;
           break;
@@ -382,7 +681,7 @@ class structure_element_iterator_c : public null_visitor_c {
       res = type_decl->accept(*this);
       if (res != NULL) {
         symbol_c *sym = (symbol_c *)res;
-        identifier = dynamic_cast<identifier_c *>(sym);
+        identifier = sym->as<identifier_c>();
         if (identifier == NULL)
           ERROR;
       }
@@ -461,7 +760,7 @@ class structure_init_element_iterator_c : public null_visitor_c {
     /* Search for the value passed to the element named <element_name>...  */
     symbol_c *search(symbol_c *element_name) {
       if (NULL == element_name) ERROR;
-      search_element_name = dynamic_cast<identifier_c *>(element_name);
+      search_element_name = element_name->as<identifier_c>();
       if (NULL == search_element_name) ERROR;
       void *res = structure_initialization->accept(*this);
       return (symbol_c *)res;
@@ -481,7 +780,7 @@ class structure_init_element_iterator_c : public null_visitor_c {
     
     /*  structure_element_name ASSIGN value */
     void *visit(structure_element_initialization_c *symbol) {
-      identifier_c *element_name = dynamic_cast<identifier_c *>(symbol->structure_element_name);
+      identifier_c *element_name = symbol->structure_element_name->as<identifier_c>();
       
       if (element_name == NULL) ERROR;
       
@@ -536,7 +835,7 @@ class generate_c_structure_initialization_c: public generate_c_base_and_typeid_c
       s4o.print(s4o.indent_spaces + "{\n");
       s4o.indent_right();
       s4o.print(s4o.indent_spaces);
-      s4o.print("static const ");
+      s4o.print(is_c_constant_type(structure_type_name)? "static const " : "const ");
 
       current_mode = typedecl_sm;
       structure_type_name->accept(*this);
@@ -852,6 +1151,24 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
      *
      *                e.g.
      *                __plc_pt_c<INT, 8*sizeof(INT)> START_P::loc = __plc_pt_c<INT, 8*sizeof(INT)>("I2");
+     *
+     * constdecl_vf: declaration of the CONSTANT variables (VAR CONSTANT, see is_static_const_var())
+     *               of a FB or PROGRAM, as extern const C objects. These variables are not
+     *               stored in the FB's data structure (i.e. they are left out by local_vf and
+     *               constructorinit_vf), and are accessed using the __GET_CONST*() macros.
+     *               The name of the FB or PROGRAM must be passed as the second parameter
+     *               to the print() function.
+     *               The VAR_GLOBAL CONSTANT variables selected by global_const_analysis_c are
+     *               declared the same way by globalprototype_vf.
+     *                e.g.
+     *                __DECLARE_CONST(INT,MY_FB,MAX_COUNT)
+     *
+     * constdef_vf:  definition (with the initial value) of the const C objects declared by
+     *               constdecl_vf. These are printed only once, in the POU's C file.
+     *               The VAR_GLOBAL CONSTANT variables selected by global_const_analysis_c are
+     *               defined the same way by local_vf.
+     *                e.g.
+     *                __DEFINE_CONST(INT,MY_FB,MAX_COUNT,100)
      */
     typedef enum {finterface_vf,
                   foutputassign_vf,
@@ -860,7 +1177,9 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
                   init_vf,
                   constructorinit_vf,
                   globalinit_vf,
-                  globalprototype_vf
+                  globalprototype_vf,
+                  constdecl_vf,
+                  constdef_vf
                  } varformat_t;
 
 
@@ -905,6 +1224,8 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
      */
     symbol_c *current_var_type_symbol;
     symbol_c *current_var_init_symbol;
+    /* Set while declaring (localinit_vf) the CONSTANT variables of a function that are declared as 'static const' */
+    bool current_var_static_const;
     void update_type_init(symbol_c *symbol /* a spec_init_c, subrange_spec_init_c, etc... */ ) {
       this->current_var_type_symbol = spec_init_sperator_c::get_spec(symbol);
       this->current_var_init_symbol = spec_init_sperator_c::get_init(symbol);
@@ -934,7 +1255,7 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
       this->current_var_init_symbol = NULL;
     }
 
-    /* Only used when wanted_varformat == globalinit_vf
+    /* Only used when wanted_varformat == globalinit_vf, constdecl_vf or constdef_vf
      * Holds a pointer to an identifier_c, which in turns contains
      * the identifier of the scope within which the static member was
      * declared.
@@ -957,6 +1278,36 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
       return NULL;
     }
 
+    /* The CONSTANT variables of FBs and PROGRAMs that are declared as const C objects (see constdecl_vf),
+     * and the CONSTANT variables of FUNCTIONs that are declared as 'static const' locals.
+     */
+    bool is_static_const_decl(symbol_c *var_init_decl) {
+      if (current_varqualifier != constant_vq) return false;
+      return is_static_const_var(var_init_decl);
+    }
+
+    /* Declare (constdecl_vf) or define (constdef_vf) the const C object of a CONSTANT variable,
+     * declared in the POU, configuration or resource 'domain'.
+     */
+    void print_const(symbol_c *domain, symbol_c *var_name, varformat_t varformat) {
+      varformat_t old_varformat = wanted_varformat;
+      wanted_varformat = varformat; /* the array and structure initial values are printed with constdef_vf */
+      s4o.print(s4o.indent_spaces);
+      s4o.print((varformat == constdef_vf)? DEFINE_CONST : DECLARE_CONST);
+      s4o.print("(");
+      this->current_var_type_symbol->accept(*this);
+      s4o.print(",");
+      domain->accept(*this);
+      s4o.print(",");
+      var_name->accept(*this);
+      if (varformat == constdef_vf) {
+        s4o.print(",");
+        this->current_var_init_symbol->accept(*this);
+      }
+      s4o.print(")\n");
+      wanted_varformat = old_varformat;
+    }
+
     /* Actually produce the output where variables are declared... */
     /* Note that located variables and EN/ENO are the exception, they
      * being declared in the located_var_decl_c,
@@ -986,6 +1337,9 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
             print_variable_prefix();
           }
           else if (wanted_varformat == localinit_vf) {
+            /* CONSTANT variables of functions are initialised only once, and may be placed in read only memory */
+            if (current_var_static_const)
+              s4o.print("static const ");
             this->current_var_type_symbol->accept(*this);
             s4o.print(" ");
             print_variable_prefix();
@@ -1018,7 +1372,7 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
               s4o.print("else {\n");
               s4o.indent_right();
               s4o.print(s4o.indent_spaces);
-              s4o.print("static const ");
+              s4o.print(is_c_constant_type(this->current_var_type_symbol)? "static const " : "const ");
               this->current_var_type_symbol->accept(*this);
               s4o.print(" temp = ");
               this->current_var_init_symbol->accept(*this);
@@ -1050,6 +1404,11 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
         }
       }
 
+      if ((wanted_varformat == constdecl_vf) || (wanted_varformat == constdef_vf)) {
+        for(int i = 0; i < list->n; i++)
+          print_const(globalnamespace, list->elements[i], wanted_varformat);
+      }
+
       if (wanted_varformat == finterface_vf) {
         for(int i = 0; i < list->n; i++) {
           finterface_var_count++;
@@ -1130,6 +1489,7 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
       current_varqualifier = none_vq;
       current_var_type_symbol = NULL;
       current_var_init_symbol = NULL;
+      current_var_static_const = false;
       globalnamespace         = NULL;
       nv = NULL;
       resource_name = res_name;
@@ -1137,9 +1497,27 @@ class generate_c_vardecl_c: protected generate_c_base_and_typeid_c {
 
     ~generate_c_vardecl_c(void) {}
 
+    /* returns true if a CONSTANT variable of this datatype may be declared as a static const C object (see
+     * is_c_constant_type()). Used by analyse_variable_c::first_nonfb_is_static_const() and generate_var_list_c,
+     * so all of them agree on which variables are not stored in the POU's data structure.
+     */
+    static bool is_static_const_type(symbol_c *type_symbol) {return is_c_constant_type(type_symbol);}
+
+    /* Idem, for the variables declared in a var_init_decl (of a VAR CONSTANT ... END_VAR) */
+    static bool is_static_const_var(symbol_c *var_init_decl) {
+      symbol_c *type_symbol = NULL;
+      if      (var_init_decl->is<var1_init_decl_c>())                      type_symbol = var_init_decl->as<var1_init_decl_c>()->spec_init;
+      else if (var_init_decl->is<array_var_init_decl_c>())                 type_symbol = var_init_decl->as<array_var_init_decl_c>()->array_spec_init;
+      else if (var_init_decl->is<structured_var_init_decl_c>())            type_symbol = var_init_decl->as<structured_var_init_decl_c>()->initialized_structure;
+      else if (var_init_decl->is<single_byte_string_var_declaration_c>())  type_symbol = var_init_decl->as<single_byte_string_var_declaration_c>()->single_byte_string_spec;
+      else if (var_init_decl->is<double_byte_string_var_declaration_c>())  type_symbol = var_init_decl->as<double_byte_string_var_declaration_c>()->double_byte_string_spec;
+      else return false; /* FB instances */
+      return is_static_const_type(type_symbol);
+    }
+
     void print(symbol_c *symbol, symbol_c *scope = NULL, const char *variable_prefix = NULL) {
       this->set_variable_prefix(variable_prefix);
-      if (globalinit_vf == wanted_varformat)
+      if ((globalinit_vf == wanted_varformat) || (constdecl_vf == wanted_varformat) || (constdef_vf == wanted_varformat))
         globalnamespace = scope;
 
       finterface_var_count = 0;
@@ -1598,7 +1976,7 @@ void *visit(array_var_declaration_c *symbol) {
 }
 
 void *visit(array_initial_elements_list_c *symbol) {
-  if (wanted_varformat == localinit_vf || wanted_varformat == constructorinit_vf) {
+  if (wanted_varformat == localinit_vf || wanted_varformat == constructorinit_vf || wanted_varformat == constdef_vf) {
     generate_c_array_initialization_c *array_initialization = new generate_c_array_initialization_c(&s4o);
     array_initialization->init_array_size(this->current_var_type_symbol);
     array_initialization->init_array_values(this->current_var_init_symbol);
@@ -1640,7 +2018,7 @@ void *visit(structured_var_declaration_c *symbol) {
 }
 
 void *visit(structure_element_initialization_list_c *symbol) {
-  if (wanted_varformat == localinit_vf || wanted_varformat == constructorinit_vf) {
+  if (wanted_varformat == localinit_vf || wanted_varformat == constructorinit_vf || wanted_varformat == constdef_vf) {
     generate_c_structure_initialization_c *structure_initialization = new generate_c_structure_initialization_c(&s4o);
     structure_initialization->init_structure_default(this->current_var_type_symbol);
     structure_initialization->init_structure_values(this->current_var_init_symbol);
@@ -1663,7 +2041,29 @@ void *visit(var_declarations_c *symbol) {
     current_vartype = private_vt;
     if (symbol->option != NULL)
       symbol->option->accept(*this);
-    symbol->var_init_decl_list->accept(*this);
+    /* The CONSTANT variables of FBs and PROGRAMs (see is_static_const_var()) are not stored
+     * in the FB's data structure, but declared separately (see constdecl_vf and constdef_vf).
+     */
+    if ((wanted_varformat == local_vf) || (wanted_varformat == constructorinit_vf) || (wanted_varformat == constdecl_vf) || (wanted_varformat == constdef_vf)) {
+      list_c *list = dynamic_cast<list_c *>(symbol->var_init_decl_list);
+      if (NULL == list) ERROR;
+      for (int i = 0; i < list->n; i++) {
+        if (is_static_const_decl(list->elements[i]) == ((wanted_varformat == constdecl_vf) || (wanted_varformat == constdef_vf)))
+          list->elements[i]->accept(*this);
+      }
+    }
+    /* ... while those of FUNCTIONs are declared as 'static const' locals. */
+    else if (wanted_varformat == localinit_vf) {
+      list_c *list = dynamic_cast<list_c *>(symbol->var_init_decl_list);
+      if (NULL == list) ERROR;
+      for (int i = 0; i < list->n; i++) {
+        current_var_static_const = is_static_const_decl(list->elements[i]);
+        list->elements[i]->accept(*this);
+        current_var_static_const = false;
+      }
+    }
+    else
+      symbol->var_init_decl_list->accept(*this);
     current_vartype = none_vt;
     current_varqualifier = none_vq;
   }
@@ -1868,6 +2268,15 @@ void *visit(external_declaration_c *symbol) {
   update_type_init(symbol->specification);
   this->current_var_init_symbol = NULL; // We do NOt want to initialize external variables.
 
+  /* The POU accesses the VAR_GLOBAL CONSTANT variables stored in const C objects directly
+   * (see global_const_analysis_c), so it needs no pointer to them.
+   */
+  if (   (NULL != global_const_analysis_c::get_domain(symbol->global_var_name))
+      && ((wanted_varformat == local_vf) || (wanted_varformat == localinit_vf) || (wanted_varformat == constructorinit_vf))) {
+    void_type_init();
+    return NULL;
+  }
+
   if(!get_datatype_info_c::is_type_valid(this->current_var_type_symbol)) ERROR;
   bool is_fb = get_datatype_info_c::is_function_block(this->current_var_type_symbol);
 
@@ -2099,6 +2508,11 @@ void *visit(global_var_list_c *symbol) {
     case local_vf:
     case localinit_vf:
       for(int i = 0; i < list->n; i++) {
+        /* VAR_GLOBAL CONSTANT variables stored in const C objects (see global_const_analysis_c) */
+        if (NULL != global_const_analysis_c::get_domain(list->elements[i])) {
+          print_const(this->resource_name, list->elements[i], constdef_vf);
+          continue;
+        }
         s4o.print(s4o.indent_spaces);
         if (is_fb)
           s4o.print(DECLARE_GLOBAL_FB);
@@ -2118,6 +2532,8 @@ void *visit(global_var_list_c *symbol) {
     case constructorinit_vf:
       if (this->current_var_init_symbol != NULL || is_fb) {
         for(int i = 0; i < list->n; i++) {
+          if (NULL != global_const_analysis_c::get_domain(list->elements[i]))
+            continue; /* initialised in its definition */
           s4o.print(nv->get());
 
           if (is_fb)
@@ -2166,6 +2582,10 @@ void *visit(global_var_list_c *symbol) {
 
     case globalprototype_vf:
       for(int i = 0; i < list->n; i++) {
+        if (NULL != global_const_analysis_c::get_domain(list->elements[i])) {
+          print_const(this->resource_name, list->elements[i], constdecl_vf);
+          continue;
+        }
         s4o.print(s4o.indent_spaces);
         s4o.print(DECLARE_GLOBAL_PROTOTYPE);
         s4o.print("(");
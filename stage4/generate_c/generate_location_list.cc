@@ -50,34 +50,34 @@ class generate_location_list_c: public iterator_visitor_c {
       
       switch (location->value[2]) {
         case 'X': // bit
-          if (typeid(*current_var_type_symbol) == typeid(bool_type_name_c)) return true;
+          if (current_var_type_symbol->is<bool_type_name_c>()) return true;
           break;
         case 'B': // Byte, 8 bits
-          if (typeid(*current_var_type_symbol) == typeid(sint_type_name_c)) return true;
-          if (typeid(*current_var_type_symbol) == typeid(usint_type_name_c)) return true;
-          if (typeid(*current_var_type_symbol) == typeid(string_type_name_c)) return true;
-          if (typeid(*current_var_type_symbol) == typeid(byte_type_name_c)) return true;
+          if (current_var_type_symbol->is<sint_type_name_c>()) return true;
+          if (current_var_type_symbol->is<usint_type_name_c>()) return true;
+          if (current_var_type_symbol->is<string_type_name_c>()) return true;
+          if (current_var_type_symbol->is<byte_type_name_c>()) return true;
           break;
         case 'W': // Word, 16 bits
-          if (typeid(*current_var_type_symbol) == typeid(int_type_name_c)) return true;
-          if (typeid(*current_var_type_symbol) == typeid(uint_type_name_c)) return true;
-          if (typeid(*current_var_type_symbol) == typeid(word_type_name_c)) return true;
-          if (typeid(*current_var_type_symbol) == typeid(wstring_type_name_c)) return true;
+          if (current_var_type_symbol->is<int_type_name_c>()) return true;
+          if (current_var_type_symbol->is<uint_type_name_c>()) return true;
+          if (current_var_type_symbol->is<word_type_name_c>()) return true;
+          if (current_var_type_symbol->is<wstring_type_name_c>()) return true;
           break;
         case 'D': // Double, 32 bits
-          if (typeid(*current_var_type_symbol) == typeid(dint_type_name_c)) return true;
-          if (typeid(*current_var_type_symbol) == typeid(udint_type_name_c)) return true;
-          if (typeid(*current_var_type_symbol) == typeid(real_type_name_c)) return true;
-          if (typeid(*current_var_type_symbol) == typeid(dword_type_name_c)) return true;
+          if (current_var_type_symbol->is<dint_type_name_c>()) return true;
+          if (current_var_type_symbol->is<udint_type_name_c>()) return true;
+          if (current_var_type_symbol->is<real_type_name_c>()) return true;
+          if (current_var_type_symbol->is<dword_type_name_c>()) return true;
           break;
         case 'L': // Long, 64 bits
-          if (typeid(*current_var_type_symbol) == typeid(lint_type_name_c)) return true;
-          if (typeid(*current_var_type_symbol) == typeid(ulint_type_name_c)) return true;
-          if (typeid(*current_var_type_symbol) == typeid(lreal_type_name_c)) return true;
-          if (typeid(*current_var_type_symbol) == typeid(lword_type_name_c)) return true;
+          if (current_var_type_symbol->is<lint_type_name_c>()) return true;
+          if (current_var_type_symbol->is<ulint_type_name_c>()) return true;
+          if (current_var_type_symbol->is<lreal_type_name_c>()) return true;
+          if (current_var_type_symbol->is<lword_type_name_c>()) return true;
           break;
         default:
-          if (typeid(*current_var_type_symbol) == typeid(bool_type_name_c)) return true;
+          if (current_var_type_symbol->is<bool_type_name_c>()) return true;
       }
       return false;
     }
@@ -0,0 +1,192 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+
+/* Generate the table with the execution time counters of the POU instances of a RESOURCE
+ * (used by the '-O t' option, see lib/C/iec_profile.h).
+ *
+ * The table lists each PROGRAM instance of the RESOURCE, followed by all the FB instances
+ * it contains (recursively), e.g.:
+ *   __IEC_PROFILE_ENTRY_t RES1_profile_table__[] = {
+ *     {"RES1.INSTANCE0", &RES1__INSTANCE0.__profile},
+ *     {"RES1.INSTANCE0.TON1", &RES1__INSTANCE0.TON1.__profile},
+ *     {NULL, NULL}
+ *   };
+ *
+ * Only the POUs whose C code is generated by iec2c have the __profile counters
+ * (the FBs of the standard library, whose code is in lib/C, do not). These POUs
+ * must first be registered by calling collect_profiled_pous().
+ *
+ * NOTE: FB instances declared as global variables of the RESOURCE or CONFIGURATION,
+ *       as well as arrays of FB instances, are not listed in the table.
+ */
+
+
+/* Get the list of FB instances (instance name, FB type name) declared inside a POU.
+ * VAR_EXTERNAL and VAR_IN_OUT variables are only references to FB instances declared elsewhere,
+ * so they are skipped.
+ */
+class search_fb_instances_c: public iterator_visitor_c {
+  public:
+    typedef std::vector<std::pair<symbol_c *, symbol_c *> > instances_t;
+
+  private:
+    instances_t instances;
+
+  public:
+    instances_t &get(symbol_c *var_declarations) {
+      instances.clear();
+      if (NULL != var_declarations) var_declarations->accept(*this);
+      return instances;
+    }
+
+    void *visit(input_output_declarations_c *symbol) {return NULL;}
+    void *visit(external_var_declarations_c *symbol) {return NULL;}
+
+    /* fb_name_list ':' function_block_type_name ASSIGN structure_initialization */
+    void *visit(fb_name_decl_c *symbol) {
+      fb_spec_init_c *fb_spec_init = symbol->fb_spec_init->as<fb_spec_init_c>();
+      list_c         *fb_name_list = dynamic_cast<list_c *>(symbol->fb_name_list);
+      if ((NULL == fb_spec_init) || (NULL == fb_name_list)) ERROR;
+      for (int i = 0; i < fb_name_list->n; i++)
+        instances.push_back(std::make_pair(fb_name_list->elements[i], fb_spec_init->function_block_type_name));
+      return NULL;
+    }
+};
+
+
+
+class generate_profile_table_c: public iterator_visitor_c {
+
+  protected:
+    stage4out_c &s4o;
+
+  private:
+    symbol_c *resource_name;
+    generate_c_base_c *generate_c_base;
+    /* the names of the POU instance currently being listed, and of the POU instances containing it */
+    std::vector<symbol_c *> instance_path;
+
+    static std::set<std::string> profiled_pous;
+
+    static std::string pou_key(symbol_c *pou_name) {
+      std::string key(get_datatype_info_c::get_id_str(pou_name));
+      for (size_t i = 0; i < key.size(); i++) key[i] = toupper((unsigned char)key[i]);
+      return key;
+    }
+
+  public:
+    generate_profile_table_c(stage4out_c *s4o_ptr, symbol_c *resource_name): s4o(*s4o_ptr) {
+      this->resource_name = resource_name;
+      generate_c_base = new generate_c_base_c(s4o_ptr);
+    }
+    ~generate_profile_table_c(void) {
+      delete generate_c_base;
+    }
+
+    /* Register all the FBs and PROGRAMs for which C code will be generated
+     * (i.e. those not inside a {disable code generation} ... {enable code generation} block).
+     */
+    static void collect_profiled_pous(library_c *library) {
+      bool code_generation = true;
+      for (int i = 0; i < library->n; i++) {
+        symbol_c *element = library->elements[i];
+        if      (element->is< enable_code_generation_pragma_c>()) code_generation = true;
+        else if (element->is<disable_code_generation_pragma_c>()) code_generation = false;
+        else if (!code_generation) continue;
+        else if (function_block_declaration_c *fb   = element->as<function_block_declaration_c>()) profiled_pous.insert(pou_key(fb->fblock_name));
+        else if (program_declaration_c        *prog = element->as<program_declaration_c>()) profiled_pous.insert(pou_key(prog->program_type_name));
+      }
+    }
+
+    static bool is_profiled(symbol_c *pou_name) {
+      return (profiled_pous.find(pou_key(pou_name)) != profiled_pous.end());
+    }
+
+  private:
+    void print_entry(void) {
+      s4o.print(s4o.indent_spaces + "{\"");
+      resource_name->accept(*generate_c_base);
+      for (size_t i = 0; i < instance_path.size(); i++) {
+        s4o.print(".");
+        instance_path[i]->accept(*generate_c_base);
+      }
+      s4o.print("\", &");
+      resource_name->accept(*generate_c_base);
+      s4o.print("__");
+      instance_path[0]->accept(*generate_c_base);
+      for (size_t i = 1; i < instance_path.size(); i++) {
+        s4o.print(".");
+        instance_path[i]->accept(*generate_c_base);
+      }
+      s4o.print(".__profile},\n");
+    }
+
+    void print_fb_instances(symbol_c *var_declarations) {
+      search_fb_instances_c search_fb_instances;
+      search_fb_instances_c::instances_t &instances = search_fb_instances.get(var_declarations);
+
+      for (size_t i = 0; i < instances.size(); i++) {
+        if (!is_profiled(instances[i].second)) continue;
+        function_block_type_symtable_t::iterator iter = function_block_type_symtable.find(instances[i].second);
+        if (iter == function_block_type_symtable.end()) ERROR; // The FB type MUST be in the symtable.
+        instance_path.push_back(instances[i].first);
+        print_entry();
+        print_fb_instances(iter->second->var_declarations);
+        instance_path.pop_back();
+      }
+    }
+
+  public:
+/********************************/
+/* B 1.7 Configuration elements */
+/********************************/
+    void *visit(program_configuration_list_c *symbol) {
+      s4o.print("__IEC_PROFILE_ENTRY_t ");
+      resource_name->accept(*generate_c_base);
+      s4o.print("_profile_table__[] = {\n");
+      s4o.indent_right();
+      for (int i = 0; i < symbol->n; i++)
+        symbol->elements[i]->accept(*this);
+      s4o.print(s4o.indent_spaces + "{NULL, NULL}\n");
+      s4o.indent_left();
+      s4o.print("};\n\n");
+      return NULL;
+    }
+
+/*  PROGRAM [RETAIN | NON_RETAIN] program_name [WITH task_name] ':' program_type_name ['(' prog_conf_elements ')'] */
+//SYM_REF6(program_configuration_c, retain_option, program_name, task_name, program_type_name, prog_conf_elements, unused)
+    void *visit(program_configuration_c *symbol) {
+      if (!is_profiled(symbol->program_type_name)) return NULL;
+      program_type_symtable_t::iterator iter = program_type_symtable.find(symbol->program_type_name);
+      if (iter == program_type_symtable.end()) ERROR; // The PROGRAM type MUST be in the symtable.
+      instance_path.push_back(symbol->program_name);
+      print_entry();
+      print_fb_instances(iter->second->var_declarations);
+      instance_path.pop_back();
+      return NULL;
+    }
+};
+
+
+std::set<std::string> generate_profile_table_c::profiled_pous;
@@ -647,6 +647,10 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
       /* Start off by setting the current_var_type_symbol and
        * current_var_init_symbol private variables...
        */
+      /* The VAR_GLOBAL CONSTANT variables stored in const C objects have no pointer in the POU's data structure */
+      if (NULL != global_const_analysis_c::get_domain(symbol->global_var_name))
+        return NULL;
+
       update_var_type_symbol(symbol->specification);
       
       this->current_var_class_category = external_vcc;
@@ -690,8 +694,12 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
       return NULL;
     }
     
+    /* The VAR_GLOBAL CONSTANT variables stored in const C objects (see global_const_analysis_c) cannot be debugged */
     void *visit(global_var_list_c *symbol) {
-      declare_variables(symbol);
+      for (int i = 0; i < symbol->n; i++) {
+        if (NULL == global_const_analysis_c::get_domain(symbol->elements[i]))
+          declare_variable(symbol->elements[i]);
+      }
       return NULL;
     }
     
@@ -724,6 +732,24 @@ class generate_var_list_c: protected generate_c_base_and_typeid_c {
       return NULL;
     }
     
+    /* VAR [CONSTANT] var_init_decl_list END_VAR */
+    /* The CONSTANT variables (see generate_c_vardecl_c::is_static_const_var()) are stored in static const
+     * C objects, and not in the data structure of the POU, so they cannot be debugged.
+     * (see generate_c_vardecl_c::constdecl_vf)
+     */
+    void *visit(var_declarations_c *symbol) {
+      TRACE("var_declarations_c");
+      if ((NULL == symbol->option) || !symbol->option->is<constant_option_c>())
+        return symbol->var_init_decl_list->accept(*this);
+      list_c *list = dynamic_cast<list_c *>(symbol->var_init_decl_list);
+      if (NULL == list) ERROR;
+      for (int i = 0; i < list->n; i++) {
+        if (!generate_c_vardecl_c::is_static_const_var(list->elements[i]))
+          list->elements[i]->accept(*this);
+      }
+      return NULL;
+    }
+
     void *visit(var1_init_decl_c *symbol) {
       TRACE("var1_init_decl_c");
     
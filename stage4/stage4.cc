@@ -43,7 +43,11 @@
 #include <string>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <ctype.h>
 
 #include "stage4.hh"
 #include "../main.hh" // required for ERROR() and ERROR_MSG() macros.
@@ -73,14 +77,20 @@ void stage4err(const char *stage4_generator_id, symbol_c *symbol1, symbol_c *sym
 
 
 
-stage4out_c::stage4out_c(std::string indent_level):
-	m_file(NULL) {
+stage4out_c::stage4out_c(std::string indent_level) {
   out = &std::cout;
+  buffer.reserve(2*flush_threshold);
   this->indent_level = indent_level;
   this->indent_spaces = "";
   allow_output = true;
 }
 
+/* NOTE: The output is not written directly to the file, but is instead kept in memory,
+ *       and only written to the file when this object is destroyed, and only if the 
+ *       newly generated contents differ from the contents already in the file.
+ *       This keeps the modification time of unchanged files, so that build tools
+ *       (make, ninja, ...) do not needlessly re-compile the generated C code.
+ */
 stage4out_c::stage4out_c(const char *dir, const char *radix, const char *extension, std::string indent_level) {	
   std::string filename(radix);
   filename += ".";
@@ -91,30 +101,52 @@ stage4out_c::stage4out_c(const char *dir, const char *radix, const char *extensi
     filepath += "/";
   }
   filepath += filename;
-  std::fstream *file = new std::fstream(filepath.c_str(), std::fstream::out);
-  if(file->fail()){
+  /* make sure we will later be able to write to the file, but without changing its contents nor modification time */
+  std::fstream file(filepath.c_str(), std::fstream::out | std::fstream::app);
+  if(file.fail()){
     std::cerr << "Cannot open " << filename << " for write access \n";
     exit(EXIT_FAILURE);
   }else{
     std::cout << filename << "\n";
   }
-  out = file;
-  m_file = file;
+  file.close();
+  out = NULL;
+  m_filepath = filepath;
+  buffer.reserve(2*flush_threshold);
   this->indent_level = indent_level;
   this->indent_spaces = "";
   allow_output = true;
 }
 
 stage4out_c::~stage4out_c(void) {
-  if(m_file)
-  {
-    m_file->close();
-    delete m_file;
+  if (out == NULL) write_if_changed(m_filepath, buffer);
+  else             flush();
+}
+
+void stage4out_c::write_if_changed(const std::string &filepath, const std::string &contents) {
+  std::ifstream old_file(filepath.c_str(), std::ifstream::in | std::ifstream::binary);
+  if (old_file.good()) {
+    std::ostringstream old_contents;
+    old_contents << old_file.rdbuf();
+    old_file.close();
+    if (old_contents.str() == contents)
+      return; /* nothing changed => leave the file untouched */
+  }
+  std::ofstream new_file(filepath.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+  new_file.write(contents.data(), contents.size());
+  new_file.close();
+  if (new_file.fail()) {
+    std::cerr << "Error writing to " << filepath << "\n";
+    exit(EXIT_FAILURE);
   }
 }
 
+/* NOTE: when writing to a file, the data is only written out when the file is closed (see the destructor) */
 void stage4out_c::flush(void) {
+  if (out == NULL) return;
+  out->write(buffer.data(), buffer.size());
   out->flush();
+  buffer.clear();
 }
 
 void stage4out_c::enable_output(void) {
@@ -136,86 +168,92 @@ void stage4out_c::indent_left(void) {
     indent_spaces.erase();
 }
 
-void *stage4out_c::print(           std::string value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(           const char *value) {if (!allow_output) return NULL; *out << value; return NULL;}
+
+/* Append str to the buffer, converted to upper case, and with any '.' replaced by dot.
+ * The conversion is done in place, directly in the buffer, a whole block at a time.
+ */
+void stage4out_c::append_upper(const char *str, size_t len, char dot) {
+  size_t start = buffer.size();
+  buffer.append(str, len);
+  for (std::string::iterator p = buffer.begin() + start; p != buffer.end(); ++p)
+    if (*p == '.') *p = dot;
+    else           *p = toupper((unsigned char)*p);
+}
+
+
+#define PRINT_FORMATTED(format, value) {                     \
+  if (!allow_output) return NULL;                             \
+  char tmp[32];                                               \
+  int len = snprintf(tmp, sizeof(tmp), format, value);        \
+  append(tmp, len);                                           \
+  if ((out != NULL) && (buffer.size() > flush_threshold)) flush(); \
+  return NULL;                                                \
+}
+
+void *stage4out_c::print(    const std::string &value) {if (!allow_output) return NULL; append(value.data(), value.size()); if ((out != NULL) && (buffer.size() > flush_threshold)) flush(); return NULL;}
+void *stage4out_c::print(           const char *value) {if (!allow_output) return NULL; append(value);                     if ((out != NULL) && (buffer.size() > flush_threshold)) flush(); return NULL;}
 //void *stage4out_c::print(               int64_t value) {if (!allow_output) return NULL; *out << value; return NULL;}
 //void *stage4out_c::print(              uint64_t value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(              real64_t value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(                   int value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(              long int value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(         long long int value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(unsigned           int value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(unsigned      long int value) {if (!allow_output) return NULL; *out << value; return NULL;}
-void *stage4out_c::print(unsigned long long int value) {if (!allow_output) return NULL; *out << value; return NULL;}
+/* Real values are rarely printed, so we simply keep using the iostream library, which 
+ * guarantees the generated text remains exactly the same as it has always been.
+ */
+void *stage4out_c::print(              real64_t value) {if (!allow_output) return NULL; std::ostringstream tmp; tmp << value; return print(tmp.str());}
+void *stage4out_c::print(                   int value) PRINT_FORMATTED("%d",   value)
+void *stage4out_c::print(              long int value) PRINT_FORMATTED("%ld",  value)
+void *stage4out_c::print(         long long int value) PRINT_FORMATTED("%lld", value)
+void *stage4out_c::print(unsigned           int value) PRINT_FORMATTED("%u",   value)
+void *stage4out_c::print(unsigned      long int value) PRINT_FORMATTED("%lu",  value)
+void *stage4out_c::print(unsigned long long int value) PRINT_FORMATTED("%llu", value)
 
 
 void *stage4out_c::print_long_integer(unsigned long l_integer, bool suffix) {
   if (!allow_output) return NULL;
-  *out << l_integer;
-  if (suffix) *out << "UL";
+  print(l_integer);
+  if (suffix) append("UL", 2);
   return NULL;
 }
 
 void *stage4out_c::print_long_long_integer(unsigned long long ll_integer, bool suffix) {
   if (!allow_output) return NULL;
-  *out << ll_integer;
-  if (suffix) *out << "ULL";
+  print(ll_integer);
+  if (suffix) append("ULL", 3);
   return NULL;
 }
 
 
 void *stage4out_c::printupper(const char *str) {
   if (!allow_output) return NULL;
-  for (int i = 0; str[i] != '\0'; i++)
-    *out << (unsigned char)toupper(str[i]);
+  append_upper(str, strlen(str));
   return NULL;
 }
 
 void *stage4out_c::printlocation(const char *str) {
   if (!allow_output) return NULL;
-  *out << "__";
-  for (int i = 0; str[i] != '\0'; i++)
-    if(str[i] == '.')
-      *out << '_';
-    else
-      *out << (unsigned char)toupper(str[i]);
+  append("__", 2);
+  append_upper(str, strlen(str), '_');
   return NULL;
 }
 
 void *stage4out_c::printlocation_comasep(const char *str) {
   if (!allow_output) return NULL;
-  *out << (unsigned char)toupper(str[0]);
-  *out << ',';
-  *out << (unsigned char)toupper(str[1]);
-  *out << ',';
-  for (int i = 2; str[i] != '\0'; i++)
-    if(str[i] == '.')
-      *out << ',';
-    else
-      *out << (unsigned char)toupper(str[i]);
+  append(toupper((unsigned char)str[0]));
+  append(',');
+  append(toupper((unsigned char)str[1]));
+  append(',');
+  append_upper(str + 2, strlen(str + 2), ',');
   return NULL;
 }
 
 
 
-void *stage4out_c::printupper(std::string str) {
+void *stage4out_c::printupper(const std::string &str) {
   if (!allow_output) return NULL;
-  /* The string standard class does not have a converter member function to upper case.
-   * We have to do it ourselves, a character at a time...
-   */
-#if 0
-  /* The C++ way of doint things... */
-  for (string::const_iterator p = str.begin(); p != str.end(); ++p)
-    *out << (unsigned char)toupper(*p);
-#else
-  /* Or more simply... */
-    printupper(str.c_str());
-#endif
+  append_upper(str.data(), str.size());
   return NULL;
 }
 
 
-void *stage4out_c::printlocation(std::string str) {
+void *stage4out_c::printlocation(const std::string &str) {
   if (!allow_output) return NULL;
   return printlocation(str.c_str());
 }
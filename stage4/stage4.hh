@@ -39,6 +39,7 @@
 #ifndef _STAGE4_HH
 #define _STAGE4_HH
 
+#include <string>
 #include "../absyntax/absyntax.hh"
 
 
@@ -63,7 +64,7 @@ class stage4out_c {
     void indent_right(void);
     void indent_left(void);
 
-    void *print(          std::string  value);
+    void *print(   const std::string  &value);
     void *print(           const char *value);
     //void *print(               int64_t value); // not required, since we have long long int, or similar
     //void *print(              uint64_t value); // not required, since we have long long int, or similar
@@ -80,16 +81,32 @@ class stage4out_c {
 
 
     void *printupper(const char *str);
-    void *printupper(std::string str);
+    void *printupper(const std::string &str);
 
     void *printlocation(const char *str);
-    void *printlocation(std::string str);
+    void *printlocation(const std::string &str);
 
     void *printlocation_comasep(const char *str);
 
   protected:
-    std::ostream *out;
-    std::fstream *m_file;
+    /* All output is appended to an in-memory byte buffer, and only handed over to the
+     * underlying stream/file in large blocks, thus avoiding the overhead of going through
+     * the iostream machinery for each (usually very small) fragment of generated code.
+     *   - when writing to stdout, the buffer is flushed whenever it grows beyond flush_threshold;
+     *   - when writing to a file, the whole file is kept in the buffer, and only written 
+     *     to disk (if changed) when this object is destroyed.
+     */
+    static const size_t flush_threshold = 64*1024;
+    std::string         buffer;
+    std::ostream       *out;        /* where to flush the buffer to (NULL when writing to a file) */
+    std::string         m_filepath; /* the output file */
+
+    inline void append(const char *str, size_t len) {buffer.append(str, len);}
+    inline void append(const char *str)             {buffer.append(str);}
+    inline void append(char c)                      {buffer.push_back(c);}
+    void        append_upper(const char *str, size_t len, char dot = '.');
+
+    static void write_if_changed(const std::string &filepath, const std::string &contents);
     
     /* A flag to tell whether to really print to the file, or to ignore any request to print to the file */
     /* This is used to implement the no_code_generation pragmas, that lets the user tell the compiler
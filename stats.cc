@@ -0,0 +1,278 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * Compiler self-profiling (the '--stats' command line option).
+ * See stats.hh for details.
+ */
+
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <time.h>
+#ifdef __unix__
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+
+#include "stats.hh"
+#include "absyntax/absyntax.hh"
+#include "absyntax/visitor.hh"
+#include "main.hh"
+
+
+
+typedef struct {
+  std::string name;
+  long long   calls;
+  double      wall_time; /* in seconds */
+  double      cpu_time;  /* in seconds */
+} stats_time_t;
+
+typedef std::map<std::string, long long> stats_counters_t;
+
+/* We keep the timers and the groups of counters in the order in which they were first used,
+ * so the printed statistics follow the order in which the compiler runs.
+ */
+static std::vector<stats_time_t>                                 timers;
+static std::vector<std::pair<std::string, stats_counters_t> >    counter_groups;
+
+bool        stats_c::enabled_  = false;
+const char *stats_c::filename_ = NULL;
+
+
+
+static double get_wall_time(void) {
+#ifdef __unix__
+  struct timespec ts;
+  if (clock_gettime(CLOCK_MONOTONIC, &ts) == 0)
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+  return (double)time(NULL);
+}
+
+static double get_cpu_time(void) {
+#ifdef __unix__
+  struct timespec ts;
+  if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) == 0)
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+  return (double)clock() / CLOCKS_PER_SEC;
+}
+
+/* returns -1 if not known */
+static long get_peak_rss_kb(void) {
+#ifdef __unix__
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) == 0)
+  #ifdef __APPLE__
+    return usage.ru_maxrss / 1024; /* MacOS returns bytes */
+  #else
+    return usage.ru_maxrss;        /* Linux returns kilobytes */
+  #endif
+#endif
+  return -1;
+}
+
+
+static stats_counters_t &get_group(const char *group) {
+  for (size_t i = 0; i < counter_groups.size(); i++)
+    if (counter_groups[i].first == group)
+      return counter_groups[i].second;
+  counter_groups.push_back(std::make_pair(std::string(group), stats_counters_t()));
+  return counter_groups.back().second;
+}
+
+
+
+void stats_c::enable(const char *filename) {
+  enabled_  = true;
+  filename_ = filename;
+}
+
+
+void stats_c::add_counter(const char *group, const char *name, long long delta) {
+  if (!enabled_) return;
+  get_group(group)[name] += delta;
+}
+
+
+void stats_c::set_counter(const char *group, const char *name, long long value) {
+  if (!enabled_) return;
+  get_group(group)[name] = value;
+}
+
+
+void stats_c::add_time(const char *name, double wall_time, double cpu_time) {
+  for (size_t i = 0; i < timers.size(); i++)
+    if (timers[i].name == name) {
+      timers[i].calls++;
+      timers[i].wall_time += wall_time;
+      timers[i].cpu_time  += cpu_time;
+      return;
+    }
+  stats_time_t new_timer;
+  new_timer.name      = name;
+  new_timer.calls     = 1;
+  new_timer.wall_time = wall_time;
+  new_timer.cpu_time  = cpu_time;
+  timers.push_back(new_timer);
+}
+
+
+
+/* Count the nodes of an AST, by class name.
+ * Nodes that are referenced from more than one place in the AST are only counted once.
+ */
+class count_ast_nodes_c: public visitor_c {
+  private:
+    const char          *group;
+    std::set<symbol_c *> visited;
+
+    void count(symbol_c *symbol) {
+      if (NULL == symbol) return;
+      if (!visited.insert(symbol).second) return; /* already counted */
+      stats_c::add_counter(group, symbol->absyntax_cname());
+      stats_c::add_counter(group, "total");
+      symbol->accept(*this);
+    }
+
+    void count_list(list_c *symbol) {
+      for (int i = 0; i < symbol->n; i++)
+        count(symbol->elements[i]);
+    }
+
+  public:
+    count_ast_nodes_c(const char *group_) {group = group_;}
+    void run(symbol_c *tree_root) {count(tree_root);}
+
+    #define SYM_LIST(class_name_c, ...)                                      void *visit(class_name_c *symbol) {count_list(symbol); return NULL;}
+    #define SYM_TOKEN(class_name_c, ...)                                     void *visit(class_name_c *symbol) {return NULL;}
+    #define SYM_REF0(class_name_c, ...)                                      void *visit(class_name_c *symbol) {return NULL;}
+    #define SYM_REF1(class_name_c, ref1, ...)                                void *visit(class_name_c *symbol) {count(symbol->ref1); return NULL;}
+    #define SYM_REF2(class_name_c, ref1, ref2, ...)                          void *visit(class_name_c *symbol) {count(symbol->ref1); count(symbol->ref2); return NULL;}
+    #define SYM_REF3(class_name_c, ref1, ref2, ref3, ...)                    void *visit(class_name_c *symbol) {count(symbol->ref1); count(symbol->ref2); count(symbol->ref3); return NULL;}
+    #define SYM_REF4(class_name_c, ref1, ref2, ref3, ref4, ...)              void *visit(class_name_c *symbol) {count(symbol->ref1); count(symbol->ref2); count(symbol->ref3); count(symbol->ref4); return NULL;}
+    #define SYM_REF5(class_name_c, ref1, ref2, ref3, ref4, ref5, ...)        void *visit(class_name_c *symbol) {count(symbol->ref1); count(symbol->ref2); count(symbol->ref3); count(symbol->ref4); count(symbol->ref5); return NULL;}
+    #define SYM_REF6(class_name_c, ref1, ref2, ref3, ref4, ref5, ref6, ...)  void *visit(class_name_c *symbol) {count(symbol->ref1); count(symbol->ref2); count(symbol->ref3); count(symbol->ref4); count(symbol->ref5); count(symbol->ref6); return NULL;}
+
+    #include "absyntax/absyntax.def"
+
+    #undef SYM_LIST
+    #undef SYM_TOKEN
+    #undef SYM_REF0
+    #undef SYM_REF1
+    #undef SYM_REF2
+    #undef SYM_REF3
+    #undef SYM_REF4
+    #undef SYM_REF5
+    #undef SYM_REF6
+};
+
+
+void stats_c::count_ast_nodes(const char *group, symbol_c *tree_root) {
+  if (!enabled_) return;
+  count_ast_nodes_c count_ast_nodes(group);
+  count_ast_nodes.run(tree_root);
+}
+
+
+
+/* print a string, escaped as required by JSON */
+static void print_json_str(FILE *file, const std::string &str) {
+  fputc('"', file);
+  for (size_t i = 0; i < str.size(); i++) {
+    unsigned char c = str[i];
+    if      ((c == '"') || (c == '\\')) fprintf(file, "\\%c", c);
+    else if (c < 0x20)                  fprintf(file, "\\u%04x", c);
+    else                                fputc(c, file);
+  }
+  fputc('"', file);
+}
+
+
+int stats_c::print(void) {
+  if (!enabled_) return 0;
+
+  FILE *file = stderr;
+  if ((NULL != filename_) && (NULL == (file = fopen(filename_, "w")))) {
+    perror("Error opening statistics output file");
+    return -1;
+  }
+
+  fprintf(file, "{\n");
+  fprintf(file, "  \"timers\": [");
+  for (size_t i = 0; i < timers.size(); i++) {
+    fprintf(file, "%s\n    {\"name\": ", (i == 0)? "" : ",");
+    print_json_str(file, timers[i].name);
+    fprintf(file, ", \"calls\": %lld, \"wall_ms\": %.3f, \"cpu_ms\": %.3f}",
+            timers[i].calls, timers[i].wall_time * 1e3, timers[i].cpu_time * 1e3);
+  }
+  fprintf(file, "\n  ],\n");
+
+  for (size_t g = 0; g < counter_groups.size(); g++) {
+    fprintf(file, "  ");
+    print_json_str(file, counter_groups[g].first);
+    fprintf(file, ": {");
+    stats_counters_t &counters = counter_groups[g].second;
+    for (stats_counters_t::iterator c = counters.begin(); c != counters.end(); ++c) {
+      fprintf(file, "%s\n    ", (c == counters.begin())? "" : ",");
+      print_json_str(file, c->first);
+      fprintf(file, ": %lld", c->second);
+    }
+    fprintf(file, "\n  },\n");
+  }
+
+  fprintf(file, "  \"memory\": {\"peak_rss_kb\": %ld}\n", get_peak_rss_kb());
+  fprintf(file, "}\n");
+
+  if (file != stderr) fclose(file);
+  return 0;
+}
+
+
+
+stats_timer_c::stats_timer_c(const char *name) {
+  this->name = name;
+  running    = stats_c::enabled();
+  if (!running) return;
+  wall_start = get_wall_time();
+  cpu_start  = get_cpu_time();
+}
+
+
+stats_timer_c::~stats_timer_c(void) {
+  if (!running) return;
+  stats_c::add_time(name, get_wall_time() - wall_start, get_cpu_time() - cpu_start);
+}
@@ -0,0 +1,99 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ */
+
+/*
+ * An IEC 61131-3 compiler.
+ *
+ * Based on the
+ * FINAL DRAFT - IEC 61131-3, 2nd Ed. (2001-12-10)
+ *
+ */
+
+
+/*
+ * Compiler self-profiling (the '--stats' command line option).
+ *
+ * Any part of the compiler may:
+ *   - time a section of code, by declaring a stats_timer_c object in the scope to be timed
+ *        e.g.:  { stats_timer_c timer("stage3/lvalue_check"); ... }
+ *     Timers with the same name are accumulated (and the number of calls is counted).
+ *     Names use '/' to express nesting (e.g. "stage3" and "stage3/lvalue_check").
+ *   - increment/set named counters, grouped by category
+ *        e.g.:  stats_c::add_counter("stage4", "dead_code_removed");
+ *
+ * When '--stats' has not been given on the command line, all of the above do nothing,
+ * and have negligible run time cost.
+ *
+ * The results are printed out (in JSON format) when the compiler finishes, together with
+ * the peak memory use (resident set size) of the compiler process.
+ */
+
+#ifndef _STATS_HH
+#define _STATS_HH
+
+#include <stdio.h>
+
+class symbol_c; // forward declaration
+
+
+class stats_c {
+  public:
+    /* Turn on statistics gathering. The statistics will be printed to file 'filename' (stderr if NULL) */
+    static void enable (const char *filename = NULL);
+    static bool enabled(void) {return enabled_;}
+
+    /* Counters, grouped by category (e.g. "ast_nodes", "symtables", ...) */
+    static void add_counter(const char *group, const char *name, long long delta = 1);
+    static void set_counter(const char *group, const char *name, long long value);
+
+    /* Count the nodes in the abstract syntax tree, by class (absyntax_cname()), adding them to counter group 'group' */
+    static void count_ast_nodes(const char *group, symbol_c *tree_root);
+
+    /* Print the statistics gathered so far (in JSON format). Returns -1 on error. */
+    static int  print(void);
+
+  private:
+    friend class stats_timer_c;
+    static void add_time(const char *name, double wall_time, double cpu_time);
+
+    static bool        enabled_;
+    static const char *filename_;
+};
+
+
+
+/* Measure the wall clock and CPU time spent between the creation and destruction of this object. */
+class stats_timer_c {
+  public:
+     stats_timer_c(const char *name);
+    ~stats_timer_c(void);
+
+  private:
+    const char *name;
+    bool        running;
+    double      wall_start;
+    double      cpu_start;
+};
+
+
+#endif /* _STATS_HH */
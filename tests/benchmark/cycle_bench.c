@@ -0,0 +1,187 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ *
+ *
+ * Scan cycle benchmark for the C code generated by iec2c.
+ *
+ * Unlike tests/main.c, the PLC cycles are not run from a timer. They are run
+ * back to back, in a tight loop, while __CURRENT_TIME is advanced by one tick
+ * (common_ticktime__) before each cycle, as if the PLC were running in real time.
+ * Every run is therefore deterministic, and the time measured is only the time
+ * spent executing the generated code.
+ *
+ * Instead of calling config_run__(), each resource's <resource>_run__() is called
+ * (in the same order as in config_run__()), so that the time spent in each
+ * resource may be measured separately.
+ * The list of resources must be given in RESOURCES.h, as a list of
+ *    __RESOURCE(<resource_name>)
+ * (the cyclebench script generates this file from the configuration's C code).
+ *
+ * usage: cycle_bench [-n <cycles>] [-w <warmup_cycles>] [-t <tick_ns>]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "iec_types_all.h"
+
+
+/*
+ * Functions and variables provided by generated C softPLC
+ **/
+extern unsigned long long common_ticktime__;
+void config_init__(void);
+
+#define __RESOURCE(name) void name##_run__(unsigned long tick);
+#include "RESOURCES.h"
+#undef __RESOURCE
+
+
+/*
+ *  Functions and variables to export to generated C softPLC
+ **/
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+#define __LOCATED_VAR(type, name, ...) type __##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+#define __LOCATED_VAR(type, name, ...) type* name = &__##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+
+
+
+static const char *resource_names[] = {
+  "total",
+#define __RESOURCE(name) #name,
+#include "RESOURCES.h"
+#undef __RESOURCE
+};
+
+#define RESOURCE_COUNT (sizeof(resource_names)/sizeof(resource_names[0]) - 1)
+
+
+static unsigned long long now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+
+static void advance_current_time(unsigned long long tick_ns) {
+  __CURRENT_TIME.tv_nsec += tick_ns % 1000000000ULL;
+  __CURRENT_TIME.tv_sec  += tick_ns / 1000000000ULL;
+  if (__CURRENT_TIME.tv_nsec >= 1000000000L) {
+    __CURRENT_TIME.tv_nsec -= 1000000000L;
+    __CURRENT_TIME.tv_sec  += 1;
+  }
+}
+
+
+/* Run one PLC cycle. The time spent in each resource is stored in latency[1..RESOURCE_COUNT],
+ * and the total time of the cycle in latency[0].
+ */
+static void run_cycle(unsigned long tick, unsigned long long *latency) {
+  unsigned long long start, t0, t1;
+  int r = 1;
+
+  start = t0 = now_ns();
+#define __RESOURCE(name) name##_run__(tick); t1 = now_ns(); latency[r++] = t1 - t0; t0 = t1;
+#include "RESOURCES.h"
+#undef __RESOURCE
+  latency[0] = t0 - start;
+}
+
+
+static int compare_ull(const void *a, const void *b) {
+  unsigned long long x = *(const unsigned long long *)a, y = *(const unsigned long long *)b;
+  return (x > y) - (x < y);
+}
+
+
+/* print min/p50/p99/max/mean of the 'count' samples (sorts the samples!) */
+static void print_distribution(const char *name, unsigned long long *samples, unsigned long count) {
+  unsigned long i;
+  double sum = 0;
+
+  qsort(samples, count, sizeof(samples[0]), compare_ull);
+  for (i = 0; i < count; i++) sum += samples[i];
+  printf("%-24s %12llu %12llu %12llu %12llu %12.1f\n", name,
+         samples[0], samples[count / 2], samples[(count * 99) / 100], samples[count - 1], sum / count);
+}
+
+
+static void usage(const char *cmd) {
+  fprintf(stderr, "usage: %s [-n <cycles>] [-w <warmup_cycles>] [-t <tick_ns>]\n", cmd);
+}
+
+
+int main(int argc, char **argv) {
+  unsigned long cycles = 100000, warmup = 1000, tick, i;
+  unsigned long long tick_ns = common_ticktime__;
+  unsigned long long latency[RESOURCE_COUNT + 1];
+  unsigned long long *samples;
+  unsigned int r;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:w:t:h")) != -1) {
+    switch (opt) {
+      case 'n': cycles  = strtoul (optarg, NULL, 0); break;
+      case 'w': warmup  = strtoul (optarg, NULL, 0); break;
+      case 't': tick_ns = strtoull(optarg, NULL, 0); break;
+      default : usage(argv[0]); return EXIT_FAILURE;
+    }
+  }
+  if (cycles == 0) {usage(argv[0]); return EXIT_FAILURE;}
+
+  /* samples[r * cycles + i] --> time spent in resource r (0 is the whole cycle) during cycle i */
+  samples = (unsigned long long *)malloc(sizeof(unsigned long long) * cycles * (RESOURCE_COUNT + 1));
+  if (samples == NULL) {fprintf(stderr, "Out of memory.\n"); return EXIT_FAILURE;}
+
+  memset(&__CURRENT_TIME, 0, sizeof(__CURRENT_TIME));
+  config_init__();
+
+  tick = 0;
+  for (i = 0; i < warmup; i++, tick++) {
+    advance_current_time(tick_ns);
+    run_cycle(tick, latency);
+  }
+
+  for (i = 0; i < cycles; i++, tick++) {
+    advance_current_time(tick_ns);
+    run_cycle(tick, latency);
+    for (r = 0; r <= RESOURCE_COUNT; r++)
+      samples[r * cycles + i] = latency[r];
+  }
+
+  printf("cycles: %lu (after %lu warm up cycles), simulated tick: %llu ns\n", cycles, warmup, tick_ns);
+  printf("%-24s %12s %12s %12s %12s %12s\n", "latency (ns)", "min", "p50", "p99", "max", "mean");
+  for (r = 0; r <= RESOURCE_COUNT; r++)
+    print_distribution(resource_names[r], &samples[r * cycles], cycles);
+
+  free(samples);
+  return EXIT_SUCCESS;
+}
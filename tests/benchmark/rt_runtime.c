@@ -0,0 +1,265 @@
+/*
+ *  matiec - a compiler for the programming languages defined in IEC 61131-3
+ *
+ *  Copyright (C) 2003-2014  Mario de Sousa (msousa@fe.up.pt)
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * This code is made available on the understanding that it will not be
+ * used in safety-critical situations without a full and competent review.
+ *
+ *
+ * Reference (Linux) real time runtime for the C code generated by iec2c.
+ *
+ * Unlike tests/main.c (which uses a CLOCK_REALTIME POSIX timer, notified
+ * through a new thread at every tick), the PLC cycles are run from a single
+ * dedicated thread, that sleeps until the absolute time at which the next cycle
+ * must start (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME)). The cycle start
+ * times therefore do not drift, and are not affected by changes to the wall clock.
+ *
+ * At the end of the run (after the requested number of cycles, or on SIGINT/SIGTERM)
+ * the following is printed:
+ *   - the wake up latency (time between the cycle's deadline and the moment the
+ *     thread actually started running it), with a histogram;
+ *   - the execution time of config_run__();
+ *   - the number of overruns (cycles that did not finish before the start of the
+ *     next cycle), and the number of cycles that were skipped because of them.
+ *
+ * usage: rt_runtime [-n <cycles>] [-p <period_ns>] [-c <cpu>] [-P <priority>] [-m]
+ *                   [-b <bucket_width_ns>] [-B <buckets>]
+ *    -n : number of cycles to run (default: 0, run until interrupted)
+ *    -p : cycle period (default: the common ticktime of the configuration)
+ *    -c : pin the PLC thread to this CPU
+ *    -P : run the PLC thread with SCHED_FIFO, at this priority (requires privileges)
+ *    -m : lock all the memory of the process (mlockall), to avoid page faults
+ *    -b, -B : width and number of the buckets of the wake up latency histogram
+ *             (default: 1000 ns, 100 buckets; the last bucket counts everything beyond)
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#include "iec_types_all.h"
+
+
+/*
+ * Functions and variables provided by generated C softPLC
+ **/
+extern unsigned long long common_ticktime__;
+void config_init__(void);
+void config_run__(unsigned long tick);
+
+
+/*
+ *  Functions and variables to export to generated C softPLC
+ **/
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+#define __LOCATED_VAR(type, name, ...) type __##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+#define __LOCATED_VAR(type, name, ...) type* name = &__##name;
+#include "LOCATED_VARIABLES.h"
+#undef __LOCATED_VAR
+
+
+
+#define NSEC_PER_SEC 1000000000ULL
+
+static unsigned long long cycles      = 0;
+static unsigned long long period_ns   = 0;
+static int                cpu         = -1;
+static int                priority    = 0;
+static int                lock_memory = 0;
+static unsigned long long bucket_ns   = 1000;
+static unsigned int       buckets     = 100;
+
+static volatile sig_atomic_t stop = 0;
+
+
+typedef struct {
+  unsigned long long count, min, max;
+  double             sum;
+} stat_t;
+
+static stat_t              latency_stat, exec_stat;
+static unsigned long long *histogram;
+static unsigned long long  overruns = 0, skipped = 0, ran = 0;
+
+
+static unsigned long long ts_to_ns(const struct timespec *ts) {
+  return (unsigned long long)ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+static void ns_to_ts(unsigned long long ns, struct timespec *ts) {
+  ts->tv_sec  = ns / NSEC_PER_SEC;
+  ts->tv_nsec = ns % NSEC_PER_SEC;
+}
+
+static unsigned long long now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts_to_ns(&ts);
+}
+
+static void stat_add(stat_t *stat, unsigned long long value) {
+  if ((stat->count == 0) || (value < stat->min)) stat->min = value;
+  if (value > stat->max) stat->max = value;
+  stat->sum += value;
+  stat->count++;
+}
+
+static void stat_print(const char *name, stat_t *stat) {
+  if (stat->count == 0) {printf("%-24s (no samples)\n", name); return;}
+  printf("%-24s min %10llu   mean %12.1f   max %10llu\n", name, stat->min, stat->sum / stat->count, stat->max);
+}
+
+
+
+static void *plc_thread(void *arg) {
+  unsigned long long next, wake, end;
+  struct timespec    deadline;
+  unsigned long      tick = 0;
+
+  config_init__();
+
+  next = now_ns();
+  while (!stop && ((cycles == 0) || (ran < cycles))) {
+    next += period_ns;
+    ns_to_ts(next, &deadline);
+    /* an interrupted sleep is resumed, unless we have been asked to stop */
+    while ((clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL) == EINTR) && !stop);
+    if (stop) break;
+
+    wake = now_ns();
+    stat_add(&latency_stat, wake - next);
+    histogram[((wake - next) / bucket_ns < buckets)? (wake - next) / bucket_ns : buckets - 1]++;
+
+    /* the IEC 61131-3 time is the (monotonic) time at which the cycle should have started */
+    ns_to_ts(next, &deadline);
+    __CURRENT_TIME.tv_sec  = deadline.tv_sec;
+    __CURRENT_TIME.tv_nsec = deadline.tv_nsec;
+    config_run__(tick++);
+    ran++;
+
+    end = now_ns();
+    stat_add(&exec_stat, end - wake);
+
+    /* Overrun: the cycle finished after the start of the next one.
+     * The cycles that should have started in the meantime are skipped (not run late,
+     * one after the other), so the following cycles keep to the original schedule.
+     */
+    if (end > next + period_ns) {
+      overruns++;
+      while (end > next + period_ns) {
+        next += period_ns;
+        skipped++;
+        tick++;
+      }
+    }
+  }
+  return NULL;
+}
+
+
+static void catch_signal(int sig) {
+  stop = 1;
+}
+
+
+static void usage(const char *cmd) {
+  fprintf(stderr, "usage: %s [-n <cycles>] [-p <period_ns>] [-c <cpu>] [-P <priority>] [-m] [-b <bucket_width_ns>] [-B <buckets>]\n", cmd);
+}
+
+
+int main(int argc, char **argv) {
+  pthread_attr_t     attr;
+  pthread_t          thread;
+  struct sched_param param;
+  struct sigaction   action;
+  unsigned int       b;
+  int                opt, res;
+
+  period_ns = common_ticktime__;
+  while ((opt = getopt(argc, argv, "n:p:c:P:mb:B:h")) != -1) {
+    switch (opt) {
+      case 'n': cycles      = strtoull(optarg, NULL, 0); break;
+      case 'p': period_ns   = strtoull(optarg, NULL, 0); break;
+      case 'c': cpu         = atoi(optarg);              break;
+      case 'P': priority    = atoi(optarg);              break;
+      case 'm': lock_memory = 1;                         break;
+      case 'b': bucket_ns   = strtoull(optarg, NULL, 0); break;
+      case 'B': buckets     = strtoul (optarg, NULL, 0); break;
+      default : usage(argv[0]); return EXIT_FAILURE;
+    }
+  }
+  if ((period_ns == 0) || (bucket_ns == 0) || (buckets == 0)) {usage(argv[0]); return EXIT_FAILURE;}
+
+  histogram = (unsigned long long *)calloc(buckets, sizeof(unsigned long long));
+  if (histogram == NULL) {fprintf(stderr, "Out of memory.\n"); return EXIT_FAILURE;}
+
+  if (lock_memory && (mlockall(MCL_CURRENT | MCL_FUTURE) != 0))
+    perror("mlockall (continuing without locked memory)");
+
+  /* no SA_RESTART, so the PLC thread's sleep is interrupted */
+  memset(&action, 0, sizeof(action));
+  action.sa_handler = catch_signal;
+  sigemptyset(&action.sa_mask);
+  sigaction(SIGINT,  &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+
+  pthread_attr_init(&attr);
+  if (cpu >= 0) {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    pthread_attr_setaffinity_np(&attr, sizeof(cpuset), &cpuset);
+  }
+  if (priority > 0) {
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    param.sched_priority = priority;
+    pthread_attr_setschedparam(&attr, &param);
+  }
+  if ((res = pthread_create(&thread, &attr, plc_thread, NULL)) != 0) {
+    fprintf(stderr, "Could not create the PLC thread: %s\n", strerror(res));
+    return EXIT_FAILURE;
+  }
+  pthread_attr_destroy(&attr);
+  pthread_join(thread, NULL);
+
+  printf("cycles: %llu, period: %llu ns, overruns: %llu, skipped cycles: %llu\n", ran, period_ns, overruns, skipped);
+  stat_print("wake up latency (ns)", &latency_stat);
+  stat_print("execution time (ns)",  &exec_stat);
+  printf("wake up latency histogram:\n");
+  for (b = 0; b < buckets; b++) {
+    if (histogram[b] == 0) continue;
+    if (b == buckets - 1) printf("  >= %10llu ns : %llu\n", b * bucket_ns, histogram[b]);
+    else                  printf("  <  %10llu ns : %llu\n", (b + 1) * bucket_ns, histogram[b]);
+  }
+
+  free(histogram);
+  return EXIT_SUCCESS;
+}
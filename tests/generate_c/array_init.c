@@ -0,0 +1,40 @@
+/* Checks the C code generated for array_init.st: the initial values of large arrays
+ * (see init_array_runs() in generate_c_vardecl.cc).
+ */
+
+#include <stdio.h>
+#include "POUS.h"
+#include "POUS.c"
+
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+static int errors = 0;
+
+#define CHECK(cond)\
+  if (!(cond)) {printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); errors++;}
+
+int main(void) {
+  ARRAY_FB fb;
+  int i, j;
+
+  memset(&fb, 0xFF, sizeof(fb));
+  ARRAY_FB_init__(&fb, 0);
+  for (i = 0; i < 3; i++)      CHECK(fb.RUNS.value.table[i] == 1);
+  for (i = 3; i < 503; i++)    CHECK(fb.RUNS.value.table[i] == 7);
+  for (i = 503; i < 508; i++)  CHECK(fb.RUNS.value.table[i] == i - 501);
+  for (i = 508; i < 1000; i++) CHECK(fb.RUNS.value.table[i] == 0);
+  for (i = 0; i < 100; i++)    CHECK(fb.REALS.value.table[i] == 1.5);
+  CHECK(fb.REALS.value.table[100] == 0.5);
+  for (i = 101; i < 300; i++)  CHECK(fb.REALS.value.table[i] == 0.0);
+  for (i = 0; i < 20; i++)
+    for (j = 0; j < 20; j++)   CHECK(fb.MATRIX.value.table[i][j] == ((i == 0)? 1 : 2));
+
+  /* the elements of a forced array are not changed by its initialisation */
+  fb.RUNS.value.table[10] = 42;
+  fb.RUNS.flags |= __IEC_FORCE_FLAG;
+  ARRAY_FB_init_image__(&fb, 0);
+  CHECK(fb.RUNS.value.table[10] == 42);
+
+  return (errors == 0)? 0 : 1;
+}
@@ -0,0 +1,37 @@
+/* Checks the C code generated for dead_code.st: the statements whose condition (or CASE
+ * selector) is known at compile time, and the REPEAT loops.
+ */
+
+#include <stdio.h>
+#include "POUS.h"
+#include "POUS.c"
+
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+static int errors = 0;
+
+#define CHECK(cond)\
+  if (!(cond)) {printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); errors++;}
+
+int main(void) {
+  DEAD_FB fb;
+
+  DEAD_FB_init__(&fb, 0);
+  fb.N.value = 2;
+  DEAD_FB_body__(&fb);
+  CHECK(fb.OUT_IF.value    == 2);
+  CHECK(fb.OUT_CASE.value  == 2);  /* the first matching case element only */
+  CHECK(fb.OUT_RANGE.value == 2);
+  CHECK(fb.OUT_ELSE.value  == 2);
+  CHECK(fb.OUT_NONE.value  == 0);
+  CHECK(fb.COUNT.value     == 2);
+  CHECK(fb.TOTAL.value     == 2 + 30);
+
+  fb.N.value = -1;
+  DEAD_FB_body__(&fb);
+  CHECK(fb.COUNT.value     == 1);
+  CHECK(fb.TOTAL.value     == 1 + 30);
+
+  return (errors == 0)? 0 : 1;
+}
@@ -0,0 +1,52 @@
+/* Checks the C code generated for en_eno.st: the lean variants of the FUNCTIONs that do not
+ * use EN and ENO (see generate_c_en_eno.cc).
+ */
+
+#include <stdio.h>
+#include "POUS.h"
+#include "POUS.c"
+
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+static int errors = 0;
+
+#define CHECK(cond)\
+  if (!(cond)) {printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); errors++;}
+
+int main(void) {
+  EN_ENO_FB fb;
+
+  /* the lean variant of TWICE exists, and CHECKED has none (it uses ENO) */
+  CHECK(TWICE_lean__(21) == 42);
+
+  EN_ENO_FB_init__(&fb, 0);
+  fb.IN.value = 5;
+  fb.ENABLE.value = 1;
+  EN_ENO_FB_body__(&fb);
+  CHECK(fb.OUT_LEAN.value    == 10);
+  CHECK(fb.OUT_EN.value      == 10);
+  CHECK(fb.ENO_TWICE.value   == 1);
+  CHECK(fb.OUT_CHECKED.value == 6);
+  CHECK(fb.ENO_CHECKED.value == 1);
+  CHECK(fb.COUNTER.COUNT.value == 1);
+
+  /* a call with EN := FALSE does not execute the function, and sets ENO to FALSE */
+  fb.IN.value = -3;
+  fb.ENABLE.value = 0;
+  EN_ENO_FB_body__(&fb);
+  CHECK(fb.OUT_LEAN.value    == -6);
+  CHECK(fb.ENO_TWICE.value   == 0);
+  CHECK(fb.OUT_CHECKED.value == -2);
+  CHECK(fb.ENO_CHECKED.value == 0);
+  CHECK(fb.COUNTER.COUNT.value == 2);
+
+  /* FB instances still test their EN, which may be forced by the debugger */
+  fb.COUNTER.EN.value  = 0;
+  fb.COUNTER.EN.flags |= __IEC_FORCE_FLAG;
+  EN_ENO_FB_body__(&fb);
+  CHECK(fb.COUNTER.COUNT.value == 2);
+  CHECK(fb.COUNTER.ENO.value   == 0);
+
+  return (errors == 0)? 0 : 1;
+}
@@ -0,0 +1,39 @@
+/* Checks the C code generated for for_loop.st: nested FOR loops, whose end and BY values
+ * are only known at runtime (see generate_c_st_c::visit(for_statement_c *)).
+ */
+
+#include <stdio.h>
+#include "POUS.h"
+#include "POUS.c"
+
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+static int errors = 0;
+
+#define CHECK(cond)\
+  if (!(cond)) {printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); errors++;}
+
+int main(void) {
+  FOR_FB fb;
+
+  FOR_FB_init__(&fb, 0);
+  fb.ROWS.value   = 3;
+  fb.COLS.value   = 2;
+  fb.BY_ROW.value = 1;
+  FOR_FB_body__(&fb);
+  CHECK(fb.COUNT.value == 3 * 2);
+  CHECK(fb.TOTAL.value == (1+2+3) * (1+2));
+
+  fb.ROWS.value   = 5;
+  fb.COLS.value   = 1;
+  fb.BY_ROW.value = 2;
+  FOR_FB_body__(&fb);
+  CHECK(fb.COUNT.value == 3);  /* i = 1, 3, 5 */
+
+  fb.BY_ROW.value = -1;
+  FOR_FB_body__(&fb);
+  CHECK(fb.COUNT.value == 0);
+
+  return (errors == 0)? 0 : 1;
+}
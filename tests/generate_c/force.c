@@ -0,0 +1,35 @@
+/* Checks the C code generated for force.st: forcing the variables of a FB changes the
+ * branches taken in the body of the FB (see constant_propagation_c::is_tracked_variable()).
+ */
+
+#include <stdio.h>
+#include "POUS.h"
+#include "POUS.c"
+
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+static int errors = 0;
+
+#define CHECK(cond)\
+  if (!(cond)) {printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); errors++;}
+
+int main(void) {
+  FORCE_FB fb;
+
+  FORCE_FB_init__(&fb, 0);
+  FORCE_FB_body__(&fb);
+  CHECK(fb.OUT1.value == 1);
+  CHECK(fb.OUT2.value == 1);
+
+  /* the assignments to forced variables (including the VAR_TEMP ones) are ignored */
+  fb.MODE.value  = 4;
+  fb.MODE.flags |= __IEC_FORCE_FLAG;
+  fb.PHASE.value  = 6;
+  fb.PHASE.flags |= __IEC_FORCE_FLAG;
+  FORCE_FB_body__(&fb);
+  CHECK(fb.OUT1.value == 2);
+  CHECK(fb.OUT2.value == 2);
+
+  return (errors == 0)? 0 : 1;
+}
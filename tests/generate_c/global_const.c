@@ -0,0 +1,40 @@
+/* Checks the C code generated for global_const.st. The configuration and resource are compiled
+ * together with the POUs (resource1.c includes POUS.c), so the POUs find the const C objects
+ * of the VAR_GLOBAL CONSTANT variables defined in config.c and resource1.c.
+ */
+
+#include <stdio.h>
+#include "config.c"
+#include "resource1.c"
+
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+static int errors = 0;
+
+#define CHECK(cond)\
+  if (!(cond)) {printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); errors++;}
+
+int main(void) {
+  int i;
+
+  /* the const C objects of the VAR_GLOBAL CONSTANT variables */
+  CHECK(__CONST_CONFIG__MAX_COUNT      == 3);
+  CHECK(__CONST_CONFIG__LIMITS.HIGH    == 10);
+  CHECK(__CONST_CONFIG__TABLE.table[3] == 4);
+  CHECK(__CONST_RESOURCE1__GAIN        == 2.5);
+
+  config_init__();
+  for (i = 0; i < 5; i++)
+    config_run__(i);
+
+  CHECK(RESOURCE1__PRG1.FB1.OUT.value    == 10);
+  CHECK(RESOURCE1__PRG1.FB1.SCALED.value == 25.0);
+  CHECK(RESOURCE1__PRG1.FB1.ENTRY.value  == 3);
+  CHECK(RESOURCE1__PRG1.SUM.value        == 33);
+  CHECK(RESOURCE1__PRG1.NEXT.value       == 4);
+  /* the non CONSTANT global variable is still accessed through the pointer of the VAR_EXTERNAL */
+  CHECK(*__GET_GLOBAL_COUNTER()          == 3);
+
+  return (errors == 0)? 0 : 1;
+}
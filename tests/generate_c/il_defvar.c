@@ -0,0 +1,48 @@
+/* Checks the C code generated for il_defvar.st: the IL implicit variable is declared as one
+ * C variable per datatype (and no longer as the __IL_DEFVAR_T union), and the IL code still
+ * computes the right results.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "POUS.h"
+#include "POUS.c"
+
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+static int errors = 0;
+
+#define CHECK(cond)\
+  if (!(cond)) {printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); errors++;}
+
+/* the contents of the generated POUS.c file */
+static const char *pous_c(void) {
+  static char buffer[1 << 16];
+  FILE *file = fopen("POUS.c", "r");
+  size_t size = 0;
+  if (NULL != file) {size = fread(buffer, 1, sizeof(buffer) - 1, file); fclose(file);}
+  buffer[size] = '\0';
+  return buffer;
+}
+
+int main(void) {
+  IL_PRG prg;
+
+  CHECK(NULL == strstr(pous_c(), "__IL_DEFVAR_T"));
+  CHECK(NULL != strstr(pous_c(), "BOOL __IL_DEFVAR_BOOL;"));
+  CHECK(NULL != strstr(pous_c(), "INT __IL_DEFVAR_INT;"));
+  CHECK(NULL != strstr(pous_c(), "REAL __IL_DEFVAR_REAL;"));
+  CHECK(NULL != strstr(pous_c(), "INT __IL_DEFVAR_BACK_INT;"));  /* MUL (b ... ) */
+  CHECK(NULL == strstr(pous_c(), "BOOL __IL_DEFVAR_BACK_BOOL;")); /* only the datatypes that are used */
+
+  IL_PRG_init__(&prg, 0);
+  IL_PRG_body__(&prg);
+  CHECK(prg.FB.SUM.value  == 11);
+  CHECK(prg.FB.PROD.value == 3 * (8 + 1));
+  CHECK(prg.FB.BIG.value  == 1);
+  CHECK(prg.FB.HALF.value == 2.5);
+  CHECK(prg.R.value       == 42);
+
+  return (errors == 0)? 0 : 1;
+}
@@ -0,0 +1,38 @@
+/* Checks the C code generated for init_external.st. The configuration and resource are compiled
+ * together with the POUs (resource1.c includes POUS.c).
+ */
+
+#include <stdio.h>
+#include "config.c"
+#include "resource1.c"
+
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+/* the location of the located global variable 'sensor' (%IW0) */
+static INT iw0 = 42;
+INT *__IW0 = &iw0;
+
+static int errors = 0;
+
+#define CHECK(cond)\
+  if (!(cond)) {printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); errors++;}
+
+int main(void) {
+  config_init__();
+
+  /* initialised before the located global variable */
+  CHECK(CONFIG__FBG.SENSOR.value == NULL);
+  /* initialised after it, using the image built for 'fbg' */
+  CHECK(RESOURCE1__PRG1.FB1.SENSOR.value       == __IW0);
+  CHECK(RESOURCE1__PRG1.FB2.INNER.SENSOR.value == __IW0);
+
+  /* the configuration initialised the located global variable to its default value */
+  CHECK(iw0 == 0);
+  iw0 = 42;
+  config_run__(0);
+  CHECK(RESOURCE1__PRG1.DIRECT.value == 42);
+  CHECK(RESOURCE1__PRG1.NESTED.value == 42);
+
+  return (errors == 0)? 0 : 1;
+}
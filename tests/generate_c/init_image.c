@@ -0,0 +1,63 @@
+/* Checks the C code generated for init_image.st: the initialisation of FB instances
+ * from the pre-initialised image of the FB (see generate_c_pous_c::handle_function_block()).
+ */
+
+#include <stdio.h>
+#include "POUS.h"
+#include "POUS.c"
+
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+static int errors = 0;
+
+#define CHECK(cond)\
+  if (!(cond)) {printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); errors++;}
+
+static void check_initial_values(INIT_FB *fb) {
+  CHECK(fb->IN.value       == 5);
+  CHECK(fb->COUNT.value    == 3);
+  CHECK(fb->PERIOD.value.tv_sec == 2);
+  CHECK(fb->TABLE.value.table[0] == 1);
+  CHECK(fb->TABLE.value.table[3] == 4);
+  CHECK(fb->TOTAL.value    == 10);
+  CHECK(fb->TIMER.Q.value  == 0);
+}
+
+int main(void) {
+  INIT_FB fb1, fb2, fb3;
+
+  /* without retain, only the variables declared RETAIN have the retain flag set */
+  memset(&fb1, 0xFF, sizeof(fb1));
+  INIT_FB_init__(&fb1, 0);
+  check_initial_values(&fb1);
+  CHECK(fb1.COUNT.flags   == 0);
+  CHECK(fb1.TOTAL.flags   == __IEC_RETAIN_FLAG);
+  CHECK(fb1.TIMER.PT.flags == 0);
+
+  /* with retain, all the variables (including those of the nested FBs) */
+  INIT_FB_init__(&fb2, 1);
+  check_initial_values(&fb2);
+  CHECK(fb2.COUNT.flags   == __IEC_RETAIN_FLAG);
+  CHECK(fb2.TOTAL.flags   == __IEC_RETAIN_FLAG);
+  CHECK(fb2.TIMER.PT.flags == __IEC_RETAIN_FLAG);
+
+  /* the image is not changed by initialising an instance with retain */
+  INIT_FB_init__(&fb3, 0);
+  check_initial_values(&fb3);
+  CHECK(fb3.COUNT.flags   == 0);
+  CHECK(fb3.TIMER.PT.flags == 0);
+
+  /* initialising an instance again restores the initial values, and resets all the flags
+   * (including the force flags) to their initial value.
+   */
+  fb1.COUNT.value  = 99;
+  fb1.COUNT.flags |= __IEC_FORCE_FLAG;
+  fb1.TIMER.PT.flags |= __IEC_FORCE_FLAG;
+  INIT_FB_init__(&fb1, 0);
+  check_initial_values(&fb1);
+  CHECK(fb1.COUNT.flags    == 0);
+  CHECK(fb1.TIMER.PT.flags == 0);
+
+  return (errors == 0)? 0 : 1;
+}
@@ -0,0 +1,58 @@
+/* Checks the C code generated for inline.st: which FUNCTIONs are generated as 'static inline'
+ * C functions in POUS.h, and that all of them still compute the right result.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "POUS.h"
+#include "POUS.c"
+
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+static int errors = 0;
+
+#define CHECK(cond)\
+  if (!(cond)) {printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); errors++;}
+
+/* the contents of a generated file */
+static char *contents(const char *filename) {
+  static char buffer[1 << 16];
+  FILE *file = fopen(filename, "r");
+  size_t size = 0;
+  if (NULL != file) {size = fread(buffer, 1, sizeof(buffer) - 1, file); fclose(file);}
+  buffer[size] = '\0';
+  return buffer;
+}
+
+static int is_inline(const char *name) {
+  char declaration[128];
+  snprintf(declaration, sizeof(declaration), "static inline INT %s(", name);
+  return (NULL != strstr(contents("POUS.h"), declaration));
+}
+
+static int is_defined_in_pous_c(const char *name) {
+  char definition[128];
+  snprintf(definition, sizeof(definition), "\nINT %s(", name);
+  return (NULL != strstr(contents("POUS.c"), definition));
+}
+
+int main(void) {
+  INLINE_PRG prg;
+
+  CHECK( is_inline("LEAF_FN")   && !is_defined_in_pous_c("LEAF_FN"));    /* small leaf FUNCTION */
+  CHECK(!is_inline("CALLER_FN") &&  is_defined_in_pous_c("CALLER_FN"));  /* calls another FUNCTION */
+  CHECK(!is_inline("BIG_FN")    &&  is_defined_in_pous_c("BIG_FN"));     /* too large */
+  CHECK(!is_inline("NEVER_FN")  &&  is_defined_in_pous_c("NEVER_FN"));   /* {noinline} */
+  CHECK( is_inline("ALWAYS_FN") && !is_defined_in_pous_c("ALWAYS_FN"));  /* {inline}, although it calls another FUNCTION */
+
+  INLINE_PRG_init__(&prg, 0);
+  INLINE_PRG_body__(&prg);
+  CHECK(prg.A.value == 20);
+  CHECK(prg.B.value == 21);
+  CHECK(prg.C.value == 27);
+  CHECK(prg.D.value == 13);
+  CHECK(prg.E.value == 25);
+
+  return (errors == 0)? 0 : 1;
+}
@@ -0,0 +1,77 @@
+/* Checks the C code generated for overload.st: each call to an overloaded standard function
+ * resolves to the declaration matching the datatypes of its parameters, also when the overload
+ * resolution of an earlier call with the same signature was re-used, and computes the right result.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "POUS.h"
+#include "POUS.c"
+
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+static int errors = 0;
+
+#define CHECK(cond)\
+  if (!(cond)) {printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); errors++;}
+
+/* the contents of a generated file */
+static char *contents(const char *filename) {
+  static char buffer[1 << 16];
+  FILE *file = fopen(filename, "r");
+  size_t size = 0;
+  if (NULL != file) {size = fread(buffer, 1, sizeof(buffer) - 1, file); fclose(file);}
+  buffer[size] = '\0';
+  return buffer;
+}
+
+/* the number of calls to a function in POUS.c */
+static int calls(const char *name) {
+  char call[128];
+  int count = 0;
+  char *found = contents("POUS.c");
+  snprintf(call, sizeof(call), "%s(", name);
+  while (NULL != (found = strstr(found, call))) {count++; found++;}
+  return count;
+}
+
+/* the value of a counter printed by iec2c --stats (-1 if not found) */
+static long stats_counter(const char *name) {
+  char *found = strstr(contents("iec2c.log"), name);
+  if (NULL == found) return -1;
+  found = strchr(found, ':');
+  return (NULL == found)? -1 : atol(found + 1);
+}
+
+int main(void) {
+  OVERLOAD_PRG prg;
+
+  CHECK(calls("MAX__INT__INT")                 == 4);
+  CHECK(calls("MAX__REAL__REAL")               == 3);
+  CHECK(calls("MAX__DINT__DINT")               == 1);
+  CHECK(calls("SEL__INT__BOOL__INT__INT")      == 2);
+  CHECK(calls("SEL__REAL__BOOL__REAL__REAL")   == 1);
+  CHECK(calls("LIMIT__INT__INT__INT__INT")     == 2);
+  CHECK(calls("LIMIT__REAL__REAL__REAL__REAL") == 1);
+  CHECK(stats_counter("overload_cache_hits") > 0);
+
+  OVERLOAD_PRG_init__(&prg, 0);
+  OVERLOAD_PRG_body__(&prg);
+  CHECK(prg.FB1.MAX_I.value == 12);
+  CHECK(prg.FB1.MAX_R.value == 5.0);
+  CHECK(prg.FB1.SEL_I.value == 12);
+  CHECK(prg.FB1.SEL_R.value == 5.0);
+  CHECK(prg.FB1.LIM_I.value == 10);
+  CHECK(prg.FB1.LIM_R.value == 2.5);
+  CHECK(prg.FB2.MAX_I.value == 5);
+  CHECK(prg.FB2.MAX_R.value == 7.5);
+  CHECK(prg.FB2.SEL_I.value == -3);
+  CHECK(prg.FB2.LIM_I.value == 0);
+  CHECK(prg.I.value == 12);
+  CHECK(prg.R.value == 7.5);
+  CHECK(prg.D.value == 100000);
+
+  return (errors == 0)? 0 : 1;
+}
@@ -0,0 +1,56 @@
+/* Checks the C code generated for pou_order.st: the POUs are declared in POUS.h in dependency
+ * order (each POU after the POUs it references, the others in source order), and still compute
+ * the right result.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "POUS.h"
+#include "POUS.c"
+
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+static int errors = 0;
+
+#define CHECK(cond)\
+  if (!(cond)) {printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); errors++;}
+
+/* the contents of a generated file */
+static char *contents(const char *filename) {
+  static char buffer[1 << 16];
+  FILE *file = fopen(filename, "r");
+  size_t size = 0;
+  if (NULL != file) {size = fread(buffer, 1, sizeof(buffer) - 1, file); fclose(file);}
+  buffer[size] = '\0';
+  return buffer;
+}
+
+/* the position in POUS.h of the first declaration of a POU (-1 if not found) */
+static long position(const char *declaration) {
+  char *pous_h = contents("POUS.h");
+  char *found  = strstr(pous_h, declaration);
+  return (NULL == found)? -1 : found - pous_h;
+}
+
+int main(void) {
+  POU_ORDER_PRG prg;
+  long other_fn = position("INT OTHER_FN(");
+  long leaf_fn  = position("INT LEAF_FN(");
+  long mid_fb   = position("} MID_FB;");
+  long top_fb   = position("} TOP_FB;");
+  long prg_type = position("} POU_ORDER_PRG;");
+
+  CHECK(other_fn >= 0 && leaf_fn >= 0 && mid_fb >= 0 && top_fb >= 0 && prg_type >= 0);
+  CHECK(other_fn < leaf_fn);   /* independent of each other: source order is kept */
+  CHECK(leaf_fn  < mid_fb);    /* mid_fb calls leaf_fn */
+  CHECK(mid_fb   < top_fb);    /* top_fb has a mid_fb instance */
+  CHECK(top_fb   < prg_type);  /* pou_order_prg has a top_fb instance, and calls other_fn */
+
+  POU_ORDER_PRG_init__(&prg, 0);
+  POU_ORDER_PRG_body__(&prg);
+  CHECK(prg.A.value == 90);
+  CHECK(prg.B.value == 3);
+
+  return (errors == 0)? 0 : 1;
+}
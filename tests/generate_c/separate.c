@@ -0,0 +1,36 @@
+/* Checks the C code generated for separate.st with -O s: the POUs are compiled as a
+ * separate translation unit (POUS.o), and only their declarations (POUS.h) are included here.
+ * The test is linked with the objects of the POUs, configuration and resource (all.o).
+ */
+
+#include <stdio.h>
+#include "POUS.h"
+
+TIME __CURRENT_TIME;
+BOOL __DEBUG;
+
+static int errors = 0;
+
+#define CHECK(cond)\
+  if (!(cond)) {printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); errors++;}
+
+int main(void) {
+  SEPARATE_FB fb;
+
+  CHECK(SCALE(1, NULL, 5) == 15);
+
+  SEPARATE_FB_init__(&fb, 0);
+  fb.IN.value = 2;
+  SEPARATE_FB_body__(&fb);
+  CHECK(fb.OUT.value   == 106);
+  CHECK(fb.OK.value    == 1);
+  CHECK(fb.POS.value.X == 3);
+  CHECK(fb.POS.value.Y == 2);
+  CHECK(fb.BIASED.value == 1002);
+
+  fb.IN.value = -1;
+  SEPARATE_FB_body__(&fb);
+  CHECK(fb.OK.value    == 0);
+
+  return (errors == 0)? 0 : 1;
+}
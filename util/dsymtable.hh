@@ -91,6 +91,9 @@ template<typename value_type> class dsymtable_c {
     /* returns: 0 if no entry is found, 1 if 1 entry is found, ..., n if n entries are found */
     int count(const char *identifier_str)    {return _base.count(identifier_str);}
     int count(const symbol_c *symbol)        {return count(symbol_to_string(symbol));}
+
+    /* Total number of entries */
+    int size(void)                           {return _base.size();}
     
     /* Search for an entry associated with identifier_str. Will return end() if not found */
     iterator find(const char *identifier_str)        {return _base.find(identifier_str);}
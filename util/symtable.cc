@@ -61,6 +61,12 @@ void symtable_c<value_type>::push(void) {
   }
 }
 
+  /* total number of entries, in all levels */
+template<typename value_type>
+int symtable_c<value_type>::size(void) {
+  return _base.size() + ((inner_scope == NULL)? 0 : inner_scope->size());
+}
+
   /* clear most inner scope */
   /* returns 1 if this is the inner most scope	*/
   /*         0 otherwise			*/
@@ -102,6 +102,9 @@ template<typename value_type> class symtable_c {
     int count(const       char *identifier_str);
     int count(const std::string identifier_str);
  // int count(const   symbol_c *identifier    ); // not yet implemented
+
+    /* Total number of entries, in all levels */
+    int size(void);
     
     /* Search for an entry. Will return end() if not found */
     iterator               begin(void);